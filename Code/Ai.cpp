@@ -1,53 +1,80 @@
 /// \file ai.cpp
 /// \brief Code for the intelligent object class CIntelligentObject.
 
-#include "ai.h"
+#include "Ai.h"
 #include "debug.h"
 #include "ObjMan.h"
 #include "EnemyOne.h"
 #include "Timer.h"
 #include "Random.h"
+#include "Snapshot.h"
+#include "World.h"
 
-extern CObjectManager g_cObjectManager; //object manager
-extern CTimer g_cTimer;
-extern CRandom g_cRandom;
 extern int g_nScreenWidth;
 
 /// Constructor for intelligent object.
+/// \param world World that the object is in.
 /// \param object Object type.
 /// \param name Object name string.
 /// \param location Vector location in world space.
 /// \param velocity Velocity vector.
 
-CIntelligentObject::CIntelligentObject(ObjectType object, const char* name,
+CIntelligentObject::CIntelligentObject(CWorld* world, ObjectType object, const char* name,
   const Vector3& location, const Vector3& velocity):
-CGameObject(object, name, location, velocity){ //constructor
-  m_bIntelligent = TRUE;
-  m_fDistance = m_fXDistance = m_fYDistance = 0.0f;
-  m_vPlaneLoc.x = m_vPlaneLoc.y = 0.0f;
+CGameObject(world, object, name, location, velocity){ //constructor
+  SetFlag(INTELLIGENT_FLAG, TRUE);
+  distance() = xDistance() = yDistance() = 0.0f;
+  planeLoc().x = planeLoc().y = 0.0f;
+  schedule(THINK_EVENT, 0); //think on the next tick
 } //constructor
 
+/// Restore an intelligent object from a snapshot. Its think event is put
+/// back by the object manager with the others.
+/// \param world World that the object is in.
+/// \param object Object type.
+/// \param s Snapshot.
+
+CIntelligentObject::CIntelligentObject(CWorld* world, ObjectType object, CSnapshot& s):
+CGameObject(world, object, s){
+  SetFlag(INTELLIGENT_FLAG, TRUE);
+  s.read(planeLoc());
+  s.read(distance());
+  s.read(yDistance());
+  s.read(xDistance());
+} //constructor
+
+/// Save to a snapshot.
+/// \param s Snapshot.
+
+void CIntelligentObject::save(CSnapshot& s){
+  CGameObject::save(s);
+  s.write(planeLoc());
+  s.write(distance());
+  s.write(yDistance());
+  s.write(xDistance());
+} //save
+
 /// Compute the distance to the player. Intelligent objects need to make
 /// decisions based on how close the player is.
 
 void CIntelligentObject::think(){
   //look for player
-  CGameObject* pPlane = g_cObjectManager.GetPlayerObjectPtr();
-  m_vPlaneLoc = pPlane->m_vPos; //remember player location
+  CGameObject* pPlane = m_pWorld->m_cObjectManager.GetPlayerObjectPtr();
+  planeLoc() = pPlane->position(); //remember player location
 
   //Euclidean and axial distances from player
 
-  m_fYDistance = m_vPos.y - m_vPlaneLoc.y; //vertical distance
+  yDistance() = position().y - planeLoc().y; //vertical distance
 
   //horizontal distance
-  m_fXDistance = m_vPos.x - m_vPlaneLoc.x;
+  xDistance() = position().x - planeLoc().x;
   //wrap horizontal distance to half of world width in magnitude
   const int nWorldWidth = 2 * g_nScreenWidth; //should be at least 2 times screen width
-  if(m_fXDistance > nWorldWidth/2)
-    m_fXDistance -= nWorldWidth;
-  if(m_fXDistance < -nWorldWidth/2)
-    m_fXDistance += nWorldWidth;
+  if(xDistance() > nWorldWidth/2)
+    xDistance() -= nWorldWidth;
+  if(xDistance() < -nWorldWidth/2)
+    xDistance() += nWorldWidth;
 
   //Euclidean distance
-  m_fDistance = sqrt(m_fXDistance*m_fXDistance + m_fYDistance*m_fYDistance);
+  distance() = sqrt(xDistance()*xDistance() + yDistance()*yDistance());
 } //think
\ No newline at end of file
@@ -3,7 +3,7 @@
 
 #pragma once
 
-#include "object.h"
+#include "Object.h"
 
 /// \brief The intelligent object class.
 ///
@@ -14,13 +14,16 @@
 class CIntelligentObject: public CGameObject{
 	friend class CEnemyOneObject;
   protected:
-    Vector3 m_vPlaneLoc; ///< Players location.
-    float m_fDistance; ///< Euclidean distance to player.
-    float m_fYDistance; ///< Vertical distance to player.
-    float m_fXDistance; ///< horizontal distance to player.
+    //AI component, kept in the object manager's entity store
+    Vector3& planeLoc(){return m_pChunk->m_pAi[m_nRow].m_vPlaneLoc;} ///< Player's location.
+    float& distance(){return m_pChunk->m_pAi[m_nRow].m_fDistance;} ///< Euclidean distance to player.
+    float& yDistance(){return m_pChunk->m_pAi[m_nRow].m_fYDistance;} ///< Vertical distance to player.
+    float& xDistance(){return m_pChunk->m_pAi[m_nRow].m_fXDistance;} ///< Horizontal distance to player.
 
   public:
-    CIntelligentObject(ObjectType object, const char* name, const Vector3& location,
+    CIntelligentObject(CWorld* world, ObjectType object, const char* name, const Vector3& location,
       const Vector3& velocity); ///< Constructor.
+    CIntelligentObject(CWorld* world, ObjectType object, CSnapshot& s); ///< Constructor from a snapshot.
     virtual void think(); ///< AI function.
+    virtual void save(CSnapshot& s); ///< Save to a snapshot.
 }; //CIntelligentObject
\ No newline at end of file
@@ -0,0 +1,55 @@
+/// \file AnimationStore.cpp
+/// \brief Code for the animation sequence store class CAnimationStore.
+
+#include "AnimationStore.h"
+
+/// Compare a sequence in the store with a list of frame numbers.
+/// \param s Span of the sequence in the store.
+/// \param frames Frame numbers.
+/// \return true if they are the same.
+
+bool CAnimationStore::equal(const ANIMATIONSPAN& s, const vector<int>& frames){
+  if((size_t)s.m_nCount != frames.size())return false;
+  for(size_t i=0; i<frames.size(); i++)
+    if(m_nFrames[s.m_nStart + i] != frames[i])
+      return false;
+  return true;
+} //equal
+
+/// Intern an animation sequence. There are only a few dozen sequences and this
+/// is only done while the settings are compiled, so a linear search is fine.
+/// \param frames Frame numbers.
+/// \return Span of the sequence in the store, with count 0 if it won't fit.
+
+ANIMATIONSPAN CAnimationStore::intern(const vector<int>& frames){
+  ANIMATIONSPAN s = {0, 0};
+  if(frames.empty() || frames.size() > 0xFFFF)return s;
+
+  for(size_t i=0; i<m_sSequence.size(); i++)
+    if(equal(m_sSequence[i], frames))
+      return m_sSequence[i];
+
+  if(m_nFrames.size() + frames.size() > 0xFFFF)return s; //store is full
+
+  s.m_nStart = (unsigned short)m_nFrames.size();
+  s.m_nCount = (unsigned short)frames.size();
+  m_nFrames.insert(m_nFrames.end(), frames.begin(), frames.end());
+  m_sSequence.push_back(s);
+  return s;
+} //intern
+
+/// Get a frame number from an animation sequence.
+/// \param s Span of the sequence in the store.
+/// \param i Index into the sequence, less than its count.
+/// \return Frame number.
+
+int CAnimationStore::frame(const ANIMATIONSPAN& s, int i){
+  return m_nFrames[s.m_nStart + i];
+} //frame
+
+/// Remove all sequences. Spans handed out before this are no longer valid.
+
+void CAnimationStore::clear(){
+  m_nFrames.clear();
+  m_sSequence.clear();
+} //clear
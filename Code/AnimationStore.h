@@ -0,0 +1,35 @@
+/// \file AnimationStore.h
+/// \brief Interface for the animation sequence store class CAnimationStore.
+
+#pragma once
+
+#include <vector>
+
+using namespace std;
+
+/// \brief Where an animation sequence is in the animation store.
+
+struct ANIMATIONSPAN{
+  unsigned short m_nStart; ///< Index of the first frame number in the store.
+  unsigned short m_nCount; ///< Number of frame numbers, 0 for no animation.
+}; //ANIMATIONSPAN
+
+/// \brief The animation sequence store.
+///
+/// Every animation sequence in the settings file is interned here once, when
+/// the settings are compiled, and identical sequences share storage. After
+/// that the store is read only. A game object holds a span into the store,
+/// so creating and deleting objects never allocates or frees a sequence.
+
+class CAnimationStore{
+  private:
+    vector<int> m_nFrames; ///< Frame numbers of every sequence, one after the other.
+    vector<ANIMATIONSPAN> m_sSequence; ///< Every distinct sequence interned so far.
+
+    bool equal(const ANIMATIONSPAN& s, const vector<int>& frames); ///< Compare a sequence with frame numbers.
+
+  public:
+    ANIMATIONSPAN intern(const vector<int>& frames); ///< Add a sequence, or find an identical one.
+    int frame(const ANIMATIONSPAN& s, int i); ///< Get a frame number from a sequence.
+    void clear(); ///< Remove all sequences.
+}; //CAnimationStore
@@ -0,0 +1,86 @@
+/// \file CollisionMatrix.cpp
+/// \brief Code for the collision matrix class CCollisionMatrix.
+
+#include "CollisionMatrix.h"
+#include "ObjectTraits.h"
+
+CCollisionMatrix::CCollisionMatrix(){
+  for(int i=0; i<NUM_OBJECT_TYPES; i++){
+    m_nLayer[i] = ComputeLayer((ObjectType)i);
+    m_nMask[i] = ComputeMask(m_nLayer[i]);
+  } //for
+
+  for(int i=0; i<NUM_OBJECT_TYPES; i++)
+    for(int j=0; j<NUM_OBJECT_TYPES; j++)
+      m_nResponse[i][j] = (unsigned char)(CanCollide((ObjectType)i, (ObjectType)j)?
+        ComputeResponse((ObjectType)i, (ObjectType)j): NO_RESPONSE);
+} //constructor
+
+/// Work out which layer an object type is on from its traits.
+/// \param t Object type.
+/// \return Layer bit, 0 if it is on no layer.
+
+unsigned CCollisionMatrix::ComputeLayer(ObjectType t){
+  if(HasTrait(t, ACTIVEPLAYER_TRAIT))
+    return PLAYER_LAYER;
+  if(HasTrait(t, PLAYERSHOT_TRAIT | PIERCESHOT_TRAIT))
+    return SHOT_LAYER;
+  if(HasTrait(t, HARMFUL_TRAIT | SHOOTABLE_TRAIT | PIERCEABLE_TRAIT | SPIKED_TRAIT))
+    return ENEMY_LAYER;
+  if(t == ITEMHEART_OBJECT || HasTrait(t, SHIELDITEM_TRAIT | ASSISTITEM_TRAIT | PIERCEITEM_TRAIT))
+    return ITEM_LAYER;
+  return 0;
+} //ComputeLayer
+
+/// Work out which layers the objects on a layer can run into.
+/// \param layer Layer bit.
+/// \return Mask of layer bits.
+
+unsigned CCollisionMatrix::ComputeMask(unsigned layer){
+  switch(layer){
+    case PLAYER_LAYER: return ENEMY_LAYER | ITEM_LAYER;
+    case SHOT_LAYER: return ENEMY_LAYER;
+    default: return 0;
+  } //switch
+} //ComputeMask
+
+/// Work out what happens when an object runs into another. The tests are in
+/// order of priority, the first one that matches wins.
+/// \param hitter Type of the object doing the hitting.
+/// \param hit Type of the object being hit.
+/// \return Collision response.
+
+CollisionResponseType CCollisionMatrix::ComputeResponse(ObjectType hitter, ObjectType hit){
+  if(HasTrait(hitter, ACTIVEPLAYER_TRAIT) && HasTrait(hit, HARMFUL_TRAIT))
+    return PLAYERHIT_RESPONSE;
+  if(HasTrait(hitter, PLAYERSHOT_TRAIT) && HasTrait(hit, SPIKED_TRAIT))
+    return SPIKED_RESPONSE;
+  if(HasTrait(hitter, PIERCESHOT_TRAIT) && HasTrait(hit, PIERCEABLE_TRAIT))
+    return PIERCE_RESPONSE;
+  if(HasTrait(hitter, PLAYERSHOT_TRAIT) && HasTrait(hit, SHOOTABLE_TRAIT))
+    return SHOT_RESPONSE;
+  if(HasTrait(hitter, ACTIVEPLAYER_TRAIT) && hit == ITEMHEART_OBJECT)
+    return HEART_RESPONSE;
+  if(HasTrait(hitter, ACTIVEPLAYER_TRAIT) && HasTrait(hit, SHIELDITEM_TRAIT | ASSISTITEM_TRAIT | PIERCEITEM_TRAIT))
+    return LETTER_RESPONSE;
+  return NO_RESPONSE;
+} //ComputeResponse
+
+/// Check whether the layer of one type is in the mask of another.
+/// \param hitter Type of the object doing the hitting.
+/// \param hit Type of the object being hit.
+/// \return TRUE if they can collide.
+
+BOOL CCollisionMatrix::CanCollide(ObjectType hitter, ObjectType hit){
+  return (m_nMask[hitter] & m_nLayer[hit]) != 0;
+} //CanCollide
+
+/// Get the response for a pair of object types.
+/// \param hitter Type of the object doing the hitting.
+/// \param hit Type of the object being hit.
+/// \return Collision response, NO_RESPONSE if they can't collide.
+
+CollisionResponseType CCollisionMatrix::GetResponse(ObjectType hitter, ObjectType hit){
+  if(!CanCollide(hitter, hit))return NO_RESPONSE;
+  return (CollisionResponseType)m_nResponse[hitter][hit];
+} //GetResponse
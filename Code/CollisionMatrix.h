@@ -0,0 +1,41 @@
+/// \file CollisionMatrix.h
+/// \brief Interface for the collision matrix class CCollisionMatrix.
+
+#pragma once
+
+#include "Defines.h"
+
+/// \brief Collision layers.
+///
+/// Each object type is on at most one layer. Types that are on no layer
+/// never collide with anything.
+
+const unsigned PLAYER_LAYER = 1 << 0; ///< The player.
+const unsigned SHOT_LAYER   = 1 << 1; ///< The player's letter and piercing shots.
+const unsigned ENEMY_LAYER  = 1 << 2; ///< Enemies and enemy shots.
+const unsigned ITEM_LAYER   = 1 << 3; ///< Items that the player can pick up.
+
+/// \brief The collision matrix.
+///
+/// Decides what happens when an object of one type runs into an object of
+/// another. Each type has a layer and a mask of the layers it collides with,
+/// so pairs that can't interact are rejected with one AND before anything
+/// else is looked at. The response for the pairs that can is precomputed
+/// for every pair of types in the constructor.
+
+class CCollisionMatrix{
+  private:
+    unsigned m_nLayer[NUM_OBJECT_TYPES]; ///< Layer of each type.
+    unsigned m_nMask[NUM_OBJECT_TYPES]; ///< Layers that each type collides with.
+    unsigned char m_nResponse[NUM_OBJECT_TYPES][NUM_OBJECT_TYPES]; ///< Response for each pair of types.
+
+    static unsigned ComputeLayer(ObjectType t); ///< Work out the layer of a type.
+    static unsigned ComputeMask(unsigned layer); ///< Work out what a layer collides with.
+    static CollisionResponseType ComputeResponse(ObjectType hitter, ObjectType hit); ///< Work out a response.
+
+  public:
+    CCollisionMatrix(); ///< Constructor.
+
+    BOOL CanCollide(ObjectType hitter, ObjectType hit); ///< Check the layer masks.
+    CollisionResponseType GetResponse(ObjectType hitter, ObjectType hit); ///< Get the response for a pair.
+}; //CCollisionMatrix
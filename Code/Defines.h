@@ -3,11 +3,16 @@
 
 #pragma once
 
-#include <d3d11_2.h>
-#include <dxgi1_3.h>
-#include <DirectXMath.h>
+#ifdef HEADLESS
+  #include "Headless.h" //stand-ins for Windows and DirectX
+#else
+  #include <d3d11_2.h>
+  #include <dxgi1_3.h>
+  #include <DirectXMath.h>
+
+  #include "SimpleMath.h"
+#endif //HEADLESS
 
-#include "SimpleMath.h"
 #include "tinyxml2.h"
 
 using namespace DirectX;
@@ -62,6 +67,40 @@ enum EnemyStateType {
 	MOVING_STATE, ATTACKING_STATE
 };
 
+/// Directions that the player can be moved in with the arrow keys.
+
+enum DirectionType{
+  UP_DIRECTION, DOWN_DIRECTION, LEFT_DIRECTION, RIGHT_DIRECTION
+};
+
+/// Incarnation transition conditions.
+/// When an object dies, the first transition for its type whose condition
+/// holds decides what it turns into next.
+
+enum TransitionType{
+  ALWAYS_TRANSITION, ///< Always.
+  DIEDOFDMG_TRANSITION, ///< The player has run out of lives.
+  PLAYERHIT_TRANSITION, ///< The player was hit.
+  DIEDOFAGE_TRANSITION, ///< Something died of old age.
+  DIEDOFSPECIAL_TRANSITION, ///< Killed by the player's special attack.
+  HEALTHY_TRANSITION ///< Died of age with some health left.
+}; //TransitionType
+
+/// Collision responses.
+/// What happens when one object runs into another. Which one applies to a
+/// pair of object types is looked up in the collision matrix.
+
+enum CollisionResponseType{
+  NO_RESPONSE, ///< The objects pass through each other.
+  PLAYERHIT_RESPONSE, ///< The player runs into something harmful.
+  SPIKED_RESPONSE, ///< A letter shot bounces off something spiked.
+  PIERCE_RESPONSE, ///< A piercing shot goes through an enemy.
+  SHOT_RESPONSE, ///< A letter shot hits an enemy.
+  HEART_RESPONSE, ///< The player picks up a heart.
+  LETTER_RESPONSE, ///< The player picks up a letter item.
+  NUM_COLLISION_RESPONSES ///< Must be last.
+}; //CollisionResponseType
+
 /// Game object types.
 /// Types of game object that can appear in the game. Note: NUM_OBJECT_TYPES 
 /// must be last.
@@ -111,6 +150,27 @@ enum ObjectType{
   NUM_OBJECT_TYPES //MUST be the last one
 }; //ObjectType
 
+/// Timer event types.
+/// Things that happen to a game object at a time it has asked for, rather
+/// than being checked every frame. Each object can have one of each pending.
+
+enum TimerEventType{
+  THINK_EVENT, ///< Intelligent object runs its AI.
+  FRAME_EVENT, ///< Advance to the next animation frame.
+  FLY_EVENT, ///< Hurt enemy tumbles away a step.
+  EXPIRE_EVENT, ///< Life time is over.
+  NUM_TIMER_EVENTS ///< Number of timer event types, must be last.
+}; //TimerEventType
+
+/// Time source types.
+/// Where the timer gets the time from. A virtual clock only moves when it is
+/// told to, so a simulation can run as fast as the CPU allows.
+
+enum TimeSourceType{
+  REAL_TIMESOURCE, ///< The system's millisecond clock.
+  VIRTUAL_TIMESOURCE ///< A clock advanced by hand.
+}; //TimeSourceType
+
 /// Shader type for pixel shaders.
 
 enum ShaderType {
@@ -0,0 +1,83 @@
+/// \file DepthLayers.cpp
+/// \brief Code for the layered draw order class CDepthLayers.
+
+#include <math.h>
+#include <algorithm>
+
+#include "DepthLayers.h"
+#include "Object.h"
+
+const float DEPTH_LAYER_SCALE = 4.0f; ///< Number of layers per unit of Z.
+
+/// Quantize a Z coordinate to a layer key. Objects whose Z values are closer
+/// together than 1/DEPTH_LAYER_SCALE may share a layer.
+/// \param z Z coordinate.
+/// \return Layer key, larger keys are farther away.
+
+int CDepthLayers::LayerKey(float z){
+  return (int)floorf(z*DEPTH_LAYER_SCALE + 0.5f);
+} //LayerKey
+
+/// Append an object to the end of the layer for its current Z, and remember
+/// which layer that was.
+/// \param p Pointer to object.
+
+void CDepthLayers::place(CGameObject* p){
+  p->m_pCold->m_nDepthKey = LayerKey(p->position().z);
+  m_stlLayer[p->m_pCold->m_nDepthKey].push_back(p);
+} //place
+
+/// Add an object that has just entered the object list.
+/// \param p Pointer to object.
+
+void CDepthLayers::insert(CGameObject* p){
+  place(p);
+} //insert
+
+/// Move an object to the end of the layer for its current Z, if that is not
+/// the layer it is in. Objects that are not in a layer yet are left alone,
+/// they are put in the right one when they enter the object list.
+/// \param p Pointer to object.
+
+void CDepthLayers::move(CGameObject* p){
+  if(LayerKey(p->position().z) == p->m_pCold->m_nDepthKey)return;
+  auto i = m_stlLayer.find(p->m_pCold->m_nDepthKey);
+  if(i == m_stlLayer.end())return;
+
+  vector<CGameObject*>& layer = i->second;
+  auto j = find(layer.begin(), layer.end(), p);
+  if(j == layer.end())return; //not in the object list yet
+
+  layer.erase(j);
+  place(p);
+} //move
+
+/// Remove dead objects from every layer, keeping the order of the rest.
+/// This must be called before the dead objects are deleted.
+
+void CDepthLayers::prune(){
+  for(auto i=m_stlLayer.begin(); i!=m_stlLayer.end(); i++){
+    vector<CGameObject*>& layer = i->second;
+    size_t n = 0; //number kept so far
+    for(size_t k=0; k<layer.size(); k++)
+      if(!layer[k]->GetFlag(DEAD_FLAG))
+        layer[n++] = layer[k];
+    layer.resize(n);
+  } //for
+} //prune
+
+void CDepthLayers::clear(){
+  m_stlLayer.clear();
+} //clear
+
+/// Draw all objects from back to front. Within a layer the newest object is
+/// drawn first, as it was when the object list was sorted by Z, since new
+/// objects go at the front of that list.
+
+void CDepthLayers::draw(){
+  for(auto i=m_stlLayer.begin(); i!=m_stlLayer.end(); i++){
+    vector<CGameObject*>& layer = i->second;
+    for(size_t k=layer.size(); k>0; k--)
+      layer[k - 1]->draw();
+  } //for
+} //draw
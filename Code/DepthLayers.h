@@ -0,0 +1,36 @@
+/// \file DepthLayers.h
+/// \brief Interface for the layered draw order class CDepthLayers.
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <functional>
+
+using namespace std;
+
+class CGameObject;
+
+/// \brief Game objects bucketed by depth.
+///
+/// Almost every object sits on one of a few fixed Z planes, so instead of
+/// sorting all objects by Z every frame, each object is put into the layer for
+/// its quantized Z when it enters the game. Layers are kept farthest first,
+/// and objects stay in insertion order within a layer. Z only changes when an
+/// object turns into its next incarnation, and the object manager moves it to
+/// its new layer then, so drawing back to front is a linear walk.
+
+class CDepthLayers{
+  private:
+    map<int, vector<CGameObject*>, greater<int>> m_stlLayer; ///< Objects in each layer, farthest layer first.
+
+    int LayerKey(float z); ///< Quantize a Z coordinate.
+    void place(CGameObject* p); ///< Append an object to the layer for its Z.
+
+  public:
+    void insert(CGameObject* p); ///< Add an object.
+    void move(CGameObject* p); ///< Move an object to the layer for its new Z.
+    void prune(); ///< Remove dead objects.
+    void clear(); ///< Remove all objects.
+    void draw(); ///< Draw all objects back to front.
+}; //CDepthLayers
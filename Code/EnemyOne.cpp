@@ -4,59 +4,83 @@
 #include <string>
 #include <unordered_map>
 
-#include "enemyOne.h"
-#include "timer.h" 
-#include "random.h"
+#include "EnemyOne.h"
+#include "Timer.h" 
+#include "Random.h"
 #include "debug.h"
 #include "Defines.h"
 #include "Sound.h"
 #include "ObjMan.h"
 #include "Object.h"
-
-extern CTimer g_cTimer;  //game timer
-extern CRandom g_cRandom; //random number generator
-extern CSoundManager* g_pSoundManager; //sound manager
-extern CObjectManager g_cObjectManager;
+#include "Snapshot.h"
+#include "World.h"
 
 
 const int CLOSE_DISTANCE = 100; ///< Distance for close to player. Probably just need this for attacking state
 const int FAR_DISTANCE = 400; ///< Distance for "far from player" - unused
 
 /// Constructor for enemyOne.
+/// \param world World that the enemy is in.
 /// \param name Object name string.
 /// \param location Vector location in world space.
 /// \param velocity Velocity vector.
 
-CEnemyOneObject::CEnemyOneObject(const char* name, const Vector3& location, const Vector3& velocity) :
-	CIntelligentObject(ENEMY1IDLE_OBJECT, name, Vector3(location.x, location.y, location.z), velocity) {
+CEnemyOneObject::CEnemyOneObject(CWorld* world, const char* name, const Vector3& location, const Vector3& velocity) :
+	CIntelligentObject(world, ENEMY1IDLE_OBJECT, name, Vector3(location.x, location.y, location.z), velocity) {
 	m_nAttackDelayTime = m_nLastAttackTime = 0;
 	m_nLastMoveTime = m_nMoveDelayTime = 0;
 	m_eState = MOVING_STATE;
-	m_nLastAiTime = 0; m_nAiDelayTime = 0; m_nLastSpawnTime = 0;
+	m_nAiDelayTime = 0; m_nLastSpawnTime = 0;
 	m_bAttacked = FALSE;
 } //constructor
 
-	/// Intelligent move function.
-	/// Just move like a dumb object then modify your private variables "intelligently".
+/// Constructor for enemyOne from a snapshot.
+/// \param world World that the enemy is in.
+/// \param s Snapshot.
+
+CEnemyOneObject::CEnemyOneObject(CWorld* world, CSnapshot& s) :
+	CIntelligentObject(world, ENEMY1IDLE_OBJECT, s) {
+	s.read(m_eState);
+	s.read(m_nLastSpawnTime);
+	s.read(m_nAiDelayTime);
+	s.read(m_nLastEntryTime);
+	s.read(m_nEntryDelayTime);
+	s.read(m_nLastMoveTime);
+	s.read(m_nMoveDelayTime);
+	s.read(m_nLastAttackTime);
+	s.read(m_nAttackDelayTime);
+	s.read(m_bAttacked);
+} //constructor
 
-void CEnemyOneObject::move() {
-	CGameObject::move(); //move like a dumb object
-	think(); //act intelligently
-} //move
+/// Save to a snapshot.
+/// \param s Snapshot.
+
+void CEnemyOneObject::save(CSnapshot& s) {
+	CIntelligentObject::save(s);
+	s.write(m_eState);
+	s.write(m_nLastSpawnTime);
+	s.write(m_nAiDelayTime);
+	s.write(m_nLastEntryTime);
+	s.write(m_nEntryDelayTime);
+	s.write(m_nLastMoveTime);
+	s.write(m_nMoveDelayTime);
+	s.write(m_nLastAttackTime);
+	s.write(m_nAttackDelayTime);
+	s.write(m_bAttacked);
+} //save
 
 	/// Main enemyOne AI function.
-	/// The real work is done by a function for each state. Call the appropriate
-	/// function for the current state periodically, based on a timer.
+	/// The real work is done by a function for each state. Called by the object
+	/// manager when the think event is due, and asks for the next one.
 
 void CEnemyOneObject::think() {
-	if (g_cTimer.elapsed(m_nLastAiTime, m_nAiDelayTime)) {
-		CIntelligentObject::think();
-		switch (m_eState) { //behavior depends on state
-		case MOVING_STATE: MovingAi(); break;
-		case ATTACKING_STATE: AttackingAi(); break;
-		default: break;
-		} //switch
-	} //if
+	CIntelligentObject::think();
+	switch (m_eState) { //behavior depends on state
+	case MOVING_STATE: MovingAi(); break;
+	case ATTACKING_STATE: AttackingAi(); break;
+	default: break;
+	} //switch
+	schedule(THINK_EVENT, m_nAiDelayTime); //think again later
 } //think
 
 	/// Set the current state.
@@ -69,12 +93,12 @@ void CEnemyOneObject::SetState(EnemyStateType state) {
 
 	switch (m_eState) { //change behavior settings.
 	case MOVING_STATE:
-		m_nAiDelayTime = 0 + g_cRandom.number(0, 100);
+		m_nAiDelayTime = 0 + m_pWorld->m_cRandom.number(0, 100);
 		break;
 
 	case ATTACKING_STATE:
-		m_nAiDelayTime = 0 + g_cRandom.number(0, 100);
-		m_nAttackDelayTime = 200 + g_cRandom.number(0, 100);
+		m_nAiDelayTime = 0 + m_pWorld->m_cRandom.number(0, 100);
+		m_nAttackDelayTime = 200 + m_pWorld->m_cRandom.number(0, 100);
 		break;
 
 	default: break;
@@ -85,7 +109,7 @@ void CEnemyOneObject::SetState(EnemyStateType state) {
 	/// These enemyOne's are just moving along, periodically looking for the player.
 
 void CEnemyOneObject::MovingAi() {
-	if (m_fDistance < CLOSE_DISTANCE && !m_bAttacked) {
+	if (distance() < CLOSE_DISTANCE && !m_bAttacked) {
 		SetState(ATTACKING_STATE);
 		m_bAttacked = TRUE;
 	}
@@ -96,7 +120,7 @@ void CEnemyOneObject::MovingAi() {
 void CEnemyOneObject::AttackingAi() {
 	for (int i = 0; i < 10; i++) {
 		//attack player. Shoot towards player's current position.
-		const float fAngle = m_nAttackOrientation;
+		const float fAngle = m_pCold->m_nAttackOrientation;
 		const float fSine = sin(fAngle);
 		const float fCosine = cos(fAngle);
 
@@ -105,18 +129,17 @@ void CEnemyOneObject::AttackingAi() {
 		const float fGunDy = 0.0f;
 
 		//initial bullet position
-		const Vector3 s = m_vPos + Vector3(fGunDx*fCosine - fGunDy*fSine, fGunDx*fSine - fGunDy*fCosine, 0);
+		const Vector3 s = position() + Vector3(fGunDx*fCosine - fGunDy*fSine, fGunDx*fSine - fGunDy*fCosine, 0);
 
 		//velocity of bullet
 		const float BULLETSPEED = 2.5f;
 		const Vector3 v = BULLETSPEED * Vector3(-fCosine, -fSine, 374);
 
-		g_cObjectManager.createObject(PROJECTILEENEMY1_OBJECT, "projectileEnemy1", s, v); //create bullet
+		m_pWorld->m_cObjectManager.createObject(PROJECTILEENEMY1_OBJECT, "projectileEnemy1", s, v); //create bullet
 
-		m_nAttackOrientation += 36.0f * 3.14f / 180;
+		m_pCold->m_nAttackOrientation += 36.0f * 3.14f / 180;
 	}
 	kill();
-	g_cObjectManager.createObject(ENEMY1AFTER_OBJECT, "enemy1IdleAfter", m_vPos, m_vVelocity);
-	g_cObjectManager.GarbageCollect();
+	m_pWorld->m_cObjectManager.createObject(ENEMY1AFTER_OBJECT, "enemy1IdleAfter", position(), velocity());
 	SetState(MOVING_STATE);
 } //AttackingAi
\ No newline at end of file
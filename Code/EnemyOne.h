@@ -6,7 +6,7 @@
 /// AI state for enemyOne. Maybe use BOOL instead depending on if we want it moving the whole time.
 /// So that we could set moving = TRUE and also have attacking = TRUE without interrupting moving and don't have to re-use code.
 
-#include "ai.h"
+#include "Ai.h"
 #include "Defines.h"
 
 /// \brief EnemyOne intelligent object.
@@ -23,7 +23,6 @@ private:
 
 	int m_nLastSpawnTime;
 
-	int m_nLastAiTime; ///< Last time AI was used.
 	int m_nAiDelayTime; ///< Time until AI next used.
 	int m_nLastEntryTime;
 	int m_nEntryDelayTime;
@@ -40,6 +39,7 @@ private:
 	void SetState(EnemyStateType state); ///< Change state.
 
 public:
-	CEnemyOneObject(const char* name, const Vector3& location, const Vector3& velocity); ///< Constructor.
-	void move(); ///< Move depending on time and speed.
+	CEnemyOneObject(CWorld* world, const char* name, const Vector3& location, const Vector3& velocity); ///< Constructor.
+	CEnemyOneObject(CWorld* world, CSnapshot& s); ///< Constructor from a snapshot.
+	void save(CSnapshot& s); ///< Save to a snapshot.
 }; //CEnemyOneObject
@@ -6,7 +6,7 @@
 /// AI state for enemy thief. Maybe use BOOL instead depending on if we want it moving the whole time.
 /// So that we could set moving = TRUE and also have attacking = TRUE without interrupting moving and don't have to re-use code.
 
-#include "ai.h"
+#include "Ai.h"
 #include "Defines.h"
 
 /// \brief EnemyOne intelligent object.
@@ -23,7 +23,6 @@ private:
 
 	int m_nLastSpawnTime;
 
-	int m_nLastAiTime; ///< Last time AI was used.
 	int m_nAiDelayTime; ///< Time until AI next used.
 	int m_nLastMoveTime;
 	int m_nMoveDelayTime;
@@ -38,6 +37,7 @@ private:
 	void SetState(EnemyStateType state); ///< Change state.
 
 public:
-	CEnemyThiefObject(const char* name, const Vector3& location, const Vector3& velocity); ///< Constructor.
-	void move(); ///< Move depending on time and speed.
+	CEnemyThiefObject(CWorld* world, const char* name, const Vector3& location, const Vector3& velocity); ///< Constructor.
+	CEnemyThiefObject(CWorld* world, CSnapshot& s); ///< Constructor from a snapshot.
+	void save(CSnapshot& s); ///< Save to a snapshot.
 }; //CEnemyOneObject
\ No newline at end of file
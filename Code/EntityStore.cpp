@@ -0,0 +1,186 @@
+/// \file EntityStore.cpp
+/// \brief Code for the archetype chunk storage class CEntityStore.
+
+#include "EntityStore.h"
+#include "Object.h"
+
+/// Constructor.
+/// \param mask Components of the entities.
+
+CArchetype::CArchetype(unsigned mask){
+  m_nMask = mask;
+  m_nCount = 0;
+} //constructor
+
+/// Destructor. Gives every chunk back to the heap.
+
+CArchetype::~CArchetype(){
+  for(ENTITYCHUNK* c: m_pChunk){
+    delete [] c->m_pTransform;
+    delete [] c->m_pVelocity;
+    delete [] c->m_pLifetime;
+    delete [] c->m_pAnimation;
+    delete [] c->m_pCollider;
+    delete [] c->m_pAi;
+    delete c;
+  } //for
+} //destructor
+
+/// Allocate an empty chunk with an array for each component of the archetype.
+/// \return Pointer to the chunk.
+
+ENTITYCHUNK* CArchetype::NewChunk(){
+  ENTITYCHUNK* c = new ENTITYCHUNK;
+  c->m_pArchetype = this;
+  c->m_nCount = 0;
+  c->m_pTransform = (m_nMask & TRANSFORM_COMPONENT)? new TRANSFORM[CHUNK_CAPACITY]: nullptr;
+  c->m_pVelocity = (m_nMask & VELOCITY_COMPONENT)? new VELOCITY[CHUNK_CAPACITY]: nullptr;
+  c->m_pLifetime = (m_nMask & LIFETIME_COMPONENT)? new LIFETIME[CHUNK_CAPACITY]: nullptr;
+  c->m_pAnimation = (m_nMask & ANIMATION_COMPONENT)? new ANIMATION[CHUNK_CAPACITY]: nullptr;
+  c->m_pCollider = (m_nMask & COLLIDER_COMPONENT)? new COLLIDER[CHUNK_CAPACITY]: nullptr;
+  c->m_pAi = (m_nMask & AI_COMPONENT)? new AISTATE[CHUNK_CAPACITY]: nullptr;
+  return c;
+} //NewChunk
+
+unsigned CArchetype::GetMask(){
+  return m_nMask;
+} //GetMask
+
+/// Get the number of chunks in use, that is, chunks with at least one entity.
+/// \return Number of chunks.
+
+int CArchetype::GetChunkCount(){
+  return (m_nCount + CHUNK_CAPACITY - 1)/CHUNK_CAPACITY;
+} //GetChunkCount
+
+ENTITYCHUNK* CArchetype::GetChunk(int i){
+  return m_pChunk[i];
+} //GetChunk
+
+/// Destructor. Objects should have been removed already.
+
+CEntityStore::~CEntityStore(){
+  for(CArchetype* a: m_pArchetype)
+    delete a;
+} //destructor
+
+/// Get the archetype with a given set of components, creating it if this is
+/// the first entity with them. There are only ever a few archetypes, so they
+/// are searched one by one.
+/// \param mask Components.
+/// \return Pointer to the archetype.
+
+CArchetype* CEntityStore::FindArchetype(unsigned mask){
+  for(CArchetype* a: m_pArchetype)
+    if(a->m_nMask == mask)
+      return a;
+
+  m_pArchetype.push_back(new CArchetype(mask));
+  return m_pArchetype.back();
+} //FindArchetype
+
+/// Give an object a row at the end of the archetype with the given
+/// components. The components start out zeroed.
+/// \param p Pointer to object.
+/// \param mask Components.
+
+void CEntityStore::add(CGameObject* p, unsigned mask){
+  CArchetype* a = FindArchetype(mask);
+  const int k = a->m_nCount/CHUNK_CAPACITY; //chunk that the new row goes into
+  if(k == (int)a->m_pChunk.size())
+    a->m_pChunk.push_back(a->NewChunk());
+
+  ENTITYCHUNK* c = a->m_pChunk[k];
+  const int row = c->m_nCount++;
+  a->m_nCount++;
+
+  c->m_pObject[row] = p;
+  if(c->m_pTransform)c->m_pTransform[row] = TRANSFORM();
+  if(c->m_pVelocity)c->m_pVelocity[row] = VELOCITY();
+  if(c->m_pLifetime)c->m_pLifetime[row] = LIFETIME();
+  if(c->m_pAnimation)c->m_pAnimation[row] = ANIMATION();
+  if(c->m_pCollider)c->m_pCollider[row] = COLLIDER();
+  if(c->m_pAi)c->m_pAi[row] = AISTATE();
+  c->m_nHit[row] = 0;
+  c->m_fLastX[row] = c->m_fLastY[row] = 0.0f;
+  c->m_nOrder[row] = 0;
+
+  p->m_pChunk = c;
+  p->m_nRow = row;
+} //add
+
+/// Copy one row over another, the components that both chunks have. Rows
+/// of the same archetype have all of them in common.
+/// \param to Chunk to copy to.
+/// \param i Row to copy to.
+/// \param from Chunk to copy from.
+/// \param j Row to copy from.
+
+void CEntityStore::CopyRow(ENTITYCHUNK* to, int i, ENTITYCHUNK* from, int j){
+  to->m_pObject[i] = from->m_pObject[j];
+  if(to->m_pTransform && from->m_pTransform)to->m_pTransform[i] = from->m_pTransform[j];
+  if(to->m_pVelocity && from->m_pVelocity)to->m_pVelocity[i] = from->m_pVelocity[j];
+  if(to->m_pLifetime && from->m_pLifetime)to->m_pLifetime[i] = from->m_pLifetime[j];
+  if(to->m_pAnimation && from->m_pAnimation)to->m_pAnimation[i] = from->m_pAnimation[j];
+  if(to->m_pCollider && from->m_pCollider)to->m_pCollider[i] = from->m_pCollider[j];
+  if(to->m_pAi && from->m_pAi)to->m_pAi[i] = from->m_pAi[j];
+  to->m_nHit[i] = from->m_nHit[j];
+  to->m_fLastX[i] = from->m_fLastX[j];
+  to->m_fLastY[i] = from->m_fLastY[j];
+  to->m_nOrder[i] = from->m_nOrder[j];
+} //CopyRow
+
+/// Take a row out of its archetype. The last entity of the archetype is
+/// moved into the gap, and told where it is now.
+/// \param c Chunk.
+/// \param row Row.
+
+void CEntityStore::RemoveRow(ENTITYCHUNK* c, int row){
+  CArchetype* a = c->m_pArchetype;
+  ENTITYCHUNK* last = a->m_pChunk[(a->m_nCount - 1)/CHUNK_CAPACITY]; //chunk of last entity
+  const int lastRow = last->m_nCount - 1;
+
+  if(last != c || lastRow != row){
+    CopyRow(c, row, last, lastRow);
+    CGameObject* q = c->m_pObject[row]; //the entity that moved
+    q->m_pChunk = c;
+    q->m_nRow = row;
+  } //if
+
+  last->m_nCount--;
+  a->m_nCount--;
+} //RemoveRow
+
+/// Take away an object's row.
+/// \param p Pointer to object.
+
+void CEntityStore::remove(CGameObject* p){
+  if(p->m_pChunk == nullptr)return;
+  RemoveRow(p->m_pChunk, p->m_nRow);
+  p->m_pChunk = nullptr;
+  p->m_nRow = -1;
+} //remove
+
+/// Move an object to the archetype with the given components, if it isn't
+/// in it already. It gets a new row, the components that the old and new
+/// archetypes have in common are copied over, and the rest start out zeroed.
+/// \param p Pointer to object.
+/// \param mask Components.
+
+void CEntityStore::change(CGameObject* p, unsigned mask){
+  ENTITYCHUNK* c = p->m_pChunk;
+  const int row = p->m_nRow;
+  if(c == nullptr || c->m_pArchetype->GetMask() == mask)return;
+
+  add(p, mask);
+  CopyRow(p->m_pChunk, p->m_nRow, c, row);
+  RemoveRow(c, row);
+} //change
+
+int CEntityStore::GetArchetypeCount(){
+  return (int)m_pArchetype.size();
+} //GetArchetypeCount
+
+CArchetype* CEntityStore::GetArchetype(int i){
+  return m_pArchetype[i];
+} //GetArchetype
@@ -0,0 +1,166 @@
+/// \file EntityStore.h
+/// \brief Interface for the archetype chunk storage class CEntityStore.
+
+#pragma once
+
+#include <vector>
+
+#include "Defines.h"
+#include "AnimationStore.h"
+
+using namespace std;
+
+class CGameObject;
+class C3DSprite;
+class CArchetype;
+
+/// \brief Components.
+///
+/// Each component is one bit. An archetype is the set of components that
+/// its entities have.
+
+const unsigned TRANSFORM_COMPONENT = 1 << 0; ///< Position and orientation.
+const unsigned VELOCITY_COMPONENT  = 1 << 1; ///< Velocity, spin and time of the last move.
+const unsigned LIFETIME_COMPONENT  = 1 << 2; ///< Life span and invulnerable time.
+const unsigned ANIMATION_COMPONENT = 1 << 3; ///< Sprite and animation frame.
+const unsigned COLLIDER_COMPONENT  = 1 << 4; ///< Health, of objects that can be hit or are getting over a hit.
+const unsigned AI_COMPONENT        = 1 << 5; ///< What an intelligent object knows about the player.
+
+const int CHUNK_CAPACITY = 64; ///< Most entities in a chunk.
+
+/// \brief Transform component.
+
+struct TRANSFORM{
+  Vector3 m_vPos; ///< Current location.
+  float m_fOrientation; ///< Orientation, angle to rotate about the Z axis.
+}; //TRANSFORM
+
+/// \brief Velocity component.
+
+struct VELOCITY{
+  Vector3 m_vVelocity; ///< Current velocity.
+  float m_fSpin; ///< Change in orientation each frame, right after the velocity so that they load together.
+  long long m_nLastMoveTime; ///< Last time moved, in microseconds.
+}; //VELOCITY
+
+/// \brief Lifetime component.
+
+struct LIFETIME{
+  int m_nLifeTime; ///< Time that object lives.
+  int m_nInvulnerableTime; ///< How long the object is invulnerable.
+}; //LIFETIME
+
+/// \brief Sprite and animation component.
+
+struct ANIMATION{
+  C3DSprite* m_pSprite; ///< Pointer to sprite.
+  ANIMATIONSPAN m_sAnimation; ///< Sequence of frame numbers to be repeated, in g_cAnimationStore.
+  int m_nCurrentFrame; ///< Frame to be displayed.
+  int m_nFrameCount; ///< Number of frames in animation.
+  int m_nFrameInterval; ///< Interval between frames.
+}; //ANIMATION
+
+/// \brief Collider component.
+
+struct COLLIDER{
+  int m_nHealth; ///< Hits left.
+}; //COLLIDER
+
+/// \brief AI component.
+
+struct AISTATE{
+  Vector3 m_vPlaneLoc; ///< Player's location.
+  float m_fDistance; ///< Euclidean distance to player.
+  float m_fYDistance; ///< Vertical distance to player.
+  float m_fXDistance; ///< Horizontal distance to player.
+}; //AISTATE
+
+/// \brief A chunk of entities of one archetype.
+///
+/// Each component that the archetype has is an array with a row for each
+/// entity, and the arrays of components that it doesn't have are nullptr.
+/// Rows 0 to m_nCount - 1 are in use.
+
+struct ENTITYCHUNK{
+  CArchetype* m_pArchetype; ///< Archetype that the chunk belongs to.
+  int m_nCount; ///< Number of rows in use.
+  CGameObject* m_pObject[CHUNK_CAPACITY]; ///< Object that owns each row.
+  TRANSFORM* m_pTransform; ///< Transform components.
+  VELOCITY* m_pVelocity; ///< Velocity components.
+  LIFETIME* m_pLifetime; ///< Lifetime components.
+  ANIMATION* m_pAnimation; ///< Sprite and animation components.
+  COLLIDER* m_pCollider; ///< Collider components.
+  AISTATE* m_pAi; ///< AI components.
+  unsigned char m_nHit[CHUNK_CAPACITY]; ///< Edges of the arena that each row was past when last integrated.
+  float m_fLastX[CHUNK_CAPACITY]; ///< X coordinate of each row before it was last integrated.
+  float m_fLastY[CHUNK_CAPACITY]; ///< Y coordinate of each row before it was last integrated.
+  unsigned m_nOrder[CHUNK_CAPACITY]; ///< Place of each row's object in the object list, larger is nearer the front, 0 if not in it yet.
+}; //ENTITYCHUNK
+
+/// \brief Entities with the same components.
+///
+/// An archetype's entities are packed into its chunks with no gaps, so every
+/// chunk in use is full except the last. Chunks that empty out are kept for
+/// the next entities instead of going back to the heap.
+
+class CArchetype{
+  friend class CEntityStore;
+
+  private:
+    unsigned m_nMask; ///< Components of the entities.
+    vector<ENTITYCHUNK*> m_pChunk; ///< Chunks, in use and spare.
+    int m_nCount; ///< Number of entities.
+
+    ENTITYCHUNK* NewChunk(); ///< Allocate an empty chunk.
+
+  public:
+    CArchetype(unsigned mask); ///< Constructor.
+    ~CArchetype(); ///< Destructor.
+
+    unsigned GetMask(); ///< Get the components.
+    int GetChunkCount(); ///< Get the number of chunks in use.
+    ENTITYCHUNK* GetChunk(int i); ///< Get a chunk in use.
+}; //CArchetype
+
+/// \brief The entity store.
+///
+/// Holds the components of game objects in archetype chunks, so that a pass
+/// over one or two components walks contiguous arrays of just those, instead
+/// of pulling every whole object into the cache. An object owns one row of
+/// one archetype for as long as it lives. Removing an entity moves the last
+/// entity of its archetype into the gap, so rows change, and an object finds
+/// its row through the chunk and row that the store keeps up to date in it.
+/// An object whose type changes may need different components, and then it
+/// moves to another archetype, keeping the components that both have.
+/// Adding, removing and changing should only happen between passes over the
+/// chunks.
+
+class CEntityStore{
+  private:
+    vector<CArchetype*> m_pArchetype; ///< Archetypes, in the order that they were first used.
+
+    CArchetype* FindArchetype(unsigned mask); ///< Get the archetype with these components.
+    static void CopyRow(ENTITYCHUNK* to, int i, ENTITYCHUNK* from, int j); ///< Copy the components of a row.
+    void RemoveRow(ENTITYCHUNK* c, int row); ///< Take a row out of its archetype.
+
+  public:
+    ~CEntityStore(); ///< Destructor.
+
+    void add(CGameObject* p, unsigned mask); ///< Give an object a row with these components.
+    void remove(CGameObject* p); ///< Take away an object's row.
+    void change(CGameObject* p, unsigned mask); ///< Move an object to the archetype with these components.
+    int GetArchetypeCount(); ///< Get the number of archetypes.
+    CArchetype* GetArchetype(int i); ///< Get an archetype.
+
+    /// Call a function on every chunk in use whose archetype has all of the
+    /// given components.
+    /// \param mask Components that are needed.
+    /// \param f Function taking an ENTITYCHUNK&.
+
+    template<class F> void ForEachChunk(unsigned mask, F f){
+      for(CArchetype* a: m_pArchetype)
+        if((a->GetMask() & mask) == mask)
+          for(int i=0; i<a->GetChunkCount(); i++)
+            f(*a->GetChunk(i));
+    } //ForEachChunk
+}; //CEntityStore
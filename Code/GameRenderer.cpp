@@ -23,25 +23,25 @@ extern int g_nScreenWidth;
 extern int g_nScreenHeight;
 extern BOOL g_bWireFrame;
 extern CImageFileNameList g_cImageFileName;
-extern CObjectManager g_cObjectManager;
+extern CObjectManager& g_cObjectManager;
 extern CSpriteManager g_cSpriteManager;
-extern CSoundManager* g_pSoundManager;
-extern CTimer g_cTimer;
+extern CSoundManager*& g_pSoundManager;
+extern CTimer& g_cTimer;
 extern ShaderType g_nPixelShader;
-extern float g_fScreenScroll;
+extern float& g_fScreenScroll;
 extern BOOL g_bDarkenScreen;
 extern BOOL g_bPlayerTyped[4];
 extern BOOL g_bSpecialAttackReleased;
-extern BOOL g_bSpecialActivate;
-extern GameStateType g_nGameState;
-extern LevelStateType g_nLevelState;
-extern CGameObject* player;
-extern CRandom g_cRandom;
+extern BOOL& g_bSpecialActivate;
+extern GameStateType& g_nGameState;
+extern LevelStateType& g_nLevelState;
+extern CGameObject*& player;
+extern CRandom& g_cRandom;
 
 extern int cursorPos;
 extern int cursorPosMax;
 
-extern int m_nEnemyCount;
+extern int& m_nEnemyCount;
 
 CGameObject* g_cObject;
 
@@ -1276,7 +1276,7 @@ void CGameRenderer::ComposeFrame(){
 		m_bFirstScreenPos = FALSE;
 	}
 
-  float x = p->m_vPos.x, y = p->m_vPos.y; //player's current location
+  float x = p->position().x, y = p->position().y; //player's current location
   y = min(y, g_nScreenHeight/2.0f);
   y = max(y, g_nScreenHeight/4.0f);
 
@@ -1312,10 +1312,10 @@ void CGameRenderer::ComposeFrame(){
 
 	//End of level, show results screen
   //once player crosses the end of the screen, then procede to the end screen state
-  if(p->m_vPos.x > 1700){
+  if(p->position().x > 1700){
 	  g_nGameState = WON_GAMESTATE;
-	  p->m_vPos.x = 1705;
-	  p->m_bCanFire = FALSE;
+	  p->position().x = 1705;
+	  p->SetFlag(CANFIRE_FLAG, FALSE);
 	  if(g_nLevelState == COMICWORLD_STATE)
 		  g_pSoundManager->stop(UNLEASH_SOUND);
 	  else if(g_nLevelState == FANTASY_STATE)
@@ -1390,9 +1390,11 @@ void CGameRenderer::EnemyFormationSquare(float px, float py, float r, int n, flo
 
 void CGameRenderer::ProcessFrame(){
 	if(g_nGameState == PLAYING_GAMESTATE){
+		g_cObjectManager.UpdateRewind(); //snapshot for rewind, every so often
 		g_cTimer.beginframe();
 		g_cObjectManager.move(); //move objects
 		ComposeFrame(); //compose a frame of animation
+		g_cTimer.endframe();
 	}
 	else if(g_nGameState == ENDING_GAMESTATE){
 		Ending();
@@ -0,0 +1,14 @@
+/// \file Headless.cpp
+/// \brief Code for the stand-ins for Windows functions in the headless build.
+
+#include <chrono>
+
+#include "Headless.h"
+
+/// Read a monotonic clock.
+/// \return Milliseconds since some fixed time.
+
+DWORD timeGetTime(){
+  using namespace std::chrono;
+  return (DWORD)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+} //timeGetTime
@@ -0,0 +1,86 @@
+/// \file Headless.h
+/// \brief Stand-ins for the Windows and DirectX types used by the gameplay core.
+///
+/// The headless build defines HEADLESS and includes this instead of the
+/// Windows, Direct3D and DirectXTK headers, so that the object manager, the
+/// game objects, the AI, the timer and the random number generator can be
+/// compiled anywhere. Only what the gameplay core actually uses is here.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+//Windows types
+
+typedef int BOOL; ///< Windows boolean.
+typedef unsigned long DWORD; ///< Windows double word.
+typedef uintptr_t WPARAM; ///< Windows message parameter.
+
+#define TRUE 1 ///< Windows true.
+#define FALSE 0 ///< Windows false.
+#define MAX_PATH 260 ///< Longest file name.
+
+//virtual key codes used by the keyboard handler
+
+#define VK_SHIFT 0x10 ///< Shift key.
+#define VK_ESCAPE 0x1B ///< Escape key.
+#define VK_LEFT 0x25 ///< Left arrow key.
+#define VK_UP 0x26 ///< Up arrow key.
+#define VK_RIGHT 0x27 ///< Right arrow key.
+#define VK_DOWN 0x28 ///< Down arrow key.
+
+DWORD timeGetTime(); ///< Milliseconds since some fixed time.
+
+namespace DirectX{
+  const float XM_PI = 3.141592654f; ///< Pi.
+
+  /// \brief 4x4 matrix, only here so that shader constant buffers compile.
+
+  struct XMFLOAT4X4{
+    float m[4][4]; ///< Matrix entries.
+  }; //XMFLOAT4X4
+
+  namespace SimpleMath{
+    struct Vector3;
+
+    /// \brief 2D vector with the parts of the SimpleMath interface in use.
+
+    struct Vector2{
+      float x, y; ///< Coordinates.
+
+      Vector2(): x(0), y(0){}
+      Vector2(float a, float b): x(a), y(b){}
+      Vector2(const Vector3& v); ///< Drop Z.
+
+      float Length() const{return sqrtf(x*x + y*y);}
+      Vector2 operator+(const Vector2& v) const{return Vector2(x + v.x, y + v.y);}
+      Vector2 operator-(const Vector2& v) const{return Vector2(x - v.x, y - v.y);}
+      Vector2 operator*(float s) const{return Vector2(x*s, y*s);}
+    }; //Vector2
+
+    /// \brief 3D vector with the parts of the SimpleMath interface in use.
+
+    struct Vector3{
+      float x, y, z; ///< Coordinates.
+
+      Vector3(): x(0), y(0), z(0){}
+      Vector3(float a, float b, float c): x(a), y(b), z(c){}
+
+      float Length() const{return sqrtf(x*x + y*y + z*z);}
+      Vector3 operator+(const Vector3& v) const{return Vector3(x + v.x, y + v.y, z + v.z);}
+      Vector3 operator-(const Vector3& v) const{return Vector3(x - v.x, y - v.y, z - v.z);}
+      Vector3 operator-() const{return Vector3(-x, -y, -z);}
+      Vector3 operator*(float s) const{return Vector3(x*s, y*s, z*s);}
+      Vector3& operator+=(const Vector3& v){x += v.x; y += v.y; z += v.z; return *this;}
+      Vector3& operator-=(const Vector3& v){x -= v.x; y -= v.y; z -= v.z; return *this;}
+      bool operator==(const Vector3& v) const{return x == v.x && y == v.y && z == v.z;}
+      bool operator!=(const Vector3& v) const{return !(*this == v);}
+    }; //Vector3
+
+    inline Vector2::Vector2(const Vector3& v): x(v.x), y(v.y){}
+    inline Vector3 operator*(float s, const Vector3& v){return v*s;}
+  } //SimpleMath
+} //DirectX
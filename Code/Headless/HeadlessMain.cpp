@@ -0,0 +1,677 @@
+/// \file HeadlessMain.cpp
+/// \brief Driver for the headless build.
+///
+/// Runs a level of the gameplay core with no window, no graphics and no
+/// sound for a given number of ticks. The player is steered and fires from a
+/// fixed script, enemy formations are spawned every few ticks, and at the end
+/// the throughput is printed. The timer runs on a virtual clock that moves
+/// a 60th of a second each tick, so a run does not depend on how fast the
+/// machine is, and with the same seed every run plays out the same. Usage:
+///
+///   csf_headless [ticks] [settings file] [seed]
+///   csf_headless -record [recording] [ticks] [settings file] [seed]
+///   csf_headless -replay [recording] [settings file]
+///   csf_headless -rewind [ticks] [settings file] [seed]
+///   csf_headless -worlds [worlds] [ticks] [settings file] [seed]
+///   csf_headless -narrowphase [queries] [seed]
+///
+/// With -record the seed, the input and a hash of the world state after
+/// each tick are written to a recording. With -replay the input comes from
+/// a recording instead of the script, the ticks are played as fast as they
+/// will go, and the world is hashed after each one to check that it plays
+/// out exactly as it did when it was recorded. With -rewind a snapshot of
+/// the world is taken half way, restored at the end, and the second half
+/// played again to check that it comes out the same, and the time taken to
+/// save and restore the snapshot is printed. With -worlds that many worlds,
+/// each with a seed of its own, are played one after the other and then
+/// all at once on a thread each, and the hashes are checked to be the same
+/// both ways. With -narrowphase no level is played, instead the batched
+/// collision narrowphase is timed against the scalar distance test for
+/// 100, 1000 and 10000 targets, and checked to find the same hits.
+///
+/// Run it from the folder that contains gamesettings.xml, or give the path.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "Defines.h"
+#include "Timer.h"
+#include "Random.h"
+#include "Object.h"
+#include "ObjMan.h"
+#include "SpriteMan.h"
+#include "Sound.h"
+#include "Replay.h"
+#include "Snapshot.h"
+#include "World.h"
+#include "Narrowphase.h"
+
+//globals that Main.cpp defines in the Windows build, shared by all worlds
+CSpriteManager g_cSpriteManager; ///< The sprite manager.
+CObjectSettings g_cObjectSettings; ///< Settings for each kind of object.
+CAnimationStore g_cAnimationStore; ///< Animation sequences of all objects.
+CSoundManager g_cSoundManager; ///< The sound manager, which plays nothing.
+
+int g_nScreenWidth = 1024; ///< Screen width.
+int g_nScreenHeight = 768; ///< Screen height.
+
+//XML settings
+tinyxml2::XMLDocument g_xmlDocument; ///< TinyXML document for settings.
+XMLElement* g_xmlSettings = nullptr; ///< TinyXML element for settings tag.
+
+const int DEFAULT_TICKS = 100000; ///< Ticks to run if none are given.
+const unsigned long long DEFAULT_SEED = 1; ///< Random number seed if none is given.
+const int DEFAULT_QUERIES = 10000; ///< Points to test against each set of targets when timing the narrowphase.
+const int SPAWN_INTERVAL = 120; ///< Ticks between enemy formations.
+const int MAX_ENEMIES = 40; ///< Most enemies spawned by formations at once.
+const long long TICK_TIME = 16667; ///< Microseconds of game time in each tick, 60 ticks a second.
+const int MOVE_PHASE = 45; ///< Ticks that the script holds each arrow key.
+const int FIRE_INTERVAL = 4; ///< Ticks between presses of the fire key.
+const float PLANE_Z = 375.0f; ///< Z coordinate of the plane that the player moves in.
+const unsigned HASH_PRIME = 16777619u; ///< Multiplier for combining the hashes of a run.
+
+/// \brief What the settings file says about each world.
+///
+/// The settings file is read once, but each world has its own object
+/// manager, so what goes into the object manager is kept here for setting
+/// up each world.
+
+struct WORLDSETTINGS{
+  BOOL m_bCollision; ///< TRUE if there is a collision tag.
+  BOOL m_bBroadphase; ///< TRUE to use the broadphase grid.
+  float m_fCellSize; ///< Broadphase grid cell size.
+  BOOL m_bSwept; ///< TRUE to test projectiles along their move.
+  BOOL m_bNarrowphase; ///< TRUE to test every target in one batch when the grid is off.
+  BOOL m_bRewind; ///< TRUE if there is a rewind tag.
+  int m_nSnapshots; ///< Number of rewind snapshots.
+  int m_nInterval; ///< Time between rewind snapshots in ms.
+}; //WORLDSETTINGS
+
+WORLDSETTINGS g_sWorldSettings; ///< Object manager settings from the settings file.
+
+/// \brief An object type and the name it goes by in the settings file.
+
+struct OBJECTNAME{
+  ObjectType m_nType; ///< Object type.
+  const char* m_pName; ///< Name of sprite and object tags.
+}; //OBJECTNAME
+
+/// Everything that can be created during play.
+
+static const OBJECTNAME g_sObjectName[] = {
+  {FREDIDLE_OBJECT, "fredIdle"}, {FREDATTACK_OBJECT, "fredAttack"},
+  {FREDHURT_OBJECT, "fredHurt"}, {FREDLOST_OBJECT, "fredLost"},
+  {SWAZIDLE_OBJECT, "swazIdle"}, {SWAZATTACK_OBJECT, "swazAttack"},
+  {SWAZHURT_OBJECT, "swazHurt"}, {SWAZLOST_OBJECT, "swazLost"},
+  {POLKIDLE_OBJECT, "polkIdle"}, {POLKATTACK_OBJECT, "polkAttack"},
+  {POLKHURT_OBJECT, "polkHurt"}, {POLKLOST_OBJECT, "polkLost"},
+
+  {ENEMYENTRY_OBJECT, "enemyEntry"}, {ENEMYEXIT_OBJECT, "enemyExit"},
+  {ENEMY1IDLE_OBJECT, "enemy1Idle"}, {ENEMY1AFTER_OBJECT, "enemy1IdleAfter"},
+  {ENEMY1HURT_OBJECT, "enemy1Hurt"},
+  {ENEMYINVADERIDLE_OBJECT, "enemyInvaderIdle"},
+  {ENEMYINVADERATTACK_OBJECT, "enemyInvaderAttack"},
+  {ENEMYINVADERHURT_OBJECT, "enemyInvaderHurt"},
+  {ENEMYZOOMERIDLE_OBJECT, "enemyZoomerIdle"},
+  {ENEMYZOOMERBOUNCE_OBJECT, "enemyZoomerBounce"},
+  {ENEMYZOOMERIDLEFLIP_OBJECT, "enemyZoomerIdleFlip"},
+  {ENEMYZOOMERBOUNCEFLIP_OBJECT, "enemyZoomerBounceFlip"},
+  {ENEMYZOOMERHURT_OBJECT, "enemyZoomerHurt"},
+  {ENEMYTHIEFIDLE_OBJECT, "enemyThiefIdle"},
+  {ENEMYTHIEFATTACK_OBJECT, "enemyThiefAttack"},
+  {ENEMYTHIEFHURT_OBJECT, "enemyThiefHurt"},
+
+  {PROJECTILEF_OBJECT, "projectileF"}, {PROJECTILES_OBJECT, "projectileS"},
+  {PROJECTILEP_OBJECT, "projectileP"}, {PROJECTILED_OBJECT, "projectileD"},
+  {PROJECTILEZ_OBJECT, "projectileZ"}, {PROJECTILEK_OBJECT, "projectileK"},
+  {PROJECTILEENEMY1_OBJECT, "projectileEnemy1"},
+  {PROJECTILEINVADER_OBJECT, "projectileInvader"},
+  {PROJECTILETHIEF_OBJECT, "projectileThief"},
+  {SHIELD_OBJECT, "shield"}, {ASSISTFRED_OBJECT, "assistFred"},
+  {ASSISTSWAZ_OBJECT, "assistSwaz"}, {ASSISTPOLK_OBJECT, "assistPolk"},
+  {EXPLOSION_OBJECT, "explosion"},
+
+  {ITEMHEART_OBJECT, "itemHealth"},
+  {ITEMR_OBJECT, "itemLetterR"}, {ITEME_OBJECT, "itemLetterE"}, {ITEMD_OBJECT, "itemLetterD"},
+  {ITEMW_OBJECT, "itemLetterW"}, {ITEMA_OBJECT, "itemLetterA"}, {ITEMZ_OBJECT, "itemLetterZ"},
+  {ITEMO_OBJECT, "itemLetterO"}, {ITEML_OBJECT, "itemLetterL"}, {ITEMK_OBJECT, "itemLetterK"},
+}; //g_sObjectName
+
+/// \brief Keyboard handler.
+///
+/// The headless version of the keyboard handler in Main.cpp, with only the
+/// keys that the input script presses: the arrow keys, and the fire keys
+/// of the three players. Both call the same player actions in the object
+/// manager.
+/// \param world World that the keys are pressed in
+/// \param keystroke Virtual key code for the key pressed
+/// \return TRUE if the game is to exit
+
+BOOL KeyboardHandler(CWorld& world, WPARAM keystroke){
+  if(world.m_nGameState != PLAYING_GAMESTATE || world.m_pPlayer == nullptr)
+    return FALSE;
+
+  CObjectManager& objects = world.m_cObjectManager;
+
+  switch(keystroke){
+    case VK_ESCAPE: return TRUE;
+    case VK_UP: objects.MovePlayer(UP_DIRECTION); break;
+    case VK_DOWN: objects.MovePlayer(DOWN_DIRECTION); break;
+    case VK_LEFT: objects.MovePlayer(LEFT_DIRECTION); break;
+    case VK_RIGHT: objects.MovePlayer(RIGHT_DIRECTION); break;
+    case 'F': objects.FireAs(FREDIDLE_OBJECT, FREDATTACK_OBJECT, "fredAttack"); break;
+    case 'S': objects.FireAs(SWAZIDLE_OBJECT, SWAZATTACK_OBJECT, "swazAttack"); break;
+    case 'P': objects.FireAs(POLKIDLE_OBJECT, POLKATTACK_OBJECT, "polkAttack"); break;
+  } //switch
+
+  return FALSE;
+} //KeyboardHandler
+
+/// \brief Keyboard handler for released keys.
+///
+/// The headless version of the one in Main.cpp, for the arrow keys only.
+/// \param world World that the keys are released in
+/// \param keystroke Virtual key code for the key released
+/// \return TRUE if the game is to exit
+
+BOOL KeyboardHandlerReleased(CWorld& world, WPARAM keystroke){
+  CObjectManager& objects = world.m_cObjectManager;
+
+  switch(keystroke){
+    case VK_UP: objects.StopPlayer(UP_DIRECTION); break;
+    case VK_DOWN: objects.StopPlayer(DOWN_DIRECTION); break;
+    case VK_LEFT: objects.StopPlayer(LEFT_DIRECTION); break;
+    case VK_RIGHT: objects.StopPlayer(RIGHT_DIRECTION); break;
+  } //switch
+
+  return FALSE;
+} //KeyboardHandlerReleased
+
+/// Load the settings file and everything that is read from it. What goes
+/// into the object manager is kept in g_sWorldSettings for InitWorld.
+/// \param fileName Settings file name.
+/// \return TRUE if the file has a settings tag.
+
+BOOL LoadSettings(const char* fileName){
+  if(g_xmlDocument.LoadFile(fileName) != 0)return FALSE;
+  g_xmlSettings = g_xmlDocument.FirstChildElement("settings");
+  if(g_xmlSettings == nullptr)return FALSE;
+
+  XMLElement* renderSettings = g_xmlSettings->FirstChildElement("renderer"); //renderer tag
+  if(renderSettings){
+    g_nScreenWidth = renderSettings->IntAttribute("width");
+    g_nScreenHeight = renderSettings->IntAttribute("height");
+  } //if
+
+  XMLElement* collisionSettings = g_xmlSettings->FirstChildElement("collision"); //collision tag
+  g_sWorldSettings.m_bCollision = collisionSettings != nullptr;
+  if(collisionSettings){
+    g_sWorldSettings.m_bBroadphase = collisionSettings->BoolAttribute("broadphase");
+    g_sWorldSettings.m_fCellSize = collisionSettings->FloatAttribute("cellsize");
+    g_sWorldSettings.m_bSwept = collisionSettings->BoolAttribute("swept");
+    g_sWorldSettings.m_bNarrowphase = collisionSettings->BoolAttribute("narrowphase");
+  } //if
+
+  XMLElement* rewindSettings = g_xmlSettings->FirstChildElement("rewind"); //rewind tag
+  g_sWorldSettings.m_bRewind = rewindSettings != nullptr;
+  if(rewindSettings){
+    g_sWorldSettings.m_nSnapshots = rewindSettings->IntAttribute("snapshots");
+    g_sWorldSettings.m_nInterval = rewindSettings->IntAttribute("interval");
+  } //if
+
+  g_cObjectSettings.load(g_xmlSettings);
+
+  for(const OBJECTNAME& n: g_sObjectName)
+    g_cSpriteManager.Load(n.m_nType, const_cast<char*>(n.m_pName));
+
+  g_xmlSettings = nullptr;
+  g_xmlDocument.Clear();
+  return TRUE;
+} //LoadSettings
+
+/// Set up a world to play the first level from the settings file, with its
+/// timer on a virtual clock that starts from zero.
+/// \param world World to set up.
+/// \param seed Random number seed.
+
+void InitWorld(CWorld& world, unsigned long long seed){
+  world.m_cRandom.seed(seed);
+  world.m_pSoundManager = &g_cSoundManager;
+  world.m_nLevelState = COMICWORLD_STATE;
+
+  CObjectManager& objects = world.m_cObjectManager;
+  if(g_sWorldSettings.m_bCollision){
+    objects.SetBroadphase(g_sWorldSettings.m_bBroadphase, g_sWorldSettings.m_fCellSize);
+    objects.SetSwept(g_sWorldSettings.m_bSwept);
+    objects.SetNarrowphase(g_sWorldSettings.m_bNarrowphase);
+  } //if
+  if(g_sWorldSettings.m_bRewind)
+    objects.SetRewind(g_sWorldSettings.m_nSnapshots, g_sWorldSettings.m_nInterval);
+  for(const OBJECTNAME& n: g_sObjectName)
+    objects.InsertObjectType(n.m_pName, n.m_nType);
+
+  world.m_cTimer.SetTimeSource(VIRTUAL_TIMESOURCE);
+  world.m_cTimer.start();
+} //InitWorld
+
+/// Start the level over with a new player, as BeginGame does. After a game
+/// over the level is restored from the snapshot taken when it began.
+/// \param world World to start the level in.
+
+void BeginLevel(CWorld& world){
+  CObjectManager& objects = world.m_cObjectManager;
+  const BOOL restart = world.m_nGameState == GAMEOVER_GAMESTATE && objects.RestartLevel();
+  objects.ResetPlayerStats();
+  world.m_nGameState = PLAYING_GAMESTATE;
+  if(restart)return;
+
+  world.m_cTimer.StartLevelTimer();
+  objects.clear();
+  objects.PrewarmPools();
+  world.m_fScreenScroll = g_nScreenWidth/2.0f;
+
+  world.m_pPlayer = objects.createObject(FREDIDLE_OBJECT, "fredIdle",
+    Vector3(790/2.0f, 612/2.0f, PLANE_Z), Vector3(0, 0, 0));
+  objects.setPlayer(6, 1.0f);
+  objects.SaveLevelStart();
+} //BeginLevel
+
+/// Spawn a formation of enemies ahead of the player, in a line or a
+/// square, the way the renderer does it during play.
+/// \param world World to spawn the enemies in.
+
+void SpawnFormation(CWorld& world){
+  const float px = world.m_fScreenScroll + g_nScreenWidth/2.0f - 340.0f;
+  const float py = g_nScreenHeight/2.0f - 100.0f;
+  const float radius = (float)world.m_cRandom.number(50, 150);
+  const float rotate = world.m_cRandom.number(0, 359)*XM_PI/180.0f;
+  const BOOL square = world.m_cRandom.number(0, 1) == 0;
+  const int n = 4;
+
+  for(int i=0; i<n && world.m_nEnemyCount<MAX_ENEMIES; i++){
+    Vector3 s;
+    if(square){
+      s.x = px + radius*sinf(2.0f*i*XM_PI/n + rotate);
+      s.y = py + radius*cosf(2.0f*i*XM_PI/n + rotate);
+    } //if
+    else{
+      s.x = px + 70.0f*i*cosf(rotate);
+      s.y = py + 70.0f*i*sinf(rotate);
+    } //else
+    s.z = PLANE_Z - 12.5f;
+
+    world.m_cObjectManager.createObject(ENEMYENTRY_OBJECT, "enemyEntry", Vector3(s.x, s.y - 5, s.z - 1), Vector3(0, 0, 0));
+    world.m_nEnemyCount++;
+  } //for
+} //SpawnFormation
+
+/// Press and release keys for one tick of the input script. The player
+/// goes up, right, down and left in turn, and fires every few ticks.
+/// \param tick Tick number.
+/// \param input [out] Keys pressed and released, in order.
+
+void ScriptedInput(int tick, vector<INPUTEVENT>& input){
+  static const unsigned char arrow[4] = {VK_UP, VK_RIGHT, VK_DOWN, VK_LEFT};
+
+  input.clear();
+
+  if(tick%MOVE_PHASE == 0){
+    const int phase = tick/MOVE_PHASE;
+    if(phase > 0)input.push_back({arrow[(phase - 1)%4], FALSE});
+    input.push_back({arrow[phase%4], TRUE});
+  } //if
+
+  if(tick%FIRE_INTERVAL == 0)
+    input.push_back({'F', TRUE});
+} //ScriptedInput
+
+/// Send the keys pressed and released during a tick to the keyboard handlers.
+/// \param world World that the keys are pressed in.
+/// \param input Keys pressed and released, in order.
+
+void ApplyInput(CWorld& world, const vector<INPUTEVENT>& input){
+  for(const INPUTEVENT& e: input)
+    if(e.m_bDown)KeyboardHandler(world, e.m_nKey);
+    else KeyboardHandlerReleased(world, e.m_nKey);
+} //ApplyInput
+
+/// Play a tick: the input, then the objects, then the scrolling and
+/// spawning that the renderer does in the game.
+/// \param world World to play the tick in.
+/// \param tick Tick number.
+/// \param input Keys pressed and released during the tick, in order.
+
+void PlayTick(CWorld& world, int tick, const vector<INPUTEVENT>& input){
+  world.m_cTimer.beginframe();
+  ApplyInput(world, input);
+  world.m_cObjectManager.move();
+  world.m_cTimer.endframe();
+
+  if(world.m_fScreenScroll < 1.3f*g_nScreenWidth)
+    world.m_fScreenScroll += 0.4f;
+  if(tick%SPAWN_INTERVAL == 0)
+    SpawnFormation(world);
+} //PlayTick
+
+/// Play a level in a world of its own with the input script, starting it
+/// over whenever the player runs out of lives. Everything that this touches
+/// belongs to the world, so it can be run on several threads at once.
+/// \param seed Random number seed.
+/// \param ticks Number of ticks to play.
+/// \param hash [out] Hash of the world state after every tick, combined.
+
+void PlayWorld(unsigned long long seed, int ticks, unsigned& hash){
+  std::unique_ptr<CWorld> world(new CWorld);
+  InitWorld(*world, seed);
+  world->m_nGameState = GAMEOVER_GAMESTATE; //so that the player stats are reset
+
+  vector<INPUTEVENT> input;
+  hash = 0;
+
+  for(int tick=0; tick<ticks; tick++){
+    if(world->m_nGameState != PLAYING_GAMESTATE)
+      BeginLevel(*world);
+    world->m_cObjectManager.UpdateRewind();
+    ScriptedInput(tick, input);
+    world->m_cTimer.microadvance(TICK_TIME);
+    PlayTick(*world, tick, input);
+    hash = (hash ^ world->m_cObjectManager.HashState())*HASH_PRIME;
+  } //for
+} //PlayWorld
+
+/// Microseconds since a time on the steady clock.
+/// \param t Time on the steady clock.
+/// \return Microseconds since then.
+
+double MicrosecondsSince(std::chrono::steady_clock::time_point t){
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t).count();
+} //MicrosecondsSince
+
+/// Play a number of worlds one after the other and then all at once, one
+/// to a thread, print how long each took, and check that each world played
+/// out the same both ways.
+/// \param n Number of worlds.
+/// \param ticks Number of ticks to play in each world.
+/// \param seed Random number seed of the first world, the others count up from it.
+/// \return 0 if every world matches, 2 if not
+
+int PlayWorlds(int n, int ticks, unsigned long long seed){
+  vector<unsigned> serial(n), threaded(n); //hashes of each world played both ways
+
+  auto start = std::chrono::steady_clock::now();
+  for(int i=0; i<n; i++)
+    PlayWorld(seed + i, ticks, serial[i]);
+  const double serialSeconds = MicrosecondsSince(start)/1e6;
+
+  vector<std::thread> threads;
+  start = std::chrono::steady_clock::now();
+  for(int i=0; i<n; i++)
+    threads.push_back(std::thread(PlayWorld, seed + i, ticks, std::ref(threaded[i])));
+  for(std::thread& t: threads)
+    t.join();
+  const double threadedSeconds = MicrosecondsSince(start)/1e6;
+
+  int mismatch = -1; //first world that played out differently
+  for(int i=0; i<n && mismatch<0; i++)
+    if(serial[i] != threaded[i])
+      mismatch = i;
+
+  const double total = (double)n*ticks; //ticks in all worlds
+
+  printf("worlds:       %d, %d ticks each, seeds %llu to %llu\n", n, ticks, seed, seed + n - 1);
+  printf("serial:       %.3f s, %.0f ticks/sec\n", serialSeconds, serialSeconds > 0? total/serialSeconds: 0.0);
+  printf("threaded:     %.3f s, %.0f ticks/sec, %.2f times as fast on %d threads\n", threadedSeconds,
+    threadedSeconds > 0? total/threadedSeconds: 0.0, threadedSeconds > 0? serialSeconds/threadedSeconds: 0.0, n);
+
+  if(mismatch < 0){
+    printf("worlds:       all %d played out the same on their own threads\n", n);
+    return 0;
+  } //if
+
+  printf("worlds:       world %d played out differently, hash %08x, was %08x\n", mismatch, threaded[mismatch], serial[mismatch]);
+  return 2;
+} //PlayWorlds
+
+/// Time the narrowphase against the scalar distance test that it replaces,
+/// for 100, 1000 and 10000 targets scattered at random over a world a bit
+/// wider than the wrap distance, so that some pairs wrap. Both ways test
+/// the same points, and their hit masks are checked to be the same.
+/// \param queries Number of points to test against each set of targets.
+/// \param seed Random number seed.
+/// \return 0 if the hit masks match, 2 if not
+
+int TimeNarrowphase(int queries, unsigned long long seed){
+  const float fWorldWidth = 2048.0f; //wrap distance
+  const int nTargets[] = {100, 1000, 10000}; //number of targets in each test
+  CRandom random(seed);
+  CNarrowphase narrowphase;
+  vector<unsigned> batched, scalar; //hit masks
+  vector<float> x(queries), y(queries); //points to test
+  int result = 0;
+
+  printf("narrowphase:  %d queries per test, %d lanes\n", queries, CNarrowphase::GetLaneCount());
+
+  for(int n: nTargets){
+    narrowphase.clear();
+    for(int i=0; i<n; i++)
+      narrowphase.insert(random.number(0, 210000)/100.0f, random.number(0, 76800)/100.0f);
+    for(int i=0; i<queries; i++){
+      x[i] = random.number(0, 210000)/100.0f;
+      y[i] = random.number(0, 76800)/100.0f;
+    } //for
+
+    int batchedHits = 0, scalarHits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int i=0; i<queries; i++)
+      batchedHits += narrowphase.test(x[i], y[i], 25.0f, fWorldWidth, batched);
+    const double batchedTime = MicrosecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for(int i=0; i<queries; i++)
+      scalarHits += narrowphase.TestScalar(x[i], y[i], 25.0f, fWorldWidth, scalar);
+    const double scalarTime = MicrosecondsSince(start);
+
+    int mismatch = -1; //first point whose hit masks differ
+    for(int i=0; i<queries && mismatch<0; i++){
+      narrowphase.test(x[i], y[i], 25.0f, fWorldWidth, batched);
+      narrowphase.TestScalar(x[i], y[i], 25.0f, fWorldWidth, scalar);
+      if(batched != scalar)mismatch = i;
+    } //for
+
+    printf("%5d targets: batched %8.3f us, scalar %8.3f us per query, %.2f times as fast, %d hits",
+      n, batchedTime/queries, scalarTime/queries, batchedTime > 0? scalarTime/batchedTime: 0.0, batchedHits);
+    if(mismatch < 0 && batchedHits == scalarHits)printf("\n");
+    else{
+      printf(", point %d hits differ\n", mismatch);
+      result = 2;
+    } //else
+  } //for
+
+  return result;
+} //TimeNarrowphase
+
+/// Run the level for the number of ticks on the command line and print
+/// the throughput, recording, replaying, rewinding or playing several
+/// worlds if asked to, or time the narrowphase.
+/// \param argc Number of command line arguments
+/// \param argv Command line arguments
+/// \return 0 on success, 1 if the arguments are bad or the settings or
+///   recording cannot be loaded or saved, 2 if a replay, rewind or world
+///   does not match
+
+int main(int argc, char* argv[]){
+  const BOOL record = argc > 2 && strcmp(argv[1], "-record") == 0;
+  const BOOL replay = argc > 2 && strcmp(argv[1], "-replay") == 0;
+  const BOOL check = argc > 1 && strcmp(argv[1], "-rewind") == 0;
+  const BOOL worlds = argc > 1 && strcmp(argv[1], "-worlds") == 0;
+
+  if(argc > 1 && strcmp(argv[1], "-narrowphase") == 0){
+    const int queries = argc > 2? atoi(argv[2]): DEFAULT_QUERIES;
+    if(queries <= 0){
+      fprintf(stderr, "Usage: csf_headless -narrowphase [queries] [seed], with a positive number of queries.\n");
+      return 1;
+    } //if
+    return TimeNarrowphase(queries, argc > 3? strtoull(argv[3], nullptr, 10): DEFAULT_SEED);
+  } //if
+
+  const char* replayFileName = record || replay? argv[2]: nullptr;
+  const int arg = record || replay || worlds? 3: check? 2: 1; //first of the remaining arguments
+
+  CReplay recording;
+  if(replay && !recording.load(replayFileName)){
+    fprintf(stderr, "Cannot load recording from %s.\n", replayFileName);
+    return 1;
+  } //if
+
+  const int ticks = replay? recording.GetNumTicks():
+    argc > arg? atoi(argv[arg]): DEFAULT_TICKS;
+  const char* fileName = replay? (argc > arg? argv[arg]: "gamesettings.xml"):
+    argc > arg + 1? argv[arg + 1]: "gamesettings.xml";
+  const unsigned long long seed = replay? recording.GetSeed():
+    argc > arg + 2? strtoull(argv[arg + 2], nullptr, 10): DEFAULT_SEED;
+
+  if(!LoadSettings(fileName)){
+    fprintf(stderr, "Cannot load settings from %s.\n", fileName);
+    return 1;
+  } //if
+
+  if(worlds){
+    const int n = argc > 2? atoi(argv[2]): (int)std::thread::hardware_concurrency();
+    return PlayWorlds(n > 0? n: 1, ticks, seed);
+  } //if
+
+  CWorld world;
+  CObjectManager& objects = world.m_cObjectManager;
+  CTimer& timer = world.m_cTimer;
+
+  InitWorld(world, seed);
+  if(replay)
+    timer.microadvance(recording.GetStartTime() - timer.microtime());
+  if(record)
+    recording.StartRecording(seed, timer.microtime());
+  world.m_nGameState = GAMEOVER_GAMESTATE; //so that the player stats are reset
+  BeginLevel(world);
+
+  long long objectTicks = 0; //sum over ticks of the number of objects
+  int peak = 0; //most objects in any tick
+  int restarts = 0; //number of times the player ran out of lives
+  int mismatch = -1; //first tick that did not match the recording or the first run
+  unsigned expected = 0, actual = 0; //hashes of the mismatched tick
+  vector<INPUTEVENT> input; //keys pressed and released in a tick
+
+  const int checkTick = ticks/2; //tick that the rewind check goes back to
+  vector<unsigned> hashes(check? ticks: 0); //hash after each tick, for the rewind check
+  CSnapshot checkpoint; //snapshot for the rewind check
+  double saveTime = 0; //microseconds to take the snapshot
+
+  const auto start = std::chrono::steady_clock::now();
+
+  int tick = 0;
+  for(; tick<ticks; tick++){
+    if(world.m_nGameState != PLAYING_GAMESTATE){
+      BeginLevel(world);
+      restarts++;
+    } //if
+
+    objects.UpdateRewind();
+
+    if(check && tick == checkTick){
+      const auto t = std::chrono::steady_clock::now();
+      objects.SaveState(checkpoint);
+      saveTime = MicrosecondsSince(t);
+    } //if
+
+    if(replay){
+      long long time;
+      recording.NextTick(time, input, expected);
+      timer.microadvance(time - timer.microtime());
+    } //if
+    else{
+      ScriptedInput(tick, input);
+      timer.microadvance(TICK_TIME);
+    } //else
+
+    PlayTick(world, tick, input);
+
+    if(record || replay || check){
+      actual = objects.HashState();
+      if(record)
+        recording.RecordTick(timer.microtime(), input, actual);
+      else if(check)
+        hashes[tick] = actual;
+      else if(actual != expected){
+        mismatch = tick;
+        break;
+      } //else if
+    } //if
+
+    const int n = objects.GetObjectCount();
+    objectTicks += n;
+    if(n > peak)peak = n;
+  } //for
+
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf("ticks:        %d\n", tick);
+  printf("seconds:      %.3f\n", seconds);
+  printf("ticks/sec:    %.0f\n", seconds > 0? tick/seconds: 0.0);
+  printf("objects/tick: %.1f\n", tick > 0? (double)objectTicks/tick: 0.0);
+  printf("peak objects: %d\n", peak);
+  printf("restarts:     %d\n", restarts);
+  printf("object size:  %d bytes hot, %d bytes cold\n", (int)sizeof(CGameObject), (int)sizeof(OBJECTCOLD));
+
+  int result = 0;
+
+  if(record){
+    if(recording.save(replayFileName))
+      printf("recorded:     %s, seed %llu, final hash %08x\n", replayFileName, seed, actual);
+    else{
+      fprintf(stderr, "Cannot save recording to %s.\n", replayFileName);
+      result = 1;
+    } //else
+  } //if
+
+  else if(replay){
+    if(mismatch < 0)
+      printf("replay:       all %d ticks match, final hash %08x\n", ticks, actual);
+    else{
+      printf("replay:       tick %d does not match, hash %08x, recorded %08x\n", mismatch, actual, expected);
+      result = 2;
+    } //else
+  } //else if
+
+  else if(check && !checkpoint.empty()){
+    const auto t = std::chrono::steady_clock::now();
+    objects.RestoreState(checkpoint);
+    const double restoreTime = MicrosecondsSince(t);
+    world.m_nGameState = PLAYING_GAMESTATE; //as it was when the snapshot was taken
+
+    for(tick=checkTick; tick<ticks && mismatch<0; tick++){
+      if(world.m_nGameState != PLAYING_GAMESTATE)
+        BeginLevel(world);
+      ScriptedInput(tick, input);
+      timer.microadvance(TICK_TIME);
+      PlayTick(world, tick, input);
+
+      actual = objects.HashState();
+      if(actual != hashes[tick])
+        mismatch = tick;
+    } //for
+
+    printf("snapshot:     %d bytes, saved in %.1f us, restored in %.1f us\n",
+      (int)checkpoint.size(), saveTime, restoreTime);
+    if(mismatch < 0)
+      printf("rewind:       ticks %d to %d played again the same, final hash %08x\n", checkTick, ticks - 1, actual);
+    else{
+      printf("rewind:       tick %d played again differently, hash %08x, was %08x\n", mismatch, actual, hashes[mismatch]);
+      result = 2;
+    } //else
+  } //else if
+
+  objects.clear();
+  return result;
+} //main
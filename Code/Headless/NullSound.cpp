@@ -0,0 +1,39 @@
+/// \file NullSound.cpp
+/// \brief Code for the headless sound manager class CSoundManager.
+///
+/// The headless sound manager accepts every request and plays nothing.
+
+#include "Sound.h"
+
+CSoundManager::CSoundManager(){
+} //constructor
+
+CSoundManager::~CSoundManager(){
+} //destructor
+
+void CSoundManager::Load(){
+} //Load
+
+/// \return -1, since no instance is playing
+
+int CSoundManager::play(int index){
+  return -1;
+} //play
+
+/// \return -1, since no instance is playing
+
+int CSoundManager::loop(int index){
+  return -1;
+} //loop
+
+void CSoundManager::stop(int index){
+} //stop
+
+void CSoundManager::move(Vector3 ePos, int instance, int index){
+} //move
+
+void CSoundManager::pitch(float p, int instance, int index){
+} //pitch
+
+void CSoundManager::volume(float v, int instance, int index){
+} //volume
@@ -0,0 +1,31 @@
+/// \file NullSprite.cpp
+/// \brief Code for the headless sprite class C3DSprite.
+///
+/// A headless sprite knows how many frames it has, which is all that the
+/// game objects ask of it, and draws nothing.
+
+#include "Sprite.h"
+
+/// \param framecount Number of frames.
+
+C3DSprite::C3DSprite(int framecount){
+  m_nFrameCount = framecount;
+  m_nWidth = m_nHeight = 0;
+  m_bBottomOrigin = FALSE;
+} //constructor
+
+C3DSprite::~C3DSprite(){
+} //destructor
+
+/// There are no textures to load.
+/// \return TRUE
+
+BOOL C3DSprite::Load(char* filename, int frame){
+  return TRUE;
+} //Load
+
+void C3DSprite::Draw(Vector3 p, float angle, int frame, BOOL ghost){
+} //Draw
+
+void C3DSprite::Release(){
+} //Release
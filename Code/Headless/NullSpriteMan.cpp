@@ -0,0 +1,59 @@
+/// \file NullSpriteMan.cpp
+/// \brief Code for the headless sprite manager class CSpriteManager.
+///
+/// The headless sprite manager reads the same "sprite" tags as the real one
+/// but loads no images, it only makes sprites with the right frame counts.
+
+#include "SpriteMan.h"
+
+extern XMLElement* g_xmlSettings; //global XML settings
+
+CSpriteManager::CSpriteManager(){ //constructor
+  for(int i = 0; i<NUM_OBJECT_TYPES; i++)
+    m_pSprite[i] = nullptr;
+} //constructor
+
+CSpriteManager::~CSpriteManager(){ //destructor
+  for(int i = 0; i<NUM_OBJECT_TYPES; i++)
+    delete m_pSprite[i];
+} //destructor
+
+/// Make a sprite with a given number of frames.
+/// \param object Object type
+/// \param file File name prefix, unused
+/// \param ext File name extension, unused
+/// \param frames Number of frames
+/// \return The sprite
+
+C3DSprite* CSpriteManager::Load(ObjectType object,
+  const char* file, const char* ext, int frames)
+{
+  delete m_pSprite[object];
+  m_pSprite[object] = new C3DSprite(frames);
+  return m_pSprite[object];
+} //Load
+
+/// Get the number of frames from the "sprite" tag with the right name in
+/// g_xmlSettings and make a sprite with that many frames.
+/// \param object Object type
+/// \param name Object name in XML file
+
+void CSpriteManager::Load(ObjectType object, char* name){
+  if(g_xmlSettings == nullptr)return;
+  XMLElement* spriteSettings = g_xmlSettings->FirstChildElement("sprites"); //sprites tag
+  if(spriteSettings == nullptr)return;
+
+  XMLElement* spr = spriteSettings->FirstChildElement("sprite"); //sprite element
+  while(spr && strcmp(name, spr->Attribute("name")))
+    spr = spr->NextSiblingElement("sprite");
+
+  C3DSprite* sprite = Load(object, nullptr, nullptr, spr? spr->IntAttribute("frames"): 1);
+  if(spr)sprite->m_bBottomOrigin = spr->BoolAttribute("bottomorigin");
+} //Load
+
+C3DSprite* CSpriteManager::GetSprite(ObjectType object){
+  return m_pSprite[object];
+} //GetSprite
+
+void CSpriteManager::Release(){
+} //Release
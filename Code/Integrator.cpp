@@ -0,0 +1,136 @@
+/// \file Integrator.cpp
+/// \brief Code for the batch motion integrator class CIntegrator.
+
+#include <stddef.h>
+#include <string.h>
+
+#include "Integrator.h"
+
+#if !defined(NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+  #define INTEGRATOR_SSE2 ///< Integrate four rows at a time.
+  #include <emmintrin.h>
+#endif
+
+//the SSE2 path loads each transform and velocity as one register of four floats
+static_assert(sizeof(TRANSFORM) == 16 && offsetof(TRANSFORM, m_fOrientation) == 12,
+  "the integrator loads a TRANSFORM as x, y, z and orientation");
+static_assert(offsetof(VELOCITY, m_vVelocity) == 0 && offsetof(VELOCITY, m_fSpin) == 12,
+  "the integrator loads a VELOCITY as x, y, z and spin");
+
+const float MOTION_SCALE = 32.0f; ///< Milliseconds for an object to move by its velocity.
+
+CIntegrator::CIntegrator(){
+  m_nTime = 0;
+  m_sBounds = ARENABOUNDS();
+} //constructor
+
+/// Set the time to move the entities up to, and the edges of the arena, for
+/// the chunks integrated this frame.
+/// \param time Current time in microseconds.
+/// \param bounds Edges of the arena.
+
+void CIntegrator::SetFrame(long long time, const ARENABOUNDS& bounds){
+  m_nTime = time;
+  m_sBounds = bounds;
+} //SetFrame
+
+const ARENABOUNDS& CIntegrator::GetBounds(){
+  return m_sBounds;
+} //GetBounds
+
+/// Integrate one row of a chunk. The distance moved depends on the speed and
+/// the time since the entity last moved, and the spin is per frame. Where it
+/// was before is kept for continuous collision detection.
+/// \param c Chunk.
+/// \param i Row.
+
+void CIntegrator::IntegrateRow(ENTITYCHUNK& c, int i){
+  TRANSFORM& t = c.m_pTransform[i];
+  VELOCITY& v = c.m_pVelocity[i];
+  const float tdelta = (float)(m_nTime - v.m_nLastMoveTime)/1000.0f; //ms since last move, with the fraction
+  const float tfactor = tdelta/MOTION_SCALE; //scaled time factor
+  c.m_fLastX[i] = t.m_vPos.x;
+  c.m_fLastY[i] = t.m_vPos.y;
+  t.m_vPos.x += v.m_vVelocity.x*tfactor;
+  t.m_vPos.y += v.m_vVelocity.y*tfactor;
+  t.m_fOrientation += v.m_fSpin;
+  v.m_nLastMoveTime = m_nTime;
+
+  c.m_nHit[i] = (t.m_vPos.x <= m_sBounds.m_fLeft? LEFT_HIT: 0) |
+    (t.m_vPos.x > m_sBounds.m_fRight? RIGHT_HIT: 0) |
+    (t.m_vPos.y <= m_sBounds.m_fBottom? BOTTOM_HIT: 0) |
+    (t.m_vPos.y >= m_sBounds.m_fTop? TOP_HIT: 0);
+} //IntegrateRow
+
+/// Integrate every row of a chunk that has transforms and velocities. With
+/// SSE2, four transforms and four velocities are loaded and transposed so
+/// that each register holds one field of four rows, moved and tested in
+/// one go, and transposed back. The rows left over are done one at a time.
+/// \param c Chunk.
+
+void CIntegrator::integrate(ENTITYCHUNK& c){
+  int i = 0;
+
+#ifdef INTEGRATOR_SSE2
+  const __m128 left = _mm_set1_ps(m_sBounds.m_fLeft);
+  const __m128 right = _mm_set1_ps(m_sBounds.m_fRight);
+  const __m128 bottom = _mm_set1_ps(m_sBounds.m_fBottom);
+  const __m128 top = _mm_set1_ps(m_sBounds.m_fTop);
+  const __m128 thousand = _mm_set1_ps(1000.0f);
+  const __m128 scale = _mm_set1_ps(MOTION_SCALE);
+
+  for(; i+4<=c.m_nCount; i+=4){
+    TRANSFORM* t = c.m_pTransform + i;
+    VELOCITY* v = c.m_pVelocity + i;
+
+    //x, y, z and orientation of 4 rows
+    __m128 x = _mm_loadu_ps(&t[0].m_vPos.x);
+    __m128 y = _mm_loadu_ps(&t[1].m_vPos.x);
+    __m128 z = _mm_loadu_ps(&t[2].m_vPos.x);
+    __m128 o = _mm_loadu_ps(&t[3].m_vPos.x);
+    _MM_TRANSPOSE4_PS(x, y, z, o);
+
+    //velocity and spin of 4 rows
+    __m128 vx = _mm_loadu_ps(&v[0].m_vVelocity.x);
+    __m128 vy = _mm_loadu_ps(&v[1].m_vVelocity.x);
+    __m128 vz = _mm_loadu_ps(&v[2].m_vVelocity.x);
+    __m128 spin = _mm_loadu_ps(&v[3].m_vVelocity.x);
+    _MM_TRANSPOSE4_PS(vx, vy, vz, spin);
+
+    const __m128 tdelta = _mm_div_ps(_mm_set_ps(
+      (float)(m_nTime - v[3].m_nLastMoveTime), (float)(m_nTime - v[2].m_nLastMoveTime),
+      (float)(m_nTime - v[1].m_nLastMoveTime), (float)(m_nTime - v[0].m_nLastMoveTime)), thousand);
+    const __m128 tfactor = _mm_div_ps(tdelta, scale);
+    _mm_storeu_ps(&c.m_fLastX[i], x);
+    _mm_storeu_ps(&c.m_fLastY[i], y);
+    x = _mm_add_ps(x, _mm_mul_ps(vx, tfactor));
+    y = _mm_add_ps(y, _mm_mul_ps(vy, tfactor));
+    o = _mm_add_ps(o, spin);
+
+    //edge hits, one byte per row
+    __m128i hit = _mm_or_si128(
+      _mm_or_si128(
+        _mm_and_si128(_mm_castps_si128(_mm_cmple_ps(x, left)), _mm_set1_epi32(LEFT_HIT)),
+        _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(x, right)), _mm_set1_epi32(RIGHT_HIT))),
+      _mm_or_si128(
+        _mm_and_si128(_mm_castps_si128(_mm_cmple_ps(y, bottom)), _mm_set1_epi32(BOTTOM_HIT)),
+        _mm_and_si128(_mm_castps_si128(_mm_cmpge_ps(y, top)), _mm_set1_epi32(TOP_HIT))));
+    hit = _mm_packs_epi32(hit, hit);
+    hit = _mm_packus_epi16(hit, hit);
+    const int hits = _mm_cvtsi128_si32(hit);
+    memcpy(&c.m_nHit[i], &hits, 4);
+
+    _MM_TRANSPOSE4_PS(x, y, z, o);
+    _mm_storeu_ps(&t[0].m_vPos.x, x);
+    _mm_storeu_ps(&t[1].m_vPos.x, y);
+    _mm_storeu_ps(&t[2].m_vPos.x, z);
+    _mm_storeu_ps(&t[3].m_vPos.x, o);
+
+    for(int j=0; j<4; j++)
+      v[j].m_nLastMoveTime = m_nTime;
+  } //for
+#endif
+
+  for(; i<c.m_nCount; i++)
+    IntegrateRow(c, i);
+} //integrate
@@ -0,0 +1,51 @@
+/// \file Integrator.h
+/// \brief Interface for the batch motion integrator class CIntegrator.
+
+#pragma once
+
+#include "EntityStore.h"
+
+/// \brief Edges of the arena.
+///
+/// Where walled objects are stopped, worked out once a frame from the
+/// screen scroll instead of by every object.
+
+struct ARENABOUNDS{
+  float m_fLeft; ///< Left edge, objects at or left of it have hit it.
+  float m_fRight; ///< Right edge, objects right of it have hit it.
+  float m_fBottom; ///< Bottom edge, objects at or below it have hit it.
+  float m_fTop; ///< Top edge, objects at or above it have hit it.
+}; //ARENABOUNDS
+
+/// \brief Edge hits.
+///
+/// Each edge of the arena is one bit of the hit mask that the integrator
+/// leaves in ENTITYCHUNK::m_nHit for each row.
+
+const unsigned char LEFT_HIT   = 1 << 0; ///< At or past the left edge.
+const unsigned char RIGHT_HIT  = 1 << 1; ///< Past the right edge.
+const unsigned char BOTTOM_HIT = 1 << 2; ///< At or past the bottom edge.
+const unsigned char TOP_HIT    = 1 << 3; ///< At or past the top edge.
+
+/// \brief The integrator.
+///
+/// Moves the entities of a chunk along their velocities, spins them, and
+/// notes where each one was before and which edges of the arena it is now
+/// past, four rows at a time with SSE2 where the compiler has it and one at
+/// a time otherwise. Both ways do the same float operations in the same
+/// order, so they give the same results to the bit.
+
+class CIntegrator{
+  private:
+    long long m_nTime; ///< Time of this frame, in microseconds.
+    ARENABOUNDS m_sBounds; ///< Edges of the arena this frame.
+
+    void IntegrateRow(ENTITYCHUNK& c, int i); ///< Integrate one row.
+
+  public:
+    CIntegrator(); ///< Constructor.
+
+    void SetFrame(long long time, const ARENABOUNDS& bounds); ///< Set the time and edges for this frame.
+    const ARENABOUNDS& GetBounds(); ///< Get the edges for this frame.
+    void integrate(ENTITYCHUNK& c); ///< Integrate the rows of a chunk.
+}; //CIntegrator
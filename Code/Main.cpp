@@ -16,21 +16,34 @@
 #include "objman.h"
 #include "Random.h"
 #include "sound.h"
+#include "World.h"
+
+//the game world, and the names that the front end knows its parts by
+CWorld g_cWorld; ///< The game world.
+GameStateType& g_nGameState = g_cWorld.m_nGameState; ///< game states to be used for menus/gameplay/etc.
+LevelStateType& g_nLevelState = g_cWorld.m_nLevelState; ///< tells the game what stage the player is currently in
+CTimer& g_cTimer = g_cWorld.m_cTimer; ///< The game timer.
+CObjectManager& g_cObjectManager = g_cWorld.m_cObjectManager; ///< The object manager.
+CRandom& g_cRandom = g_cWorld.m_cRandom; ///< The random number generator.
+CSoundManager*& g_pSoundManager = g_cWorld.m_pSoundManager; ///< The sound manager.
+BOOL& g_bShieldActive = g_cWorld.m_bShieldActive; ///< Tell when shield is activated
+BOOL& g_bAssistActive = g_cWorld.m_bAssistActive; ///< Tell when assist is activated
+BOOL& g_bSpecialActivate = g_cWorld.m_bSpecialActivate; ///< Used to tell if player is able to activate special attack
+BOOL& g_bPlayerIsInvulnerable = g_cWorld.m_bPlayerIsInvulnerable; ///< TRUE if player is invulnerable to collisions.
+float& g_fScreenScroll = g_cWorld.m_fScreenScroll; ///< Finds the current screen scroll value
+CGameObject*& player = g_cWorld.m_pPlayer; ///< Pointer used to keep track of player
+int& m_nEnemyCount = g_cWorld.m_nEnemyCount; ///< Number of enemies on screen.
 
 //globals
-GameStateType g_nGameState; ///< game states to be used for menus/gameplay/etc.
-LevelStateType g_nLevelState; ///< tells the game what stage the player is currently in
 BOOL g_bActiveApp;  ///< TRUE if this is the active application
 HWND g_HwndApp; ///< Application window handle.
 HINSTANCE g_hInstance; ///< Application instance handle.
 char g_szGameName[256]; ///< Name of this game.
 char g_szShaderModel[256]; ///< The shader model version used.
 CImageFileNameList g_cImageFileName; ///< List of image file names.
-CTimer g_cTimer; ///< The game timer.
 CSpriteManager g_cSpriteManager; ///< The sprite manager.
-CObjectManager g_cObjectManager; ///< The object manager.
-CRandom g_cRandom; ///< The random number generator.
-CSoundManager* g_pSoundManager; ///< The sound manager.
+CObjectSettings g_cObjectSettings; ///< Settings for each kind of object.
+CAnimationStore g_cAnimationStore; ///< Animation sequences of all objects.
 
 //graphics settings
 int g_nScreenWidth; ///< Screen width.
@@ -39,14 +52,8 @@ BOOL g_bWireFrame = FALSE; ///< TRUE for wireframe rendering.
 ShaderType g_nPixelShader = NULL_SHADER; ///< Pixel shader in use.
 
 BOOL g_bDarkenScreen = FALSE; ///< If the screen is darkened, AKA shift is held down when player has all letters
-BOOL g_bShieldActive = FALSE; ///< Tell when shield is activated
-BOOL g_bAssistActive = FALSE; ///< Tell when assist is activated
 BOOL g_bPlayerTyped[4]; ///< Checks if each subsequent letter in a special attack is typed
 BOOL g_bSpecialAttackReleased = FALSE; ///< Used to check if special attack has been used
-BOOL g_bSpecialActivate = FALSE; ///< Used to tell if player is able to activate special attack
-float g_fScreenScroll = g_nScreenWidth / 2.0f; ///< Finds the current screen scroll value
-CGameObject* player; ///< Pointer used to keep track of player
-BOOL g_bPlayerIsInvulnerable = FALSE; ///< TRUE if player is invulnerable to collisions.
 
 int cursorPos = 0; ///< Current position on the menu for cursor menus.
 int cursorPosMax = 4; ///< Maximum number of menu spaces that can be moved on a menu.
@@ -115,9 +122,29 @@ void LoadGameSettings(){
     strncpy_s(g_szShaderModel, len + 1, renderSettings->Attribute("shadermodel"), len);
   } //if
 
+  //get collision settings
+  XMLElement* collisionSettings =
+    g_xmlSettings->FirstChildElement("collision"); //collision tag
+  if(collisionSettings){ //read collision tag attributes
+    g_cObjectManager.SetBroadphase(collisionSettings->BoolAttribute("broadphase"),
+      collisionSettings->FloatAttribute("cellsize"));
+    g_cObjectManager.SetSwept(collisionSettings->BoolAttribute("swept"));
+    g_cObjectManager.SetNarrowphase(collisionSettings->BoolAttribute("narrowphase"));
+  } //if
+
+  //get rewind settings
+  XMLElement* rewindSettings =
+    g_xmlSettings->FirstChildElement("rewind"); //rewind tag
+  if(rewindSettings) //read rewind tag attributes
+    g_cObjectManager.SetRewind(rewindSettings->IntAttribute("snapshots"),
+      rewindSettings->IntAttribute("interval"));
+
   //get image file names
   g_cImageFileName.GetImageFileNames(g_xmlSettings);
 
+  //compile object settings
+  g_cObjectSettings.load(g_xmlSettings);
+
   //get debug settings
   #ifdef DEBUG_ON
     g_cDebugManager.GetDebugSettings(g_xmlSettings);
@@ -146,20 +173,30 @@ void InitGame() {
 	g_pSoundManager = new CSoundManager();
 	g_pSoundManager->Load(); //load game sounds
 	g_pSoundManager->loop(ORGANDONOR_SOUND);
+
+	//everything has been read from the settings file by now
+	g_xmlSettings = nullptr;
+	g_xmlDocument.Clear();
 } //InitGame
 
 ///Starts the music for the respective level and creates the object
 ///Also resets basic stats like health and score
+///After a game over the same level is played again, so it is restored
+///from the snapshot taken when it began instead of being created again
 
 void BeginGame() {
+	const BOOL restart = g_nGameState == GAMEOVER_GAMESTATE && g_cObjectManager.RestartLevel();
 	g_cObjectManager.ResetPlayerStats();
 	g_nGameState = PLAYING_GAMESTATE;
 	if(g_nLevelState == COMICWORLD_STATE) g_pSoundManager->loop(UNLEASH_SOUND);
 	else if (g_nLevelState == FANTASY_STATE) g_pSoundManager->loop(MOOSEHEADHONK_SOUND);
 	else if (g_nLevelState == CITY_STATE) g_pSoundManager->loop(HUBBUB_SOUND);
+	if(restart)return;
 	g_cTimer.StartLevelTimer();
 	g_cObjectManager.clear();
+	g_cObjectManager.PrewarmPools();
 	CreateObjects();
+	g_cObjectManager.SaveLevelStart();
 } //BeginGame
 
 /// \brief Create game objects. 
@@ -267,6 +304,7 @@ void CreateObjects(){
 
 BOOL KeyboardHandler(WPARAM keystroke){
 	int *ammoCount = g_cObjectManager.getAmmoCount();
+	const ObjectType playerType = g_cObjectManager.GetPlayerType();
 	switch (keystroke) {
 	case VK_ESCAPE: //exit game
 		return TRUE; //exit keyboard handler
@@ -274,8 +312,7 @@ BOOL KeyboardHandler(WPARAM keystroke){
 
 	case VK_UP:
 		if(g_nGameState == PLAYING_GAMESTATE){	//When in the playing state, this is used to move the player
-			if(player)
-				player->m_vVelocity.y = 5.0f * g_cObjectManager.getPlayerSpeed();
+			g_cObjectManager.MovePlayer(UP_DIRECTION);
 		}
 		else if(g_nGameState == MENU_GAMESTATE || g_nGameState == CHARSELECT_GAMESTATE){	//When in a menu state, this is used to move menu
 			if(cursorPos == 0)
@@ -289,8 +326,7 @@ BOOL KeyboardHandler(WPARAM keystroke){
 	//when in playing state, this moves the player. otherwise, it moves the menu
 	case VK_DOWN:
 		if(g_nGameState == PLAYING_GAMESTATE){
-			if(player)
-				player->m_vVelocity.y = -5.0f * g_cObjectManager.getPlayerSpeed();
+			g_cObjectManager.MovePlayer(DOWN_DIRECTION);
 		}
 		else if(g_nGameState == MENU_GAMESTATE || g_nGameState == CHARSELECT_GAMESTATE){
 			if(cursorPos == cursorPosMax)
@@ -304,8 +340,7 @@ BOOL KeyboardHandler(WPARAM keystroke){
 	//when in playing state, this moves the player. otherwise, it moves the menu
 	case VK_LEFT:
 		if(g_nGameState == PLAYING_GAMESTATE){
-			if(player)
-				player->m_vVelocity.x = -5.0f * g_cObjectManager.getPlayerSpeed();
+			g_cObjectManager.MovePlayer(LEFT_DIRECTION);
 		}
 		else if(g_nGameState == MENU_GAMESTATE || g_nGameState == CHARSELECT_GAMESTATE){
 			if(cursorPos == 0)
@@ -319,8 +354,7 @@ BOOL KeyboardHandler(WPARAM keystroke){
 	//when in playing state, this moves the player. otherwise, it moves the menu
 	case VK_RIGHT:
 		if(g_nGameState == PLAYING_GAMESTATE){
-			if(player)
-				player->m_vVelocity.x = 6.0f * g_cObjectManager.getPlayerSpeed();
+			g_cObjectManager.MovePlayer(RIGHT_DIRECTION);
 		}
 		else if(g_nGameState == MENU_GAMESTATE || g_nGameState == CHARSELECT_GAMESTATE){
 			if(cursorPos == cursorPosMax)
@@ -339,204 +373,164 @@ BOOL KeyboardHandler(WPARAM keystroke){
 	//fires shot if player is fred, also used for special attack
 	case 'F':
 		if(g_nGameState == PLAYING_GAMESTATE){
-			if (!g_bDarkenScreen && g_nGameState == PLAYING_GAMESTATE && (player->m_nObjectType == FREDIDLE_OBJECT || player->m_nObjectType == FREDATTACK_OBJECT)) {
-				player->kill();
-				g_cObjectManager.DeleteNameToObject();
-				player = g_cObjectManager.createObject(FREDATTACK_OBJECT, "fredAttack", player->m_vPos, player->m_vVelocity);
-				g_cObjectManager.FireGun();
-			}
-			else if (g_bDarkenScreen && g_nGameState == PLAYING_GAMESTATE && player->m_nObjectType != FREDHURT_OBJECT) {
+			if (!g_bDarkenScreen)
+				g_cObjectManager.FireAs(FREDIDLE_OBJECT, FREDATTACK_OBJECT, "fredAttack");
+			else if (playerType != FREDHURT_OBJECT) {
 				g_bPlayerTyped[0] = TRUE;
 			}
-			g_cObjectManager.GarbageCollect();
 		}
 		break;
 
 	//activates shield if player is fred, also used for special attack
 	case 'R':
 		if(g_nGameState == PLAYING_GAMESTATE){
-			if (g_bDarkenScreen && (player->m_nObjectType == FREDIDLE_OBJECT || player->m_nObjectType == FREDATTACK_OBJECT)) {
+			if (g_bDarkenScreen && (playerType == FREDIDLE_OBJECT || playerType == FREDATTACK_OBJECT)) {
 				g_bPlayerTyped[1] = TRUE;
 			}
-			if (!g_bDarkenScreen && ammoCount[0] > 0 && g_bShieldActive == FALSE && (player->m_nObjectType == FREDIDLE_OBJECT || player->m_nObjectType == FREDATTACK_OBJECT)) {
+			if (!g_bDarkenScreen && ammoCount[0] > 0 && g_bShieldActive == FALSE && (playerType == FREDIDLE_OBJECT || playerType == FREDATTACK_OBJECT)) {
 				g_bShieldActive = true;
-				player->kill();
-				g_cObjectManager.DeleteNameToObject();
-				player = g_cObjectManager.createObject(FREDATTACK_OBJECT, "fredAttack", player->m_vPos, player->m_vVelocity);
+				g_cObjectManager.PlayerAttack(FREDATTACK_OBJECT, "fredAttack");
 				g_cObjectManager.CreateShield();
 			}
-			g_cObjectManager.GarbageCollect();
 		}
 		break;
 
 	//activate assist if player is fred, also used for special attack
 	case 'E':
 		if(g_nGameState == PLAYING_GAMESTATE){
-			if (g_bDarkenScreen && (player->m_nObjectType == FREDIDLE_OBJECT || player->m_nObjectType == FREDATTACK_OBJECT)) {
+			if (g_bDarkenScreen && (playerType == FREDIDLE_OBJECT || playerType == FREDATTACK_OBJECT)) {
 				g_bPlayerTyped[2] = TRUE;
 			}
-			if (!g_bDarkenScreen && ammoCount[1] > 0 && g_bAssistActive == FALSE && (player->m_nObjectType == FREDIDLE_OBJECT)) {
+			if (!g_bDarkenScreen && ammoCount[1] > 0 && g_bAssistActive == FALSE && (playerType == FREDIDLE_OBJECT)) {
 				g_bAssistActive = true;
-				player->kill();
-				g_cObjectManager.DeleteNameToObject();
-				player = g_cObjectManager.createObject(FREDATTACK_OBJECT, "fredAttack", player->m_vPos, player->m_vVelocity);
+				g_cObjectManager.PlayerAttack(FREDATTACK_OBJECT, "fredAttack");
 				g_cObjectManager.CreateAssist();
 			}
-			g_cObjectManager.GarbageCollect();
 		}
 		break;
 
 	//fires pierce shot if player is fred, also used for special attack
 	case 'D':
 		if(g_nGameState == PLAYING_GAMESTATE){
-			if (g_bDarkenScreen && (player->m_nObjectType == FREDIDLE_OBJECT || player->m_nObjectType == FREDATTACK_OBJECT)) {
+			if (g_bDarkenScreen && (playerType == FREDIDLE_OBJECT || playerType == FREDATTACK_OBJECT)) {
 				g_bPlayerTyped[3] = TRUE;
 			}
-			if (!g_bDarkenScreen && ammoCount[2] > 0 && (player->m_nObjectType == FREDIDLE_OBJECT)) {
-				player->kill();
-				g_cObjectManager.DeleteNameToObject();
-				player = g_cObjectManager.createObject(FREDATTACK_OBJECT, "fredAttack", player->m_vPos, player->m_vVelocity);
+			if (!g_bDarkenScreen && ammoCount[2] > 0 && (playerType == FREDIDLE_OBJECT)) {
+				g_cObjectManager.PlayerAttack(FREDATTACK_OBJECT, "fredAttack");
 				g_cObjectManager.FirePierce();
 			}
-			g_cObjectManager.GarbageCollect();
 		}
 		break;
 
 	//fires shot if player is swaz, also used for special attack
 	case 'S':
 		if(g_nGameState == PLAYING_GAMESTATE){
-			if (!g_bDarkenScreen && g_nGameState == PLAYING_GAMESTATE && (player->m_nObjectType == SWAZIDLE_OBJECT || player->m_nObjectType == SWAZATTACK_OBJECT)) {
-				player->kill();
-				g_cObjectManager.DeleteNameToObject();
-				player = g_cObjectManager.createObject(SWAZATTACK_OBJECT, "swazAttack", player->m_vPos, player->m_vVelocity);
-				g_cObjectManager.FireGun();
-			}
-			else if (g_bDarkenScreen && g_nGameState == PLAYING_GAMESTATE && player->m_nObjectType != SWAZHURT_OBJECT) {
+			if (!g_bDarkenScreen)
+				g_cObjectManager.FireAs(SWAZIDLE_OBJECT, SWAZATTACK_OBJECT, "swazAttack");
+			else if (playerType != SWAZHURT_OBJECT) {
 				g_bPlayerTyped[0] = TRUE;
 			}
-			g_cObjectManager.GarbageCollect();
 		}
 		break;
 
 	//activates shield if player is swaz, also used for special attack
 	case 'W':
 		if(g_nGameState == PLAYING_GAMESTATE){
-			if (g_bDarkenScreen && player->m_nObjectType == SWAZIDLE_OBJECT || player->m_nObjectType == SWAZATTACK_OBJECT) {
+			if (g_bDarkenScreen && playerType == SWAZIDLE_OBJECT || playerType == SWAZATTACK_OBJECT) {
 				g_bPlayerTyped[1] = TRUE;
 			}
-			if (!g_bDarkenScreen && ammoCount[0] > 0 && g_bShieldActive == FALSE && (player->m_nObjectType == SWAZIDLE_OBJECT)) {
+			if (!g_bDarkenScreen && ammoCount[0] > 0 && g_bShieldActive == FALSE && (playerType == SWAZIDLE_OBJECT)) {
 				g_bShieldActive = true;
-				player->kill();
-				g_cObjectManager.DeleteNameToObject();
-				player = g_cObjectManager.createObject(SWAZATTACK_OBJECT, "swazAttack", player->m_vPos, player->m_vVelocity);
+				g_cObjectManager.PlayerAttack(SWAZATTACK_OBJECT, "swazAttack");
 				g_cObjectManager.CreateShield();
 			}
-			g_cObjectManager.GarbageCollect();
 		}
 		break;
 
 	//activates assist if player is swaz, also used for special attack
 	case 'A':
 		if(g_nGameState == PLAYING_GAMESTATE){
-			if (g_bDarkenScreen && player->m_nObjectType == SWAZIDLE_OBJECT || player->m_nObjectType == SWAZATTACK_OBJECT) {
+			if (g_bDarkenScreen && playerType == SWAZIDLE_OBJECT || playerType == SWAZATTACK_OBJECT) {
 				g_bPlayerTyped[2] = TRUE;
 			}
-			if (!g_bDarkenScreen && ammoCount[1] > 0 && g_bAssistActive == FALSE && (player->m_nObjectType == SWAZIDLE_OBJECT)) {
+			if (!g_bDarkenScreen && ammoCount[1] > 0 && g_bAssistActive == FALSE && (playerType == SWAZIDLE_OBJECT)) {
 				g_bAssistActive = true;
-				player->kill();
-				g_cObjectManager.DeleteNameToObject();
-				player = g_cObjectManager.createObject(SWAZATTACK_OBJECT, "swazAttack", player->m_vPos, player->m_vVelocity);
+				g_cObjectManager.PlayerAttack(SWAZATTACK_OBJECT, "swazAttack");
 				g_cObjectManager.CreateAssist();
 			}
-			g_cObjectManager.GarbageCollect();
 		}
 		break;
 
 	//fires pierce shot if player is swaz, also used for special attack
 	case 'Z':
 		if(g_nGameState == PLAYING_GAMESTATE){
-			if (g_bDarkenScreen && player->m_nObjectType == SWAZIDLE_OBJECT || player->m_nObjectType == SWAZATTACK_OBJECT) {
+			if (g_bDarkenScreen && playerType == SWAZIDLE_OBJECT || playerType == SWAZATTACK_OBJECT) {
 				g_bPlayerTyped[3] = TRUE;
 			}
-			if (!g_bDarkenScreen && ammoCount[2] > 0 && (player->m_nObjectType == SWAZIDLE_OBJECT)) {
-				player->kill();
-				g_cObjectManager.DeleteNameToObject();
-				player = g_cObjectManager.createObject(SWAZATTACK_OBJECT, "swazAttack", player->m_vPos, player->m_vVelocity);
+			if (!g_bDarkenScreen && ammoCount[2] > 0 && (playerType == SWAZIDLE_OBJECT)) {
+				g_cObjectManager.PlayerAttack(SWAZATTACK_OBJECT, "swazAttack");
 				g_cObjectManager.FirePierce();
 			}
-			g_cObjectManager.GarbageCollect();
 		}
 		break;
 
 	//fires shot if player is polk, also used for special attack
 	case 'P':
 		if (g_nGameState == PLAYING_GAMESTATE) {
-			if (!g_bDarkenScreen && g_nGameState == PLAYING_GAMESTATE && (player->m_nObjectType == POLKIDLE_OBJECT || player->m_nObjectType == POLKATTACK_OBJECT)) {
-				player->kill();
-				g_cObjectManager.DeleteNameToObject();
-				player = g_cObjectManager.createObject(POLKATTACK_OBJECT, "polkAttack", player->m_vPos, player->m_vVelocity);
-				g_cObjectManager.FireGun();
-			}
-			else if (g_bDarkenScreen && g_nGameState == PLAYING_GAMESTATE && player->m_nObjectType != POLKHURT_OBJECT) {
+			if (!g_bDarkenScreen)
+				g_cObjectManager.FireAs(POLKIDLE_OBJECT, POLKATTACK_OBJECT, "polkAttack");
+			else if (playerType != POLKHURT_OBJECT) {
 				g_bPlayerTyped[0] = TRUE;
 			}
-			g_cObjectManager.GarbageCollect();
 		}
 		break;
 
 	//activates shield if player is polk, also used for special attack
 	case 'O':
 		if(g_nGameState == PLAYING_GAMESTATE){
-			if (g_bDarkenScreen && player->m_nObjectType == POLKIDLE_OBJECT || player->m_nObjectType == POLKATTACK_OBJECT) {
+			if (g_bDarkenScreen && playerType == POLKIDLE_OBJECT || playerType == POLKATTACK_OBJECT) {
 				g_bPlayerTyped[1] = TRUE;
 			}
-			if (!g_bDarkenScreen && ammoCount[0] > 0 && g_bShieldActive == FALSE && (player->m_nObjectType == POLKIDLE_OBJECT)) {
+			if (!g_bDarkenScreen && ammoCount[0] > 0 && g_bShieldActive == FALSE && (playerType == POLKIDLE_OBJECT)) {
 				g_bShieldActive = true;
-				player->kill();
-				g_cObjectManager.DeleteNameToObject();
-				player = g_cObjectManager.createObject(POLKATTACK_OBJECT, "polkAttack", player->m_vPos, player->m_vVelocity);
+				g_cObjectManager.PlayerAttack(POLKATTACK_OBJECT, "polkAttack");
 				g_cObjectManager.CreateShield();
 			}
-			g_cObjectManager.GarbageCollect();
 		}
 		break;
 
 	//activates assist if player is polk, also used for special attack
 	case 'L':
 		if(g_nGameState == PLAYING_GAMESTATE){
-			if (g_bDarkenScreen && player->m_nObjectType == POLKIDLE_OBJECT || player->m_nObjectType == POLKATTACK_OBJECT) {
+			if (g_bDarkenScreen && playerType == POLKIDLE_OBJECT || playerType == POLKATTACK_OBJECT) {
 				g_bPlayerTyped[2] = TRUE;
 			}
-			if (!g_bDarkenScreen && ammoCount[1] > 0 && g_bAssistActive == FALSE && (player->m_nObjectType == POLKIDLE_OBJECT)) {
+			if (!g_bDarkenScreen && ammoCount[1] > 0 && g_bAssistActive == FALSE && (playerType == POLKIDLE_OBJECT)) {
 				g_bAssistActive = true;
-				player->kill();
-				g_cObjectManager.DeleteNameToObject();
-				player = g_cObjectManager.createObject(POLKATTACK_OBJECT, "polkAttack", player->m_vPos, player->m_vVelocity);
+				g_cObjectManager.PlayerAttack(POLKATTACK_OBJECT, "polkAttack");
 				g_cObjectManager.CreateAssist();
 			}
-			g_cObjectManager.GarbageCollect();
 		}
 		break;
 
 	//fires pierce shot if player is polk, also used for special attack
 	case 'K':
 		if(g_nGameState == PLAYING_GAMESTATE){
-			if (g_bDarkenScreen && player->m_nObjectType == POLKIDLE_OBJECT || player->m_nObjectType == POLKATTACK_OBJECT) {
+			if (g_bDarkenScreen && playerType == POLKIDLE_OBJECT || playerType == POLKATTACK_OBJECT) {
 				g_bPlayerTyped[3] = TRUE;
 			}
-			if (!g_bDarkenScreen && ammoCount[2] > 0 && (player->m_nObjectType == POLKIDLE_OBJECT)) {
-				player->kill();
-				g_cObjectManager.DeleteNameToObject();
-				player = g_cObjectManager.createObject(POLKATTACK_OBJECT, "polkAttack", player->m_vPos, player->m_vVelocity);
+			if (!g_bDarkenScreen && ammoCount[2] > 0 && (playerType == POLKIDLE_OBJECT)) {
+				g_cObjectManager.PlayerAttack(POLKATTACK_OBJECT, "polkAttack");
 				g_cObjectManager.FirePierce();
 			}
-			g_cObjectManager.GarbageCollect();
 		}
 		break;
 
-	//return to main menu
+	//return to main menu; during play, go back a little in time
 	case VK_BACK:
-		if(g_nGameState == CHARSELECT_GAMESTATE){
+		if(g_nGameState == PLAYING_GAMESTATE)
+			g_cObjectManager.rewind(1);
+		else if(g_nGameState == CHARSELECT_GAMESTATE){
 			g_pSoundManager->play(MENUSELECT_SOUND);
 			g_nGameState = MENU_GAMESTATE;
 			cursorPosMax = 3;
@@ -655,20 +649,16 @@ BOOL KeyboardHandler(WPARAM keystroke){
 BOOL KeyboardHandlerReleased(WPARAM keystroke){
 	switch(keystroke) {
 		case VK_UP:
-			if (player && player->m_vVelocity.y > 0)
-				player->m_vVelocity.y = 0;
+			g_cObjectManager.StopPlayer(UP_DIRECTION);
 			break;
 		case VK_DOWN:
-			if (player && player->m_vVelocity.y < 0)
-				player->m_vVelocity.y = 0;
+			g_cObjectManager.StopPlayer(DOWN_DIRECTION);
 			break;
 		case VK_LEFT:
-			if (player && player->m_vVelocity.x < 0)
-				player->m_vVelocity.x = 0;
+			g_cObjectManager.StopPlayer(LEFT_DIRECTION);
 			break;
 		case VK_RIGHT:
-			if (player && player->m_vVelocity.x > 0)
-				player->m_vVelocity.x = 0;
+			g_cObjectManager.StopPlayer(RIGHT_DIRECTION);
 			break;
 		case VK_SHIFT:
 			g_bDarkenScreen = FALSE;
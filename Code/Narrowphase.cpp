@@ -0,0 +1,213 @@
+/// \file Narrowphase.cpp
+/// \brief Code for the batched collision narrowphase class CNarrowphase.
+
+#include <float.h>
+#include <math.h>
+
+#include "Narrowphase.h"
+
+#if !defined(NO_SIMD) && defined(__AVX__)
+  #define NARROWPHASE_AVX ///< Test eight targets at a time.
+  #include <immintrin.h>
+#elif !defined(NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+  #define NARROWPHASE_SSE2 ///< Test four targets at a time.
+  #include <emmintrin.h>
+#endif
+
+const int NARROWPHASE_LANES = 8; ///< Targets are padded to a multiple of this.
+
+CNarrowphase::CNarrowphase(){
+  m_nCount = 0;
+} //constructor
+
+/// Remove all targets. Keeps the memory so that the targets can be refilled
+/// every tick without going back to the heap.
+
+void CNarrowphase::clear(){
+  m_fX.clear();
+  m_fY.clear();
+  m_nCount = 0;
+} //clear
+
+/// Insert a target. The arrays grow a whole number of lanes at a time, and
+/// the padding is so far away that it is never within any radius.
+/// \param x X coordinate.
+/// \param y Y coordinate.
+/// \return Id of the target.
+
+int CNarrowphase::insert(float x, float y){
+  if(m_nCount == (int)m_fX.size()){
+    m_fX.resize(m_nCount + NARROWPHASE_LANES, FLT_MAX);
+    m_fY.resize(m_nCount + NARROWPHASE_LANES, FLT_MAX);
+  } //if
+
+  m_fX[m_nCount] = x;
+  m_fY[m_nCount] = y;
+  return m_nCount++;
+} //insert
+
+int CNarrowphase::GetCount(){
+  return m_nCount;
+} //GetCount
+
+/// Get the number of targets that test does at a time, which depends on the
+/// instruction set that it was compiled for.
+/// \return 8 with AVX, 4 with SSE2, 1 otherwise.
+
+int CNarrowphase::GetLaneCount(){
+#if defined(NARROWPHASE_AVX)
+  return 8;
+#elif defined(NARROWPHASE_SSE2)
+  return 4;
+#else
+  return 1;
+#endif
+} //GetLaneCount
+
+/// Find the targets that are less than a given distance from a point in a
+/// world that wraps around horizontally. Bit i of the hit mask is set if
+/// target i is in range. The squared distance is compared with the squared
+/// radius, which gives the same answer as comparing the distance with the
+/// radius since the square root is correctly rounded.
+/// \param x X coordinate of point.
+/// \param y Y coordinate of point.
+/// \param r Radius.
+/// \param worldwidth Width of world, a horizontal distance more than this is wrapped.
+/// \param hits Hit mask, one bit per target, resized to fit.
+/// \return Number of targets in range.
+
+int CNarrowphase::test(float x, float y, float r, float worldwidth, vector<unsigned>& hits){
+  hits.assign((m_nCount + 31)/32, 0);
+  int count = 0;
+
+#if defined(NARROWPHASE_AVX)
+  const __m256 px = _mm256_set1_ps(x), py = _mm256_set1_ps(y);
+  const __m256 r2 = _mm256_set1_ps(r*r);
+  const __m256 w = _mm256_set1_ps(worldwidth);
+  const __m256 sign = _mm256_set1_ps(-0.0f);
+
+  for(int i=0; i<m_nCount; i+=8){
+    __m256 dx = _mm256_andnot_ps(sign, _mm256_sub_ps(px, _mm256_loadu_ps(&m_fX[i]))); //|dx|
+    dx = _mm256_sub_ps(dx, _mm256_and_ps(_mm256_cmp_ps(dx, w, _CMP_GT_OQ), w)); //wrap
+    const __m256 dy = _mm256_andnot_ps(sign, _mm256_sub_ps(py, _mm256_loadu_ps(&m_fY[i])));
+    const __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    const unsigned m = (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(d2, r2, _CMP_LT_OQ));
+    if(m){
+      hits[i/32] |= m << (i%32);
+      for(unsigned b=m; b; b&=b-1)count++;
+    } //if
+  } //for
+
+#elif defined(NARROWPHASE_SSE2)
+  const __m128 px = _mm_set1_ps(x), py = _mm_set1_ps(y);
+  const __m128 r2 = _mm_set1_ps(r*r);
+  const __m128 w = _mm_set1_ps(worldwidth);
+  const __m128 sign = _mm_set1_ps(-0.0f);
+
+  for(int i=0; i<m_nCount; i+=4){
+    __m128 dx = _mm_andnot_ps(sign, _mm_sub_ps(px, _mm_loadu_ps(&m_fX[i]))); //|dx|
+    dx = _mm_sub_ps(dx, _mm_and_ps(_mm_cmpgt_ps(dx, w), w)); //wrap
+    const __m128 dy = _mm_andnot_ps(sign, _mm_sub_ps(py, _mm_loadu_ps(&m_fY[i])));
+    const __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    const unsigned m = (unsigned)_mm_movemask_ps(_mm_cmplt_ps(d2, r2));
+    if(m){
+      hits[i/32] |= m << (i%32);
+      for(unsigned b=m; b; b&=b-1)count++;
+    } //if
+  } //for
+
+#else
+  const float r2 = r*r;
+  for(int i=0; i<m_nCount; i++){
+    float dx = fabsf(x - m_fX[i]);
+    dx -= dx > worldwidth? worldwidth: 0.0f; //wrap
+    const float dy = fabsf(y - m_fY[i]);
+    if(dx*dx + dy*dy < r2){
+      hits[i/32] |= 1u << (i%32);
+      count++;
+    } //if
+  } //for
+#endif
+
+  return count;
+} //test
+
+/// Find the targets within a radius of a point one at a time, the way the
+/// object manager's distance function does it, with a square root for each
+/// target. For checking and timing test against.
+/// \param x X coordinate of point.
+/// \param y Y coordinate of point.
+/// \param r Radius.
+/// \param worldwidth Width of world, a horizontal distance more than this is wrapped.
+/// \param hits Hit mask, one bit per target, resized to fit.
+/// \return Number of targets in range.
+
+int CNarrowphase::TestScalar(float x, float y, float r, float worldwidth, vector<unsigned>& hits){
+  hits.assign((m_nCount + 31)/32, 0);
+  int count = 0;
+
+  for(int i=0; i<m_nCount; i++){
+    float dx = (float)fabs(x - m_fX[i]);
+    const float dy = (float)fabs(y - m_fY[i]);
+    if(dx > worldwidth)dx -= worldwidth;
+    if(sqrtf(dx*dx + dy*dy) < r){
+      hits[i/32] |= 1u << (i%32);
+      count++;
+    } //if
+  } //for
+
+  return count;
+} //TestScalar
+
+/// Find when a point moving in a straight line first comes within a radius
+/// of a target, in a world that wraps around horizontally. The wrap is taken
+/// off the end of the move the same way that test does it, so a point that
+/// ends in range is always a hit, and one that passes through the circle
+/// and out again on the way is a hit too. The time is a fraction of the move,
+/// 0 if the point starts in range.
+/// \param x0 X coordinate at the start of the move.
+/// \param y0 Y coordinate at the start of the move.
+/// \param x1 X coordinate at the end of the move.
+/// \param y1 Y coordinate at the end of the move.
+/// \param cx X coordinate of target.
+/// \param cy Y coordinate of target.
+/// \param r Radius.
+/// \param worldwidth Width of world, a horizontal distance more than this is wrapped.
+/// \param t [out] Time of impact, from 0 to 1.
+/// \return TRUE if the point comes within range of the target.
+
+BOOL CNarrowphase::TimeOfImpact(float x0, float y0, float x1, float y1, float cx, float cy,
+  float r, float worldwidth, float& t)
+{
+  float ex = x1 - cx; //offset from target at the end
+  if(ex > worldwidth)ex -= worldwidth;
+  else if(ex < -worldwidth)ex += worldwidth;
+  const float ey = y1 - cy;
+
+  const float dx = x1 - x0, dy = y1 - y0; //move
+  const float sx = ex - dx, sy = ey - dy; //offset from target at the start
+  const float r2 = r*r;
+
+  const float c = sx*sx + sy*sy - r2;
+  if(c < 0.0f){ //in range at the start
+    t = 0.0f;
+    return TRUE;
+  } //if
+
+  const float a = dx*dx + dy*dy;
+  const float b = sx*dx + sy*dy;
+  if(a > 0.0f && b < 0.0f){ //closing in
+    const float disc = b*b - a*c;
+    if(disc >= 0.0f){
+      t = (-b - sqrtf(disc))/a; //first root
+      if(t <= 1.0f)return TRUE;
+    } //if
+  } //if
+
+  if(ex*ex + ey*ey < r2){ //in range at the end, rounding missed the root
+    t = 1.0f;
+    return TRUE;
+  } //if
+
+  return FALSE;
+} //TimeOfImpact
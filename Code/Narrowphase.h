@@ -0,0 +1,54 @@
+/// \file Narrowphase.h
+/// \brief Interface for the batched collision narrowphase class CNarrowphase.
+
+#pragma once
+
+#include <vector>
+
+#include "Defines.h"
+
+using namespace std;
+
+/// \brief The narrowphase.
+///
+/// Holds the positions of collision targets packed into arrays of X and Y
+/// coordinates, and tests a point against all of them at once for being
+/// within a radius, eight targets at a time with AVX or four with SSE2
+/// where the compiler has them. The distance is compared squared, and the
+/// world wrap is taken off with a mask instead of a branch. The result is a
+/// bitmask with a bit for each target, in the order that they were inserted.
+/// For continuous collision detection it also finds when a point moving
+/// along a segment first comes within a radius of a target.
+/// Like the spatial grid, it knows nothing about game objects, the caller
+/// maps ids back to whatever it inserted.
+
+class CNarrowphase{
+  private:
+    vector<float> m_fX; ///< X coordinate of each target, padded to a whole number of lanes.
+    vector<float> m_fY; ///< Y coordinate of each target, padded to a whole number of lanes.
+    int m_nCount; ///< Number of targets.
+
+  public:
+    CNarrowphase(); ///< Constructor.
+
+    void clear(); ///< Remove all targets.
+    int insert(float x, float y); ///< Insert a target.
+    int GetCount(); ///< Get the number of targets.
+    static int GetLaneCount(); ///< Get the number of targets tested at a time.
+
+    int test(float x, float y, float r, float worldwidth, vector<unsigned>& hits); ///< Find targets within a radius.
+    int TestScalar(float x, float y, float r, float worldwidth, vector<unsigned>& hits); ///< Find them one at a time.
+
+    static BOOL TimeOfImpact(float x0, float y0, float x1, float y1, float cx, float cy,
+      float r, float worldwidth, float& t); ///< When a moving point first comes within a radius.
+}; //CNarrowphase
+
+/// Get the index of the lowest set bit of a word, for walking a hit mask.
+/// \param w Word, not zero.
+/// \return Index of the lowest set bit.
+
+inline int LowestBit(unsigned w){
+  int i = 0;
+  while(!(w & 1)){w >>= 1; i++;}
+  return i;
+} //LowestBit
@@ -1,45 +1,153 @@
 /// \file objman.cpp
 /// \brief Code for the object manager class CObjectManager.
 
-#include "objman.h"
+#include <algorithm>
+
+#include "ObjMan.h"
 #include "debug.h"
-#include "defines.h"
-#include "timer.h"
+#include "Defines.h"
+#include "Timer.h"
 #include "Sound.h"
 #include "EnemyOne.h"
 #include "EnemyInvader.h"
 #include "EnemyThief.h"
 #include "Random.h"
+#include "World.h"
 
 extern int g_nScreenWidth;
 extern int g_nScreenHeight;
-extern GameStateType g_nGameState;
-extern LevelStateType g_nLevelState;
-extern BOOL g_bPlayerIsInvulnerable;
-extern BOOL g_bShieldActive;
-extern BOOL g_bAssistActive;
-extern BOOL g_bSpecialActivate;
-extern CGameObject* player;
-extern CTimer g_cTimer; 
-extern CRandom g_cRandom;
-extern CSoundManager* g_pSoundManager;
-int m_nEnemyCount;
-
-/// Comparison for depth sorting game objects.
-/// To compare two game objects, simply compare their Z coordinates.
-/// \param p0 Pointer to game object 0.
-/// \param p1 Pointer to game object 1.
-/// \return true If object 0 is behind object 1.
-
-bool ZCompare(const CGameObject* p0, const CGameObject* p1){
-  return p0->m_vPos.z > p1->m_vPos.z;
-} //ZCompare
+
+const unsigned FNV_OFFSET_BASIS = 2166136261u; ///< Starting value of an FNV-1a hash.
+const unsigned FNV_PRIME = 16777619u; ///< Multiplier of an FNV-1a hash.
+const unsigned SNAPSHOT_MAGIC = 0x53465343; ///< First word of a snapshot, "CSFS".
+const float COLLISION_RADIUS = 25.0f; ///< Objects closer than this collide.
+const float SWEPT_MARGIN = 1.0f; ///< Slack on the query radius around a projectile's move, for rounding.
+const int PREWARM_OBJECTS = 256; ///< Least number of plain game objects to prewarm.
+const int PREWARM_ENEMIES = 32; ///< Least number of each intelligent enemy to prewarm.
+const float ARENA_SIDE_MARGIN = 140.0f; ///< Gap between the sides of the screen and the arena.
+const float ARENA_TOP_MARGIN = -200.0f; ///< Top of the arena relative to the top of the screen.
+const float ARENA_BOTTOM = 40.0f; ///< Bottom of the arena.
+
+/// \brief A name that is registered, and the type of object created with it.
+
+struct NAMEDOBJECT{
+  const char* m_szName; ///< Object name.
+  ObjectType m_nType; ///< Object type.
+}; //NAMEDOBJECT
+
+/// Objects that can be found again after they are created. The player
+/// incarnations come first, so that they get the lowest registry slots.
+/// Everything else, such as projectiles and explosions, is never registered.
+
+static const NAMEDOBJECT g_sNamedObject[] = {
+  {"fredIdle", FREDIDLE_OBJECT}, {"fredAttack", FREDATTACK_OBJECT},
+  {"fredHurt", FREDHURT_OBJECT}, {"fredLost", FREDLOST_OBJECT},
+  {"swazIdle", SWAZIDLE_OBJECT}, {"swazAttack", SWAZATTACK_OBJECT},
+  {"swazHurt", SWAZHURT_OBJECT}, {"swazLost", SWAZLOST_OBJECT},
+  {"polkIdle", POLKIDLE_OBJECT}, {"polkAttack", POLKATTACK_OBJECT},
+  {"polkHurt", POLKHURT_OBJECT}, {"polkLost", POLKLOST_OBJECT},
+  {"shield", SHIELD_OBJECT}, {"assistFred", ASSISTFRED_OBJECT},
+  {"assistSwaz", ASSISTSWAZ_OBJECT}, {"assistPolk", ASSISTPOLK_OBJECT},
+}; //g_sNamedObject
+
+const int NUM_PLAYER_NAMES = 12; ///< Number of player entries at the start of g_sNamedObject.
+
+const unsigned TRANSITION_KEEPHEALTH = 1; ///< Next incarnation keeps the health of the last.
+const unsigned TRANSITION_INVULNERABLE = 2; ///< Start the player's invulnerable time.
+const unsigned TRANSITION_RESETAGE = 4; ///< Clear the died of age flag.
+const unsigned TRANSITION_SETVELOCITY = 8; ///< Velocity becomes (m_fVx, m_fVy, 0).
+const unsigned TRANSITION_RANDOMY = 16; ///< Y velocity is multiplied by -1, 0, or 1 at random.
+const unsigned TRANSITION_SETZ = 32; ///< Z coordinate becomes m_fZ.
+const unsigned TRANSITION_OFFSETZ = 64; ///< m_fZ is added to the Z coordinate.
+
+/// \brief An incarnation transition.
+
+struct TRANSITION{
+  ObjectType m_nFrom; ///< Type of the object that died.
+  TransitionType m_nWhen; ///< Condition for taking this transition.
+  ObjectType m_nTo; ///< Type of the next incarnation.
+  const char* m_szName; ///< Name of the next incarnation.
+  unsigned m_nFlags; ///< TRANSITION_* flags.
+  float m_fVx, m_fVy; ///< Velocity for TRANSITION_SETVELOCITY.
+  float m_fZ; ///< Z coordinate or offset.
+}; //TRANSITION
+
+/// What each type of object turns into when it dies. The transitions for a
+/// type must be together, and the first one whose condition holds is taken.
+/// Types that aren't here either have no next incarnation or are handled
+/// in CreateNextIncarnation.
+
+static const TRANSITION g_sTransition[] = {
+  {FREDIDLE_OBJECT, DIEDOFDMG_TRANSITION, FREDLOST_OBJECT, "fredLost", TRANSITION_INVULNERABLE, 0.0f, 0.0f, 0.0f},
+  {FREDIDLE_OBJECT, ALWAYS_TRANSITION, FREDHURT_OBJECT, "fredHurt", TRANSITION_INVULNERABLE, 0.0f, 0.0f, 0.0f},
+  {FREDATTACK_OBJECT, DIEDOFDMG_TRANSITION, FREDLOST_OBJECT, "fredLost", 0, 0.0f, 0.0f, 0.0f},
+  {FREDATTACK_OBJECT, PLAYERHIT_TRANSITION, FREDHURT_OBJECT, "fredHurt", TRANSITION_INVULNERABLE, 0.0f, 0.0f, 0.0f},
+  {FREDATTACK_OBJECT, DIEDOFAGE_TRANSITION, FREDIDLE_OBJECT, "fredIdle", TRANSITION_RESETAGE, 0.0f, 0.0f, 0.0f},
+  {FREDHURT_OBJECT, ALWAYS_TRANSITION, FREDIDLE_OBJECT, "fredIdle", 0, 0.0f, 0.0f, 0.0f},
+
+  {SWAZIDLE_OBJECT, DIEDOFDMG_TRANSITION, SWAZLOST_OBJECT, "swazLost", TRANSITION_INVULNERABLE, 0.0f, 0.0f, 0.0f},
+  {SWAZIDLE_OBJECT, ALWAYS_TRANSITION, SWAZHURT_OBJECT, "swazHurt", TRANSITION_INVULNERABLE, 0.0f, 0.0f, 0.0f},
+  {SWAZATTACK_OBJECT, DIEDOFDMG_TRANSITION, SWAZLOST_OBJECT, "swazLost", TRANSITION_INVULNERABLE, 0.0f, 0.0f, 0.0f},
+  {SWAZATTACK_OBJECT, PLAYERHIT_TRANSITION, SWAZHURT_OBJECT, "swazHurt", TRANSITION_INVULNERABLE, 0.0f, 0.0f, 0.0f},
+  {SWAZATTACK_OBJECT, DIEDOFAGE_TRANSITION, SWAZIDLE_OBJECT, "swazIdle", TRANSITION_RESETAGE, 0.0f, 0.0f, 0.0f},
+  {SWAZHURT_OBJECT, ALWAYS_TRANSITION, SWAZIDLE_OBJECT, "swazIdle", 0, 0.0f, 0.0f, 0.0f},
+
+  {POLKIDLE_OBJECT, DIEDOFDMG_TRANSITION, POLKLOST_OBJECT, "polkLost", TRANSITION_INVULNERABLE, 0.0f, 0.0f, 0.0f},
+  {POLKIDLE_OBJECT, ALWAYS_TRANSITION, POLKHURT_OBJECT, "polkHurt", TRANSITION_INVULNERABLE, 0.0f, 0.0f, 0.0f},
+  {POLKATTACK_OBJECT, DIEDOFDMG_TRANSITION, POLKLOST_OBJECT, "polkLost", TRANSITION_INVULNERABLE, 0.0f, 0.0f, 0.0f},
+  {POLKATTACK_OBJECT, PLAYERHIT_TRANSITION, POLKHURT_OBJECT, "polkHurt", TRANSITION_INVULNERABLE, 0.0f, 0.0f, 0.0f},
+  {POLKATTACK_OBJECT, DIEDOFAGE_TRANSITION, POLKIDLE_OBJECT, "polkIdle", TRANSITION_RESETAGE, 0.0f, 0.0f, 0.0f},
+  {POLKHURT_OBJECT, ALWAYS_TRANSITION, POLKIDLE_OBJECT, "polkIdle", 0, 0.0f, 0.0f, 0.0f},
+
+  {ENEMY1AFTER_OBJECT, ALWAYS_TRANSITION, ENEMY1HURT_OBJECT, "enemy1Hurt", TRANSITION_KEEPHEALTH, 0.0f, 0.0f, 0.0f},
+  {ENEMY1IDLE_OBJECT, ALWAYS_TRANSITION, ENEMY1HURT_OBJECT, "enemy1Hurt", TRANSITION_KEEPHEALTH, 0.0f, 0.0f, 0.0f},
+  {ENEMY1HURT_OBJECT, HEALTHY_TRANSITION, ENEMY1AFTER_OBJECT, "enemy1Idle", TRANSITION_KEEPHEALTH, 0.0f, 0.0f, 0.0f},
+  {ENEMY1HURT_OBJECT, DIEDOFAGE_TRANSITION, ENEMYEXIT_OBJECT, "enemyExit", TRANSITION_SETVELOCITY | TRANSITION_SETZ, 0.0f, 0.0f, 376.0f},
+
+  {ENEMYINVADERIDLE_OBJECT, ALWAYS_TRANSITION, ENEMYINVADERHURT_OBJECT, "enemyInvaderHurt", TRANSITION_KEEPHEALTH, 0.0f, 0.0f, 0.0f},
+  {ENEMYINVADERATTACK_OBJECT, DIEDOFAGE_TRANSITION, ENEMYINVADERIDLE_OBJECT, "enemyInvaderIdle", TRANSITION_KEEPHEALTH, 0.0f, 0.0f, 0.0f},
+  {ENEMYINVADERATTACK_OBJECT, ALWAYS_TRANSITION, ENEMYINVADERHURT_OBJECT, "enemyInvaderHurt", TRANSITION_KEEPHEALTH, 0.0f, 0.0f, 0.0f},
+  {ENEMYINVADERHURT_OBJECT, HEALTHY_TRANSITION, ENEMYINVADERIDLE_OBJECT, "enemyInvaderIdle", TRANSITION_KEEPHEALTH, 0.0f, 0.0f, 0.0f},
+  {ENEMYINVADERHURT_OBJECT, DIEDOFAGE_TRANSITION, ENEMYEXIT_OBJECT, "enemyExit", TRANSITION_SETVELOCITY | TRANSITION_SETZ, 0.0f, 0.0f, 376.0f},
+
+  {ENEMYZOOMERIDLE_OBJECT, ALWAYS_TRANSITION, ENEMYZOOMERHURT_OBJECT, "enemyZoomerHurt", TRANSITION_KEEPHEALTH, 0.0f, 0.0f, 0.0f},
+  {ENEMYZOOMERIDLEFLIP_OBJECT, ALWAYS_TRANSITION, ENEMYZOOMERHURT_OBJECT, "enemyZoomerHurt", TRANSITION_KEEPHEALTH, 0.0f, 0.0f, 0.0f},
+  {ENEMYZOOMERBOUNCE_OBJECT, DIEDOFSPECIAL_TRANSITION, ENEMYZOOMERHURT_OBJECT, "enemyZoomerHurt", TRANSITION_KEEPHEALTH, 0.0f, 0.0f, 0.0f},
+  {ENEMYZOOMERBOUNCE_OBJECT, ALWAYS_TRANSITION, ENEMYZOOMERIDLEFLIP_OBJECT, "enemyZoomerIdleFlip", TRANSITION_KEEPHEALTH | TRANSITION_SETVELOCITY, 15.0f, 0.0f, 0.0f},
+  {ENEMYZOOMERBOUNCEFLIP_OBJECT, DIEDOFSPECIAL_TRANSITION, ENEMYZOOMERHURT_OBJECT, "enemyZoomerHurt", TRANSITION_KEEPHEALTH, 0.0f, 0.0f, 0.0f},
+  {ENEMYZOOMERBOUNCEFLIP_OBJECT, ALWAYS_TRANSITION, ENEMYZOOMERIDLE_OBJECT, "enemyZoomerIdle", TRANSITION_KEEPHEALTH | TRANSITION_SETVELOCITY, -15.0f, 0.0f, 0.0f},
+  {ENEMYZOOMERHURT_OBJECT, HEALTHY_TRANSITION, ENEMYZOOMERIDLE_OBJECT, "enemyZoomerIdle", TRANSITION_KEEPHEALTH | TRANSITION_SETVELOCITY, -15.0f, 0.0f, 0.0f},
+  {ENEMYZOOMERHURT_OBJECT, DIEDOFAGE_TRANSITION, ENEMYEXIT_OBJECT, "enemyExit", TRANSITION_SETVELOCITY | TRANSITION_SETZ, 0.0f, 0.0f, 376.0f},
+
+  {ENEMYTHIEFIDLE_OBJECT, ALWAYS_TRANSITION, ENEMYTHIEFHURT_OBJECT, "enemyThiefHurt", TRANSITION_KEEPHEALTH, 0.0f, 0.0f, 0.0f},
+  {ENEMYTHIEFATTACK_OBJECT, DIEDOFAGE_TRANSITION, ENEMYTHIEFIDLE_OBJECT, "enemyThiefIdle", TRANSITION_KEEPHEALTH | TRANSITION_SETVELOCITY | TRANSITION_RANDOMY, 1.5f, 3.0f, 0.0f},
+  {ENEMYTHIEFATTACK_OBJECT, ALWAYS_TRANSITION, ENEMYTHIEFHURT_OBJECT, "enemyThiefHurt", TRANSITION_KEEPHEALTH, 0.0f, 0.0f, 0.0f},
+  {ENEMYTHIEFHURT_OBJECT, HEALTHY_TRANSITION, ENEMYTHIEFIDLE_OBJECT, "enemyThiefIdle", TRANSITION_KEEPHEALTH, 0.0f, 0.0f, 0.0f},
+  {ENEMYTHIEFHURT_OBJECT, DIEDOFAGE_TRANSITION, ENEMYEXIT_OBJECT, "enemyExit", TRANSITION_KEEPHEALTH | TRANSITION_SETVELOCITY, 0.0f, 0.0f, 0.0f},
+
+  {PROJECTILEF_OBJECT, ALWAYS_TRANSITION, EXPLOSION_OBJECT, "explosion", TRANSITION_SETVELOCITY | TRANSITION_OFFSETZ, 0.0f, 0.0f, -30.0f},
+  {PROJECTILES_OBJECT, ALWAYS_TRANSITION, EXPLOSION_OBJECT, "explosion", TRANSITION_SETVELOCITY | TRANSITION_SETZ, 0.0f, 0.0f, 376.0f - 30.0f},
+  {PROJECTILEP_OBJECT, ALWAYS_TRANSITION, EXPLOSION_OBJECT, "explosion", TRANSITION_SETVELOCITY | TRANSITION_SETZ, 0.0f, 0.0f, 376.0f - 30.0f},
+}; //g_sTransition
 
 //initilizes some stats
-CObjectManager::CObjectManager(){ 
+CObjectManager::CObjectManager(CWorld* world): m_cColdPool(sizeof(OBJECTCOLD)){ 
+  m_pWorld = world;
+  m_nPoolCount = 0;
   m_stlObjectList.clear();
-  m_stlNameToObject.clear();
+  m_nListOrder = 0;
   m_stlNameToObjectType.clear();
+  const int n = sizeof(g_sNamedObject)/sizeof(NAMEDOBJECT); //number of names
+  for(int i=0; i<n; i++)
+    m_cRegistry.InternName(g_sNamedObject[i].m_szName, g_sNamedObject[i].m_nType);
+  m_hPlayer = NULL_HANDLE;
+
+  for(int i=0; i<NUM_OBJECT_TYPES; i++)
+    m_nFirstTransition[i] = -1;
+  const int m = sizeof(g_sTransition)/sizeof(TRANSITION); //number of transitions
+  for(int i=m-1; i>=0; i--)
+    m_nFirstTransition[g_sTransition[i].m_nFrom] = i;
+
   m_nLastGunFireTime = 0;
   m_nStartInvulnerableTime = 0;
 	m_bPlayerHit = FALSE;
@@ -54,13 +162,73 @@ CObjectManager::CObjectManager(){
 	m_nAmmoCount[1] = 0;
 	m_nAmmoCount[2] = 0;
 	m_nPlayerLives = 2;
+	m_bBroadphase = TRUE;
+	m_bSwept = FALSE;
+	m_bNarrowphase = TRUE;
+	for(int i = 0; i < NUM_OBJECT_TYPES; i++)
+		m_nLiveCount[i] = m_nHighWaterMark[i] = 0;
 } //constructor
 
+/// Delete the objects, and then the pools that their memory came from.
+
 CObjectManager::~CObjectManager(){ 
   for(auto i=m_stlObjectList.begin(); i!=m_stlObjectList.end(); i++)
     delete *i;
+  for(size_t k=0; k<m_pSpawnQueue.size(); k++)
+    delete m_pSpawnQueue[k];
+  for(int i=0; i<m_nPoolCount; i++)
+    delete m_pPool[i];
 } //destructor
 
+/// Get the pool that holds objects of a given size, creating it if this is
+/// the first object of that size. Each class derived from CGameObject has its
+/// own size, so in practice this is one pool per class.
+/// \param size Object size in bytes.
+/// \return Pointer to the pool, nullptr if there are too many sizes.
+
+CObjectPool* CObjectManager::GetPool(size_t size){
+  for(int i=0; i<m_nPoolCount; i++)
+    if(m_nPoolSize[i] == size)
+      return m_pPool[i];
+
+  if(m_nPoolCount >= MAX_OBJECT_POOLS)
+    return nullptr;
+
+  m_nPoolSize[m_nPoolCount] = size;
+  return m_pPool[m_nPoolCount++] = new CObjectPool(size);
+} //GetPool
+
+/// Get the cold data for a new object from the cold pool. The object fills
+/// it in.
+/// \return Pointer to uninitialized cold data.
+
+OBJECTCOLD* CObjectManager::NewColdData(){
+  return (OBJECTCOLD*)m_cColdPool.allocate();
+} //NewColdData
+
+/// Give the cold data of an object that is being deleted back to the cold pool.
+/// \param p Pointer to cold data from NewColdData.
+
+void CObjectManager::DeleteColdData(OBJECTCOLD* p){
+  m_cColdPool.release(p);
+} //DeleteColdData
+
+/// Give a new object a row in the entity store, in the archetype for the
+/// components that the trait table gives its type.
+/// \param p Pointer to object.
+/// \param t Object type.
+
+void CObjectManager::AddEntity(CGameObject* p, ObjectType t){
+  m_cEntities.add(p, GetComponents(t));
+} //AddEntity
+
+/// Take away an object's row in the entity store, when it is deleted.
+/// \param p Pointer to object.
+
+void CObjectManager::RemoveEntity(CGameObject* p){
+  m_cEntities.remove(p);
+} //RemoveEntity
+
 /// Insert a map from an object name string to an object type enumeration.
 /// \param name Name of an object type
 /// \param t Enumerated object type corresponding to that name.
@@ -93,23 +261,15 @@ CGameObject* CObjectManager::createObject(ObjectType obj, const char* name, cons
   CGameObject* p;
 	
 	if(obj == ENEMY1IDLE_OBJECT)
-		p = new CEnemyOneObject(name, s, v);
+		p = new(this) CEnemyOneObject(m_pWorld, name, s, v);
 	else if(obj == ENEMYINVADERIDLE_OBJECT)
-		p = new CEnemyInvaderObject(name, s, v);
+		p = new(this) CEnemyInvaderObject(m_pWorld, name, s, v);
 	else if(obj == ENEMYTHIEFIDLE_OBJECT)
-		p = new CEnemyThiefObject(name, s, v);
-  else p = new CGameObject(obj, name, s, v);
-
-  m_stlObjectList.push_front(p); //insert in object list
+		p = new(this) CEnemyThiefObject(m_pWorld, name, s, v);
+  else p = new(this) CGameObject(m_pWorld, obj, name, s, v);
 
-  auto i = m_stlNameToObject.find(name);
+  AddObject(p); //insert in object list
 
-  if(i == m_stlNameToObject.end()) //if name not in map
-    m_stlNameToObject.insert(pair<string, CGameObject*>(name, p)); //put it there
-  else{
-    m_stlNameToObject.erase(i); //erase old one
-    m_stlNameToObject.insert(pair<string, CGameObject*>(name, p)); //put new one there
-  } //else
 
   return p;
 } //createObject
@@ -118,91 +278,218 @@ CGameObject* CObjectManager::createObject(ObjectType obj, const char* name, cons
 	CGameObject* p;
 
 	if(obj == ENEMY1IDLE_OBJECT)
-		p = new CEnemyOneObject(name, s, v);
+		p = new(this) CEnemyOneObject(m_pWorld, name, s, v);
 	else if(obj == ENEMYINVADERIDLE_OBJECT)
-		p = new CEnemyInvaderObject(name, s, v);
+		p = new(this) CEnemyInvaderObject(m_pWorld, name, s, v);
 	else if(obj == ENEMYTHIEFIDLE_OBJECT)
-		p = new CEnemyThiefObject(name, s, v);
-	else p = new CGameObject(obj, name, s, v);
-	p->m_nHealth = health;
+		p = new(this) CEnemyThiefObject(m_pWorld, name, s, v);
+	else p = new(this) CGameObject(m_pWorld, obj, name, s, v);
+	if(p->HasComponent(COLLIDER_COMPONENT))p->health() = health;
 
-	m_stlObjectList.push_front(p); //insert in object list
+	AddObject(p); //insert in object list
+	return p;
+} //createObject
 
-	auto i = m_stlNameToObject.find(name);
+/// Queue a newly created object for the object list. Objects are created
+/// from inside loops over the object list (collisions, AI, bounces), so
+/// they are only put into it by FlushSpawnQueue at the end of the tick.
+/// The object is counted and registered right away, though.
+/// \param p Pointer to the new object.
+
+void CObjectManager::AddObject(CGameObject* p){
+	m_pSpawnQueue.push_back(p);
+	CountObject(p);
+	RegisterObject(p);
+} //AddObject
+
+/// Count an object against the live count and high water mark for its type.
+/// \param p Pointer to object.
+
+void CObjectManager::CountObject(CGameObject* p){
+	const int t = p->m_nObjectType;
+	if(++m_nLiveCount[t] > m_nHighWaterMark[t])
+		m_nHighWaterMark[t] = m_nLiveCount[t];
+} //CountObject
+
+/// If an object's type is registered, put it into the registry in place of
+/// the previous object of that name, and if it is a player incarnation, make
+/// it the player.
+/// \param p Pointer to object.
+
+void CObjectManager::RegisterObject(CGameObject* p){
+	const int slot = m_cRegistry.GetSlot(p->m_nObjectType);
+	if(slot >= 0){
+		p->m_pCold->m_hHandle = m_cRegistry.insert(slot, p);
+		if(slot < NUM_PLAYER_NAMES)
+			m_hPlayer = p->m_pCold->m_hHandle;
+	} //if
+} //RegisterObject
 
-	if(i == m_stlNameToObject.end()) //if name not in map
-		m_stlNameToObject.insert(pair<string, CGameObject*>(name, p)); //put it there
-	else{
-		m_stlNameToObject.erase(i); //erase old one
-		m_stlNameToObject.insert(pair<string, CGameObject*>(name, p)); //put new one there
-	} //else
+/// Put the queued objects at the front of the object list, in the order that
+/// they were created, and give each its place in the list. Objects that were
+/// killed before they ever got into the list are deleted instead.
 
-	return p;
-} //createObject
+void CObjectManager::FlushSpawnQueue(){
+	for(size_t k = 0; k < m_pSpawnQueue.size(); k++){
+		CGameObject* p = m_pSpawnQueue[k];
 
-void CObjectManager::clear(){
+		if(p->GetFlag(DEAD_FLAG)){
+			m_nLiveCount[p->m_nObjectType]--;
+			m_cRegistry.erase(p->m_pCold->m_hHandle);
+			delete p;
+			continue;
+		} //if
+
+		m_stlObjectList.push_front(p);
+		p->listOrder() = ++m_nListOrder;
+		m_cDepthLayers.insert(p);
+	} //for
+
+	m_pSpawnQueue.clear();
+} //FlushSpawnQueue
+
+/// Turn an object into another type of object, as if it had been killed and
+/// a new one created in its place. If the object is a plain game object and
+/// the new type is too, this is done in place, so no memory changes hands,
+/// the object stays where it is in the object list and any pointer to it
+/// stays good, though its components move to the archetype of the new type.
+/// Otherwise the object is killed and a new one is created.
+/// \param object Pointer to the object to be changed.
+/// \param t The type of the new incarnation.
+/// \param name The name of the new incarnation in the XML settings file.
+/// \param s Location.
+/// \param v Velocity.
+/// \param health Health, or -1 for the default.
+/// \return Pointer to the new incarnation.
+
+CGameObject* CObjectManager::ChangeIncarnation(CGameObject* object, ObjectType t, const char* name, const Vector3& s, const Vector3& v, int health){
+	m_cRegistry.erase(object->m_pCold->m_hHandle); //it no longer answers to its old name
+	object->m_pCold->m_hHandle = NULL_HANDLE;
+
+	if(object->GetFlag(INTELLIGENT_FLAG) || HasTrait(t, INTELLIGENT_TRAIT)){ //needs a different class
+		object->kill();
+		if(health < 0)return createObject(t, name, s, v);
+		else return createObject(t, name, s, v, health);
+	} //if
+
+	m_nLiveCount[object->m_nObjectType]--;
+	const Vector3 position = s, velocity = v; //s and v may be in the row that change moves
+	m_cEntities.change(object, GetComponents(t));
+	object->Incarnate(t, name, position, velocity);
+	if(health >= 0 && object->HasComponent(COLLIDER_COMPONENT))object->health() = health;
+	m_cDepthLayers.move(object); //its Z may have changed
+	CountObject(object);
+	RegisterObject(object);
+	return object;
+} //ChangeIncarnation
+
+/// Delete every object, in the object list and in the spawn queue. The
+/// registry is left alone.
+
+void CObjectManager::DeleteObjects(){
 	for(auto i = m_stlObjectList.begin(); i != m_stlObjectList.end(); i++){
 		delete *i;
 	}
 	m_stlObjectList.clear();
+	m_nListOrder = 0;
+	m_cDepthLayers.clear();
+	for(size_t k = 0; k < m_pSpawnQueue.size(); k++)
+		delete m_pSpawnQueue[k];
+	m_pSpawnQueue.clear();
+	for(int i = 0; i < NUM_OBJECT_TYPES; i++)
+		m_nLiveCount[i] = 0;
+} //DeleteObjects
 
-	m_stlNameToObject.erase(m_stlNameToObject.begin(), m_stlNameToObject.end());
-	m_stlNameToObject.clear();
+void CObjectManager::clear(){
+	DeleteObjects();
+	m_cRegistry.clear();
+	m_hPlayer = NULL_HANDLE;
+	m_cRewind.clear();
+	m_cLevelStart.clear();
 
 	m_stlNameToObjectType.erase(m_stlNameToObjectType.begin(), m_stlNameToObjectType.end());
 	m_stlNameToObjectType.clear();
 } //clear
 
-/// Move all game objects, while making sure that they wrap around the world correctly.
+/// Move every entity in the entity store along its velocity, and note which
+/// edges of the arena it is past for the walled objects to react to. The
+/// edges are worked out once here. Only the transform and velocity arrays
+/// are touched, chunk by chunk.
+
+void CObjectManager::integrate(){
+  ARENABOUNDS bounds;
+  bounds.m_fLeft = m_pWorld->m_fScreenScroll - (g_nScreenWidth/2.0f) + ARENA_SIDE_MARGIN;
+  bounds.m_fRight = m_pWorld->m_fScreenScroll + (g_nScreenWidth/2.0f) - ARENA_SIDE_MARGIN;
+  bounds.m_fBottom = ARENA_BOTTOM;
+  bounds.m_fTop = g_nScreenHeight + ARENA_TOP_MARGIN;
+  m_cIntegrator.SetFrame(m_pWorld->m_cTimer.microtime(), bounds);
+
+  m_cEntities.ForEachChunk(TRANSFORM_COMPONENT | VELOCITY_COMPONENT, [this](ENTITYCHUNK& c){
+    m_cIntegrator.integrate(c);
+  }); //ForEachChunk
+} //integrate
+
+/// Get the edges of the arena, as worked out for this frame's integration.
+/// \return Edges of the arena.
+
+const ARENABOUNDS& CObjectManager::GetArenaBounds(){
+  return m_cIntegrator.GetBounds();
+} //GetArenaBounds
+
+/// Put each object in the object list into the move bucket for its type, in
+/// list order, so that objects of the same move kind are moved together by
+/// the same code and in the same order every run. Objects that move does
+/// nothing to are left out.
+
+void CObjectManager::FillMoveBuckets(){
+  for(int k=0; k<NUM_MOVE_BUCKETS; k++)
+    m_pMoveBucket[k].clear();
+
+  for(CGameObject* p: m_stlObjectList){
+    const int k = GetMoveBucket(p->m_nObjectType);
+    if(k >= 0)m_pMoveBucket[k].push_back(p);
+  } //for
+} //FillMoveBuckets
 
-void CObjectManager::move(){
-  const float dX = (float)g_nScreenWidth; // Wrap distance from player.
+/// Move all game objects. They are all moved along their velocities first,
+/// and then each one reacts to where it has got to, a move bucket at a time
+/// in the order of g_nMoveKind.
 
-	///find the player
-  auto fredIterator = GetPlayerObject();
-  CGameObject* fredObject = GetPlayerObjectPtr();
- 
-  //move nonplayer objects
-  for(auto i=m_stlObjectList.begin(); i!=m_stlObjectList.end();){ //for each object
-    CGameObject* curObject = *i++; //current object
-    curObject->move(); //move it
-	
-    //wrap objects a fixed distance from player
-    if(curObject != fredObject){ //not the player
-      float fredX=0.0f; //player's X coordinate
-      if(fredIterator != m_stlNameToObject.end())
-        fredX = fredObject->m_vPos.x;
+void CObjectManager::move(){
+  integrate(); //motion
 
-     float& x = curObject->m_vPos.x; //X coordinate of current object
-    } //if
-  } //for 
+  //react to where they got to, one move kind at a time
+  FillMoveBuckets();
+  for(int k=0; k<NUM_MOVE_BUCKETS; k++)
+    CGameObject::m_pMoveBucket[k](m_pMoveBucket[k]);
   
   CollisionDetection(); //collision detection
-  cull(); //cull old objects
-  GarbageCollect(); //bring out yer dead!
+  FireTimerEvents(); //think, animate, and cull old objects
+  GarbageCollect(); //bring out yer dead! (and bring in the newborn)
+
+  CGameObject* fredObject = GetPlayerObjectPtr(); //the old one may have been collected
+  if(fredObject == nullptr)return;
 
   if(fredObject->m_nObjectType == SWAZIDLE_OBJECT){
-	  g_bPlayerIsInvulnerable = (fredObject->m_nObjectType == SWAZHURT_OBJECT)
-	  && (g_cTimer.time() < m_nStartInvulnerableTime + fredObject->m_nInvulnerableTime);
+	  m_pWorld->m_bPlayerIsInvulnerable = (fredObject->m_nObjectType == SWAZHURT_OBJECT)
+	  && (m_pWorld->m_cTimer.time() < m_nStartInvulnerableTime + fredObject->invulnerableTime());
 	  
   }
   else if(fredObject->m_nObjectType == POLKIDLE_OBJECT){
-	  g_bPlayerIsInvulnerable = (fredObject->m_nObjectType == POLKHURT_OBJECT)
-		  && (g_cTimer.time() < m_nStartInvulnerableTime + fredObject->m_nInvulnerableTime);
+	  m_pWorld->m_bPlayerIsInvulnerable = (fredObject->m_nObjectType == POLKHURT_OBJECT)
+		  && (m_pWorld->m_cTimer.time() < m_nStartInvulnerableTime + fredObject->invulnerableTime());
 	}
 	else{
-		g_bPlayerIsInvulnerable = (fredObject->m_nObjectType == FREDHURT_OBJECT)
-			&& (g_cTimer.time() < m_nStartInvulnerableTime + fredObject->m_nInvulnerableTime);
+		m_pWorld->m_bPlayerIsInvulnerable = (fredObject->m_nObjectType == FREDHURT_OBJECT)
+			&& (m_pWorld->m_cTimer.time() < m_nStartInvulnerableTime + fredObject->invulnerableTime());
 	}
 } //move
 
 /// Draw the objects from the object list and the player object. Care
-/// must be taken to draw them from back to front.
+/// must be taken to draw them from back to front, which the depth layers do.
 
 void CObjectManager::draw(){
-  m_stlObjectList.sort(ZCompare); //depth sort
-  for(auto i = m_stlObjectList.begin(); i != m_stlObjectList.end(); i++) //for each object
-    (*i)->draw();
+  m_cDepthLayers.draw();
 } //draw
 
 /// Get a pointer to an object by name, nullptr if it doesn't exist.
@@ -210,13 +497,18 @@ void CObjectManager::draw(){
 /// \return Pointer to object created with that name, if it exists.
 
 CGameObject* CObjectManager::GetObjectByName(const char* name){ 
-  unordered_map<string, CGameObject*>::iterator 
-    current = m_stlNameToObject.find((string)name);
-  if(current != m_stlNameToObject.end())
-    return current->second;
-  else return nullptr;
+  return m_cRegistry.resolve(m_cRegistry.GetHandle(m_cRegistry.FindSlot(name)));
 } //GetObjectByName
 
+/// Get a pointer to an object by handle, nullptr if it has been replaced
+/// or collected since the handle was issued.
+/// \param h Handle to object.
+/// \return Pointer to object, if it still exists.
+
+CGameObject* CObjectManager::GetObjectByHandle(ObjectHandle h){
+  return m_cRegistry.resolve(h);
+} //GetObjectByHandle
+
 /// Distance between objects.
 /// \param pointer to first object 
 /// \param pointer to second object
@@ -225,8 +517,8 @@ CGameObject* CObjectManager::GetObjectByName(const char* name){
 float CObjectManager::distance(CGameObject *g0, CGameObject *g1){ 
   if(g0 == nullptr || g1 == nullptr)return -1; //bail if bad pointer
   const float fWorldWidth = 2.0f * (float)g_nScreenWidth; //world width
-  float x = (float)fabs(g0->m_vPos.x - g1->m_vPos.x); //x distance
-  float y = (float)fabs(g0->m_vPos.y - g1->m_vPos.y); //y distance
+  float x = (float)fabs(g0->position().x - g1->position().x); //x distance
+  float y = (float)fabs(g0->position().y - g1->position().y); //y distance
   if(x > fWorldWidth) x -= (float)fWorldWidth; //compensate for wrap-around world
   return sqrtf(x*x + y*y);
 } //distance
@@ -234,13 +526,12 @@ float CObjectManager::distance(CGameObject *g0, CGameObject *g1){
 /// Fire a letter shot
 
 void CObjectManager::FireGun(){   
-  std::unordered_map<std::string, CGameObject*>::iterator fredIterator = GetPlayerObject();
-  if(fredIterator == m_stlNameToObject.end())return; //this should of course never happen
-  const CGameObject* fredObject = fredIterator->second;
-	if(fredObject->m_nObjectType == FREDHURT_OBJECT || fredObject->m_nObjectType == SWAZHURT_OBJECT || fredObject->m_nObjectType == POLKHURT_OBJECT)return; //dead players can't fire letters
-  if(fredObject->m_bCanFire == FALSE)return; //Can't fire if end of level reached
-  if(g_cTimer.elapsed(m_nLastGunFireTime, 200)){ //slow down firing rate
-    const float fAngle = fredObject->m_fOrientation;
+  CGameObject* fredObject = GetPlayerObjectPtr();
+  if(fredObject == nullptr)return; //this should of course never happen
+	if(HasTrait(fredObject->m_nObjectType, HURTPLAYER_TRAIT))return; //dead players can't fire letters
+  if(!fredObject->GetFlag(CANFIRE_FLAG))return; //Can't fire if end of level reached
+  if(m_pWorld->m_cTimer.elapsed(m_nLastGunFireTime, 200)){ //slow down firing rate
+    const float fAngle = fredObject->orientation();
     const float fSine = sin(fAngle);
     const float fCosine = cos(fAngle);
 
@@ -249,7 +540,7 @@ void CObjectManager::FireGun(){
     const float fGunDy =  5.0f;
 
     //initial bullet position
-    const Vector3 s = fredObject->m_vPos +
+    const Vector3 s = fredObject->position() +
       Vector3(fGunDx*fCosine - fGunDy*fSine, fGunDx*fSine - fGunDy*fCosine, 0); 
 
     //velocity of bullet
@@ -258,17 +549,17 @@ void CObjectManager::FireGun(){
 	  
 		if(fredObject->m_nObjectType == FREDATTACK_OBJECT){
 			createObject(PROJECTILEF_OBJECT, "projectileF", s, v); //create bullet
-			if(g_bAssistActive)
+			if(m_pWorld->m_bAssistActive)
 			createObject(PROJECTILEF_OBJECT, "projectileF", Vector3(s.x, s.y - 35, s.z), v); //create bullet
 		}
 		else if(fredObject->m_nObjectType == SWAZATTACK_OBJECT){
 			createObject(PROJECTILES_OBJECT, "projectileS", s, v); //create bullet
-			if(g_bAssistActive)
+			if(m_pWorld->m_bAssistActive)
 				createObject(PROJECTILES_OBJECT, "projectileS", Vector3(s.x, s.y - 35, s.z), v); //create bullet
 		}
 		else if(fredObject->m_nObjectType == POLKATTACK_OBJECT){
 			createObject(PROJECTILEP_OBJECT, "projectileP", s, v); //create bullet
-			if(g_bAssistActive)
+			if(m_pWorld->m_bAssistActive)
 				createObject(PROJECTILEP_OBJECT, "projectileP", Vector3(s.x, s.y - 35, s.z), v); //create bullet
 		}
 		m_nFiredShots += 1;
@@ -278,13 +569,12 @@ void CObjectManager::FireGun(){
 /// Fires pierce shot that goes through all enemies
 
 void CObjectManager::FirePierce(){
-	std::unordered_map<std::string, CGameObject*>::iterator fredIterator = GetPlayerObject();
-	if(fredIterator == m_stlNameToObject.end())return; //this should of course never happen
-	const CGameObject* fredObject = fredIterator->second;
-	if(fredObject->m_nObjectType == FREDHURT_OBJECT || fredObject->m_nObjectType == SWAZHURT_OBJECT || fredObject->m_nObjectType == POLKHURT_OBJECT)return; //hurt players can't fire pierce shots
-	if(fredObject->m_bCanFire == FALSE)return; //Can't fire if end of level reached
-	if(g_cTimer.elapsed(m_nLastGunFireTime, 200)){ //slow down firing rate
-		const float fAngle = fredObject->m_fOrientation;
+	CGameObject* fredObject = GetPlayerObjectPtr();
+	if(fredObject == nullptr)return; //this should of course never happen
+	if(HasTrait(fredObject->m_nObjectType, HURTPLAYER_TRAIT))return; //hurt players can't fire pierce shots
+	if(!fredObject->GetFlag(CANFIRE_FLAG))return; //Can't fire if end of level reached
+	if(m_pWorld->m_cTimer.elapsed(m_nLastGunFireTime, 200)){ //slow down firing rate
+		const float fAngle = fredObject->orientation();
 		const float fSine = sin(fAngle);
 		const float fCosine = cos(fAngle);
 
@@ -293,7 +583,7 @@ void CObjectManager::FirePierce(){
 		const float fGunDy = 5.0f;
 
 		//initial bullet position
-		const Vector3 s = fredObject->m_vPos +
+		const Vector3 s = fredObject->position() +
 			Vector3(fGunDx*fCosine - fGunDy*fSine, fGunDx*fSine - fGunDy*fCosine, 0);
 
 		//velocity of bullet
@@ -302,17 +592,17 @@ void CObjectManager::FirePierce(){
 
 		if(fredObject->m_nObjectType == FREDATTACK_OBJECT){
 			createObject(PROJECTILED_OBJECT, "projectileD", s, v); //create bullet
-			if(g_bAssistActive)
+			if(m_pWorld->m_bAssistActive)
 				createObject(PROJECTILED_OBJECT, "projectileD", Vector3(s.x, s.y - 35, s.z), v); //create bullet
 		}
 		else if(fredObject->m_nObjectType == SWAZATTACK_OBJECT){
 			createObject(PROJECTILEZ_OBJECT, "projectileZ", s, v); //create bullet
-			if(g_bAssistActive)
+			if(m_pWorld->m_bAssistActive)
 				createObject(PROJECTILEZ_OBJECT, "projectileZ", Vector3(s.x, s.y - 35, s.z), v); //create bullet
 		}
 		else if(fredObject->m_nObjectType == POLKATTACK_OBJECT){
 			createObject(PROJECTILEK_OBJECT, "projectileK", s, v); //create bullet
-			if(g_bAssistActive)
+			if(m_pWorld->m_bAssistActive)
 				createObject(PROJECTILEK_OBJECT, "projectileK", Vector3(s.x, s.y - 35, s.z), v); //create bullet
 		}
 		reduceAmmoCount(2);
@@ -323,14 +613,13 @@ void CObjectManager::FirePierce(){
 /// Activates shield, protecting player for one shot
 
 void CObjectManager::CreateShield(){
-	std::unordered_map<std::string, CGameObject*>::iterator fredIterator = GetPlayerObject();
-	if(fredIterator == m_stlNameToObject.end())return; //this should of course never happen
-	const CGameObject* fredObject = fredIterator->second;
-	if(fredObject->m_nObjectType == FREDHURT_OBJECT || fredObject->m_nObjectType == SWAZHURT_OBJECT || fredObject->m_nObjectType == POLKHURT_OBJECT)return; //hurt players can't activate shields
-	if(fredObject->m_bCanFire == FALSE)return; //Can't fire if end of level reached
+	CGameObject* fredObject = GetPlayerObjectPtr();
+	if(fredObject == nullptr)return; //this should of course never happen
+	if(HasTrait(fredObject->m_nObjectType, HURTPLAYER_TRAIT))return; //hurt players can't activate shields
+	if(!fredObject->GetFlag(CANFIRE_FLAG))return; //Can't fire if end of level reached
 
 	//initial shield position
-	const Vector3 s = fredObject->m_vPos;
+	const Vector3 s = fredObject->position();
 
 	createObject(SHIELD_OBJECT, "shield", s, Vector3(0,0,0)); //create bullet
 	reduceAmmoCount(0);
@@ -339,12 +628,11 @@ void CObjectManager::CreateShield(){
 /// Activates assist, giving player double shots
 
 void CObjectManager::CreateAssist(){
-	std::unordered_map<std::string, CGameObject*>::iterator fredIterator = GetPlayerObject();
-	if(fredIterator == m_stlNameToObject.end())return; //this should of course never happen
-	const CGameObject* fredObject = fredIterator->second;
-	if(fredObject->m_nObjectType == FREDHURT_OBJECT || fredObject->m_nObjectType == SWAZHURT_OBJECT || fredObject->m_nObjectType == POLKHURT_OBJECT)return; //hurt characters can't summon assists
-	if(fredObject->m_bCanFire == FALSE)return; //Can't fire if end of level reached
-	const float fAngle = fredObject->m_fOrientation;
+	CGameObject* fredObject = GetPlayerObjectPtr();
+	if(fredObject == nullptr)return; //this should of course never happen
+	if(HasTrait(fredObject->m_nObjectType, HURTPLAYER_TRAIT))return; //hurt characters can't summon assists
+	if(!fredObject->GetFlag(CANFIRE_FLAG))return; //Can't fire if end of level reached
+	const float fAngle = fredObject->orientation();
 	const float fSine = sin(fAngle);
 	const float fCosine = cos(fAngle);
 
@@ -353,7 +641,7 @@ void CObjectManager::CreateAssist(){
 	const float fGunDy = 17.0f;
 
 	//initial bullet position
-	const Vector3 s = fredObject->m_vPos +
+	const Vector3 s = fredObject->position() +
 		Vector3(fGunDx*fCosine - fGunDy*fSine, fGunDx*fSine - fGunDy*fCosine, 0);
 
 	if(fredObject->m_nObjectType == FREDATTACK_OBJECT)
@@ -366,330 +654,243 @@ void CObjectManager::CreateAssist(){
 	reduceAmmoCount(1);
 } //CreateAssist
 
-/// Cull old objects.
-/// Run through the objects in the object list and compare their age to
-/// their life span. Kill any that are too old. Immortal objects are
-/// flagged with a negative life span, so ignore those.
-
-void CObjectManager::cull(){ 
-  for(auto i=m_stlObjectList.begin(); i!=m_stlObjectList.end();){
-    CGameObject* object = *i++; //current object
-
-    //died of old age
-    if(object->m_nLifeTime > 0 && //if mortal and ...
-    (g_cTimer.time() - object->m_nBirthTime > object->m_nLifeTime)){ //...old...
-			m_bDiedOfAge = TRUE;
-      object->kill(); //slay it
-      CreateNextIncarnation(object); //create next in the animation sequence
-    } //if
-
-    //one shot animation 
-    if(object->m_nFrameCount > 1 && !object->m_bCycleSprite && //if plays one time...
-      object->m_nCurrentFrame >= object->m_nAnimationFrameCount){ //and played once already...
+/// Get the type of the current player incarnation, for the keyboard handlers
+/// to decide what a key does.
+/// \return Player type, NUM_OBJECT_TYPES if there is no player.
+
+ObjectType CObjectManager::GetPlayerType(){
+	CGameObject* player = m_pWorld->m_pPlayer;
+	return player? player->m_nObjectType: NUM_OBJECT_TYPES;
+} //GetPlayerType
+
+/// Start the player moving when an arrow key is pressed. It moves a little
+/// faster to the right, the way that the screen scrolls.
+/// \param d Direction.
+
+void CObjectManager::MovePlayer(DirectionType d){
+	CGameObject* player = m_pWorld->m_pPlayer;
+	if(player == nullptr)return;
+
+	switch(d){
+		case UP_DIRECTION: player->velocity().y = 5.0f*m_nPlayerSpeed; break;
+		case DOWN_DIRECTION: player->velocity().y = -5.0f*m_nPlayerSpeed; break;
+		case LEFT_DIRECTION: player->velocity().x = -5.0f*m_nPlayerSpeed; break;
+		case RIGHT_DIRECTION: player->velocity().x = 6.0f*m_nPlayerSpeed; break;
+	} //switch
+} //MovePlayer
+
+/// Stop the player moving when an arrow key is released, if it is still
+/// moving that way.
+/// \param d Direction.
+
+void CObjectManager::StopPlayer(DirectionType d){
+	CGameObject* player = m_pWorld->m_pPlayer;
+	if(player == nullptr)return;
+
+	Vector3& v = player->velocity();
+	switch(d){
+		case UP_DIRECTION: if(v.y > 0)v.y = 0; break;
+		case DOWN_DIRECTION: if(v.y < 0)v.y = 0; break;
+		case LEFT_DIRECTION: if(v.x < 0)v.x = 0; break;
+		case RIGHT_DIRECTION: if(v.x > 0)v.x = 0; break;
+	} //switch
+} //StopPlayer
+
+/// Turn the player into its attack incarnation where it is, before it fires
+/// or uses an item.
+/// \param t Type of the attack incarnation.
+/// \param name Name of the attack incarnation in the XML settings file.
+
+void CObjectManager::PlayerAttack(ObjectType t, const char* name){
+	CGameObject*& player = m_pWorld->m_pPlayer;
+	if(player != nullptr)
+		player = ChangeIncarnation(player, t, name, player->position(), player->velocity());
+} //PlayerAttack
+
+/// Fire a letter shot if the player is the character that the fire key
+/// belongs to, idle or already attacking.
+/// \param idle Idle type of the character.
+/// \param attack Attack type of the character.
+/// \param name Name of the attack incarnation in the XML settings file.
+
+void CObjectManager::FireAs(ObjectType idle, ObjectType attack, const char* name){
+	const ObjectType t = GetPlayerType();
+	if(t == idle || t == attack){
+		PlayerAttack(attack, name);
+		FireGun();
+	} //if
+} //FireAs
+
+/// Act on the timer events that are due. Objects only appear here when
+/// something is due to happen to them, instead of every object being
+/// checked every frame. Events of objects that are already dead, or that
+/// were scheduled again after they came out of the wheel, are dropped.
+/// Objects whose life span is over are killed and replaced by their next
+/// incarnation, and so are objects whose sprite plays once when it has
+/// played.
+
+void CObjectManager::FireTimerEvents(){ 
+  m_pFiredEvents.clear();
+  m_cTimerWheel.advance(m_pWorld->m_cTimer.time(), m_pFiredEvents);
+
+  for(size_t i=0; i<m_pFiredEvents.size(); i++){
+    TIMERNODE* node = m_pFiredEvents[i];
+    CGameObject* object = node->m_pObject;
+    if(object->GetFlag(DEAD_FLAG))continue;
+    if(CTimerWheel::pending(*node))continue; //asked for again since, by a new incarnation
+
+    switch(node->m_nEvent){
+      case THINK_EVENT: //intelligent objects are the only ones that ask for this
+        static_cast<CIntelligentObject*>(object)->think();
+        break;
+
+      case FRAME_EVENT:
+        if(object->AdvanceFrame() && object->frameCount() > 1){ //one shot animation is over
+          object->kill(); //slay it
+          CreateNextIncarnation(object); //create next in the animation sequence
+        } //if
+        break;
+
+      case FLY_EVENT:
+        object->fly();
+        break;
+
+      case EXPIRE_EVENT: //died of old age
+        m_bDiedOfAge = TRUE;
         object->kill(); //slay it
         CreateNextIncarnation(object); //create next in the animation sequence
-    } //if
+        break;
+
+      default: break;
+    } //switch
   } //for
-} //cull
+} //FireTimerEvents
 
-/// Get an iterator to the player object, which may be Fred, Swaz, or Polk.
-/// \return Iterator to the player object.
+/// Put a timer event into the timer wheel, or move it if it is already
+/// there.
+/// \param node Timer event node of the object.
+/// \param due Time the event is due, in ms.
 
-unordered_map<string, CGameObject*>::iterator  CObjectManager::GetPlayerObject(){
-  auto i = m_stlNameToObject.find("fredIdle");
-  
-  if(i != m_stlNameToObject.end())return i; 
-  else{i = m_stlNameToObject.find("fredAttack");
-    if(i != m_stlNameToObject.end())return i; 
-	else{i = m_stlNameToObject.find("fredHurt");
-      if(i != m_stlNameToObject.end())return i; 
-	  else{i = m_stlNameToObject.find("fredLost");
-		if (i != m_stlNameToObject.end())return i; 
-		else{i = m_stlNameToObject.find("swazIdle");
-		  if (i != m_stlNameToObject.end())return i;
-		  else {i = m_stlNameToObject.find("swazAttack");
-			if (i != m_stlNameToObject.end())return i;
-			 else {i = m_stlNameToObject.find("swazHurt");
-			  if (i != m_stlNameToObject.end())return i;
-			  else {i = m_stlNameToObject.find("swazLost");
-  			    if (i != m_stlNameToObject.end())return i;
-			    else {i = m_stlNameToObject.find("polkIdle");
-				  if (i != m_stlNameToObject.end())return i;
-				  else {i = m_stlNameToObject.find("polkAttack");
-					if (i != m_stlNameToObject.end())return i;
-					else {i = m_stlNameToObject.find("polkHurt");
-					  if (i != m_stlNameToObject.end())return i;
-						else {return m_stlNameToObject.find("polkLost");
-							  }
-						  }
-						}
-					 }
-				  }
-			  }
-		  }
-		} //else
-	  } //else
-    } //else
-  } //else
+void CObjectManager::ScheduleEvent(TIMERNODE& node, int due){
+  m_cTimerWheel.schedule(node, due);
+} //ScheduleEvent
+
+/// Get a handle to the player object, which may be Fred, Swaz, or Polk.
+/// This is whichever player incarnation was created most recently. The
+/// handle goes stale when that incarnation is unregistered or collected.
+/// \return Handle to the player object.
+
+ObjectHandle CObjectManager::GetPlayerObject(){
+  return m_hPlayer;
 } //GetPlayerObject
 
 /// Get a pointer to the player object
 
 CGameObject* CObjectManager::GetPlayerObjectPtr(){
-  auto i = GetPlayerObject();
-  if(i != m_stlNameToObject.end())
-    return (*i).second;
-  else return nullptr;
+  return m_cRegistry.resolve(GetPlayerObject());
 } //GetPlayerObjectPtr
 
+/// Check whether an incarnation transition should be taken.
+/// \param when Transition condition.
+/// \param object Pointer to the object that died.
+/// \return TRUE if the condition holds.
+
+BOOL CObjectManager::TransitionHolds(TransitionType when, CGameObject* object){
+  switch(when){
+    case ALWAYS_TRANSITION: return TRUE;
+    case DIEDOFDMG_TRANSITION: return m_bDiedOfDmg;
+    case PLAYERHIT_TRANSITION: return m_bPlayerHit;
+    case DIEDOFAGE_TRANSITION: return m_bDiedOfAge;
+    case DIEDOFSPECIAL_TRANSITION: return m_bDiedOfSpecial;
+    case HEALTHY_TRANSITION: return m_bDiedOfAge && object->HasComponent(COLLIDER_COMPONENT) && object->health() >= 1;
+    default: return FALSE;
+  } //switch
+} //TransitionHolds
+
 /// Create the object next in the appropriate series (object, exploding
-/// object, dead object). If there's no "next" object, do nothing.
+/// object, dead object). If there's no "next" object, do nothing. Most types
+/// are looked up in the transition table, and the object is changed into its
+/// next incarnation in place if possible.
 /// \param object Pointer to the object to be replaced
 
 void CObjectManager::CreateNextIncarnation(CGameObject* object){ 
-  Vector3 p = object->m_vPos, v = object->m_vVelocity;
-  auto i = GetPlayerObject();
+  Vector3 p = object->position();
+  Vector3 v = object->HasComponent(VELOCITY_COMPONENT)? object->velocity(): Vector3(0.0f, 0.0f, 0.0f);
+  const int m = sizeof(g_sTransition)/sizeof(TRANSITION); //number of transitions
+
+  for(int k=m_nFirstTransition[object->m_nObjectType]; k>=0 && k<m && g_sTransition[k].m_nFrom == object->m_nObjectType; k++){
+    const TRANSITION& t = g_sTransition[k];
+    if(!TransitionHolds(t.m_nWhen, object))continue;
+
+    if(t.m_nFlags & TRANSITION_SETVELOCITY){
+      v = Vector3(t.m_fVx, t.m_fVy, 0.0f);
+      if(t.m_nFlags & TRANSITION_RANDOMY)
+        v.y *= (float)m_pWorld->m_cRandom.number(-1, 1);
+    } //if
+    if(t.m_nFlags & TRANSITION_SETZ)p.z = t.m_fZ;
+    else if(t.m_nFlags & TRANSITION_OFFSETZ)p.z += t.m_fZ;
+
+    const int health = (t.m_nFlags & TRANSITION_KEEPHEALTH) && object->HasComponent(COLLIDER_COMPONENT)? object->health(): -1;
+    CGameObject* next = ChangeIncarnation(object, t.m_nTo, t.m_szName, p, v, health);
+    if(next->m_pCold->m_hHandle != NULL_HANDLE && next->m_pCold->m_hHandle == m_hPlayer)
+      m_pWorld->m_pPlayer = next;
+
+    if(t.m_nFlags & TRANSITION_INVULNERABLE)
+      m_nStartInvulnerableTime = m_pWorld->m_cTimer.time(); //make invulnerable
+    if(t.m_nFlags & TRANSITION_RESETAGE)
+      m_bDiedOfAge = FALSE;
+    return;
+  } //for
 
   switch(object->m_nObjectType){
-    case FREDIDLE_OBJECT: 
-			if(i != m_stlNameToObject.end()) //if name in map
-				m_stlNameToObject.erase(i); //erase it
-			if(!m_bDiedOfDmg)
-				player = createObject(FREDHURT_OBJECT, "fredHurt", p, v);
-			else
-				player = createObject(FREDLOST_OBJECT, "fredLost", p, v);
-			m_nStartInvulnerableTime = g_cTimer.time(); //make invulnerable
-			break;
-
-		case FREDATTACK_OBJECT:
-			if(i != m_stlNameToObject.end()) //if name in map
-				m_stlNameToObject.erase(i); //erase it
-			if(m_bDiedOfDmg){
-				player = createObject(FREDLOST_OBJECT, "fredLost", p, v);
-			}
-			else if(m_bPlayerHit){
-				player = createObject(FREDHURT_OBJECT, "fredHurt", p, v);
-				m_nStartInvulnerableTime = g_cTimer.time(); //make invulnerable
-			}
-			else if(m_bDiedOfAge){
-				player = createObject(FREDIDLE_OBJECT, "fredIdle", p, v);
-				m_bDiedOfAge = FALSE;
-			}
-			//m_nStartInvulnerableTime = g_cTimer.time(); //make invulnerable
-			break;
-
-		case FREDHURT_OBJECT:
-			if(i != m_stlNameToObject.end()) //if name in map
-				m_stlNameToObject.erase(i); //erase it
-				player = createObject(FREDIDLE_OBJECT, "fredIdle", p, v);
-			break;
-
-		case SWAZIDLE_OBJECT:
-			if(i != m_stlNameToObject.end()) //if name in map
-				m_stlNameToObject.erase(i); //erase it
-			if(!m_bDiedOfDmg)
-				player = createObject(SWAZHURT_OBJECT, "swazHurt", p, v);
-			else
-				player = createObject(SWAZLOST_OBJECT, "swazLost", p, v);
-			m_nStartInvulnerableTime = g_cTimer.time(); //make invulnerable
-			break;
-
-		case SWAZATTACK_OBJECT:
-			if(i != m_stlNameToObject.end()){ //if name in map
-				m_stlNameToObject.erase(i); //erase it
-			}
-			if(m_bDiedOfDmg){
-				player = createObject(SWAZLOST_OBJECT, "swazLost", p, v);
-				m_nStartInvulnerableTime = g_cTimer.time(); //make invulnerable
-			}
-			else if(m_bPlayerHit){
-				player = createObject(SWAZHURT_OBJECT, "swazHurt", p, v);
-				m_nStartInvulnerableTime = g_cTimer.time(); //make invulnerable
-			}
-			else if(m_bDiedOfAge){
-				player = createObject(SWAZIDLE_OBJECT, "swazIdle", p, v);
-				m_bDiedOfAge = FALSE;
-			}
-			break;
-
-		case SWAZHURT_OBJECT:
-			if(i != m_stlNameToObject.end()) //if name in map
-				m_stlNameToObject.erase(i); //erase it
-			player = createObject(SWAZIDLE_OBJECT, "swazIdle", p, v);
-			break;
-
-		case POLKIDLE_OBJECT:
-			if(i != m_stlNameToObject.end()) //if name in map
-				m_stlNameToObject.erase(i); //erase it
-			if(!m_bDiedOfDmg)
-				player = createObject(POLKHURT_OBJECT, "polkHurt", p, v);
-			else
-				player = createObject(POLKLOST_OBJECT, "polkLost", p, v);
-			m_nStartInvulnerableTime = g_cTimer.time(); //make invulnerable
-			break;
-
-		case POLKATTACK_OBJECT:
-			if(i != m_stlNameToObject.end()){ //if name in map
-				m_stlNameToObject.erase(i); //erase it
-			}
-			if(m_bDiedOfDmg){
-				player = createObject(POLKLOST_OBJECT, "polkLost", p, v);
-				m_nStartInvulnerableTime = g_cTimer.time(); //make invulnerable
-			}
-			else if(m_bPlayerHit){
-				player = createObject(POLKHURT_OBJECT, "polkHurt", p, v);
-				m_nStartInvulnerableTime = g_cTimer.time(); //make invulnerable
-			}
-			else if(m_bDiedOfAge){
-				player = createObject(POLKIDLE_OBJECT, "polkIdle", p, v);
-				m_bDiedOfAge = FALSE;
-			}
-			break;
-
-		case POLKHURT_OBJECT:
-			if(i != m_stlNameToObject.end()) //if name in map
-				m_stlNameToObject.erase(i); //erase it
-			player = createObject(POLKIDLE_OBJECT, "polkIdle", p, v);
-			break;
-
-		case ENEMY1AFTER_OBJECT:
-			createObject(ENEMY1HURT_OBJECT, "enemy1Hurt", p, v, object->m_nHealth);
-			break;
-
-		case ENEMY1IDLE_OBJECT:
-			createObject(ENEMY1HURT_OBJECT, "enemy1Hurt", p, v, object->m_nHealth);
-			break;
-
-		case ENEMY1HURT_OBJECT:
-			if(m_bDiedOfAge){
-				if(object->m_nHealth >= 1) 
-					createObject(ENEMY1AFTER_OBJECT, "enemy1Idle", p, v, object->m_nHealth);
-				else
-					createObject(ENEMYEXIT_OBJECT, "enemyExit", Vector3(p.x, p.y, 376), Vector3(0, 0, 0));
-			}
-			break;
-
-		case ENEMYINVADERIDLE_OBJECT:
-			createObject(ENEMYINVADERHURT_OBJECT, "enemyInvaderHurt", p, v, object->m_nHealth);
-			break;
-
-		case ENEMYINVADERATTACK_OBJECT:
-			if(m_bDiedOfAge)
-				createObject(ENEMYINVADERIDLE_OBJECT, "enemyInvaderIdle", p, v, object->m_nHealth);
-			else
-				createObject(ENEMYINVADERHURT_OBJECT, "enemyInvaderHurt", p, v, object->m_nHealth);
-			break;
-
-		case ENEMYINVADERHURT_OBJECT:
-			if(m_bDiedOfAge){
-				if (object->m_nHealth >= 1)
-				createObject(ENEMYINVADERIDLE_OBJECT, "enemyInvaderIdle", p, v, object->m_nHealth);
-				else
-				createObject(ENEMYEXIT_OBJECT, "enemyExit", Vector3(p.x, p.y, 376), Vector3(0, 0, 0));
-			}
-			break;
-
-		case ENEMYZOOMERIDLE_OBJECT:
-			createObject(ENEMYZOOMERHURT_OBJECT, "enemyZoomerHurt", p, v, object->m_nHealth);
-			break;
-
-		case ENEMYZOOMERIDLEFLIP_OBJECT:
-			createObject(ENEMYZOOMERHURT_OBJECT, "enemyZoomerHurt", p, v, object->m_nHealth);
-			break;
-
-		case ENEMYZOOMERBOUNCE_OBJECT:
-			if(m_bDiedOfSpecial)
-				createObject(ENEMYZOOMERHURT_OBJECT, "enemyZoomerHurt", p, v, object->m_nHealth);
-			else
-				createObject(ENEMYZOOMERIDLEFLIP_OBJECT, "enemyZoomerIdleFlip", p, Vector3(15.0f, 0, 0), object->m_nHealth);
-			break;
-
-		case ENEMYZOOMERBOUNCEFLIP_OBJECT:
-			if(m_bDiedOfSpecial)
-				createObject(ENEMYZOOMERHURT_OBJECT, "enemyZoomerHurt", p, v, object->m_nHealth);
-			else
-				createObject(ENEMYZOOMERIDLE_OBJECT, "enemyZoomerIdle", p, Vector3(-15.0f, 0, 0), object->m_nHealth);
-			break;
-
-		case ENEMYZOOMERHURT_OBJECT:
-			if(m_bDiedOfAge){
-				if (object->m_nHealth >= 1)
-					createObject(ENEMYZOOMERIDLE_OBJECT, "enemyZoomerIdle", p, Vector3(-15.0f, 0, 0), object->m_nHealth);
-				else
-					createObject(ENEMYEXIT_OBJECT, "enemyExit", Vector3(p.x, p.y, 376), Vector3(0, 0, 0));
-			}
-			break;
-
-		case ENEMYTHIEFIDLE_OBJECT:
-			createObject(ENEMYTHIEFHURT_OBJECT, "enemyThiefHurt", p, v, object->m_nHealth);
-			break;
-
-		case ENEMYTHIEFATTACK_OBJECT:
-			if(m_bDiedOfAge){
-				int randDir = g_cRandom.number(-1, 1);
-				createObject(ENEMYTHIEFIDLE_OBJECT, "enemyThiefIdle", p, Vector3(1.5f, 3.0f * randDir, 0.0f), object->m_nHealth);
-			}
-			else
-				createObject(ENEMYTHIEFHURT_OBJECT, "enemyThiefHurt", p, v, object->m_nHealth);
-			break;
-
-		case ENEMYTHIEFHURT_OBJECT:
-			if(m_bDiedOfAge){
-				if (object->m_nHealth >= 1)
-					createObject(ENEMYTHIEFIDLE_OBJECT, "enemyThiefIdle", p, v, object->m_nHealth);
-				else
-					createObject(ENEMYEXIT_OBJECT, "enemyExit", p, Vector3(0.0f, 0.0f, 0.0f), object->m_nHealth);
-			}
-			break;
-
 		//depending on the stage, it will randomly spawn enemies from the  entrance clouds
 		case ENEMYENTRY_OBJECT:
 			if(m_bDiedOfAge){
-				if(g_nLevelState == COMICWORLD_STATE){
-					int randEnemy = g_cRandom.number(1, 2);
+				if(m_pWorld->m_nLevelState == COMICWORLD_STATE){
+					int randEnemy = m_pWorld->m_cRandom.number(1, 2);
 					switch (randEnemy){
 					case 1:
-						createObject(ENEMYZOOMERIDLE_OBJECT, "enemyZoomerIdle", p, Vector3(-15.0f, v.y, v.z));
+						ChangeIncarnation(object, ENEMYZOOMERIDLE_OBJECT, "enemyZoomerIdle", p, Vector3(-15.0f, v.y, v.z));
 						break;
 
 					case 2:
-						createObject(ENEMY1IDLE_OBJECT, "enemy1Idle", p, v);
+						ChangeIncarnation(object, ENEMY1IDLE_OBJECT, "enemy1Idle", p, v);
 						break;
 					} //switch
 				} //if
-				else if(g_nLevelState == FANTASY_STATE){
-					int randEnemy = g_cRandom.number(1, 3);
+				else if(m_pWorld->m_nLevelState == FANTASY_STATE){
+					int randEnemy = m_pWorld->m_cRandom.number(1, 3);
 					switch(randEnemy){
 					case 1:
-						createObject(ENEMY1IDLE_OBJECT, "enemy1Idle", p, v);
+						ChangeIncarnation(object, ENEMY1IDLE_OBJECT, "enemy1Idle", p, v);
 						break;
 
 					case 2:
-						createObject(ENEMYZOOMERIDLE_OBJECT, "enemyZoomerIdle", p, Vector3(-15.0f, v.y, v.z));
+						ChangeIncarnation(object, ENEMYZOOMERIDLE_OBJECT, "enemyZoomerIdle", p, Vector3(-15.0f, v.y, v.z));
 						break;
 
 					case 3:
-						createObject(ENEMYINVADERIDLE_OBJECT, "enemyInvaderIdle", p, v);
+						ChangeIncarnation(object, ENEMYINVADERIDLE_OBJECT, "enemyInvaderIdle", p, v);
 						break;
 					} //switch
 				} //else if
 				else{
-					int randEnemy = g_cRandom.number(1, 4);
+					int randEnemy = m_pWorld->m_cRandom.number(1, 4);
 					switch(randEnemy){
 					case 1:
-						createObject(ENEMYINVADERIDLE_OBJECT, "enemyInvaderIdle", p, v);
+						ChangeIncarnation(object, ENEMYINVADERIDLE_OBJECT, "enemyInvaderIdle", p, v);
 						break;
 
 					case 2:
-						createObject(ENEMY1IDLE_OBJECT, "enemy1Idle", p, v);
+						ChangeIncarnation(object, ENEMY1IDLE_OBJECT, "enemy1Idle", p, v);
 						break;
 
 					case 3:
-						createObject(ENEMYZOOMERIDLE_OBJECT, "enemyZoomerIdle", p, Vector3(-15.0f, v.y, v.z));
+						ChangeIncarnation(object, ENEMYZOOMERIDLE_OBJECT, "enemyZoomerIdle", p, Vector3(-15.0f, v.y, v.z));
 						break;
 
 					case 4:
-						createObject(ENEMYTHIEFIDLE_OBJECT, "enemyThiefIdle", p, Vector3(1.0f, 3.0f, 0.0f));
+						ChangeIncarnation(object, ENEMYTHIEFIDLE_OBJECT, "enemyThiefIdle", p, Vector3(1.0f, 3.0f, 0.0f));
 						break;
 					} //switch
 				} //else
@@ -699,37 +900,66 @@ void CObjectManager::CreateNextIncarnation(CGameObject* object){
 		case ENEMYEXIT_OBJECT:
 			if(m_bDiedOfAge){
 				dropChance(Vector3(p.x, p.y, p.z - 1), v);
-				m_nEnemyCount--;
+				m_pWorld->m_nEnemyCount--;
 			}
 			break;
 
-		case PROJECTILEF_OBJECT:
-			createObject(EXPLOSION_OBJECT, "explosion", Vector3(p.x, p.y, p.z-30.0f), Vector3(0, 0, 0));
-			break;
-
-		case PROJECTILES_OBJECT:
-			createObject(EXPLOSION_OBJECT, "explosion", Vector3(p.x, p.y, 376-30.0f), Vector3(0,0,0));
-			break;
-
-		case PROJECTILEP_OBJECT:
-			createObject(EXPLOSION_OBJECT, "explosion", Vector3(p.x, p.y, 376-30.0f), Vector3(0, 0, 0));
-			break;
   } //switch
 } //CreateNextIncarnation
 
+/// Rebuild the broadphase grid and the narrowphase targets from the current
+/// object positions. Only vulnerable objects can be hit, and they all have a
+/// collider, so the positions are gathered from the transform arrays of the
+/// chunks with colliders, leaving out objects still in the spawn queue. They
+/// are then sorted into the order of the object list, so that grid ids, and
+/// with them candidates from a query or hits from the narrowphase, come back
+/// in the same order that the brute force loop would visit them. The grid is
+/// filled if the broadphase is on, and otherwise the narrowphase if it is on.
+
+void CObjectManager::BuildGrid(){
+  m_cGrid.clear();
+  m_cNarrowphase.clear();
+  m_pGridObjects.clear();
+  m_sGridTargets.clear();
+
+  m_cEntities.ForEachChunk(TRANSFORM_COMPONENT | COLLIDER_COMPONENT, [this](ENTITYCHUNK& c){
+    for(int i=0; i<c.m_nCount; i++)
+      if(c.m_nOrder[i] > 0 && c.m_pObject[i]->GetFlag(VULNERABLE_FLAG)){
+        const GRIDTARGET target = {c.m_nOrder[i], c.m_pTransform[i].m_vPos.x, c.m_pTransform[i].m_vPos.y, c.m_pObject[i]};
+        m_sGridTargets.push_back(target);
+      } //if
+  }); //ForEachChunk
+
+  sort(m_sGridTargets.begin(), m_sGridTargets.end(),
+    [](const GRIDTARGET& a, const GRIDTARGET& b){return a.m_nOrder > b.m_nOrder;});
+
+  for(const GRIDTARGET& target: m_sGridTargets){
+    if(m_bBroadphase)m_cGrid.insert(target.m_fX, target.m_fY);
+    else if(m_bNarrowphase)m_cNarrowphase.insert(target.m_fX, target.m_fY);
+    m_pGridObjects.push_back(target.m_pObject);
+  } //for
+
+  if(m_bBroadphase)
+    m_cGrid.build();
+} //BuildGrid
+
 /// Master collision detection function.
 /// Compare every object against every other object for collision. Only
-/// bullets can collide right now.
+/// bullets can collide right now. The targets are gathered once here. If the
+/// broadphase is on, each bullet only looks at nearby objects in the grid.
+/// If not, each bullet is tested against all of them in one batch if the
+/// narrowphase is on, and one pair at a time by brute force if it is off.
 
 void CObjectManager::CollisionDetection(){ 
+  BuildGrid();
+
   for(auto i=m_stlObjectList.begin(); i!=m_stlObjectList.end(); i++)
-    if((*i)->m_nObjectType == PROJECTILEF_OBJECT || (*i)->m_nObjectType == PROJECTILES_OBJECT || (*i)->m_nObjectType == PROJECTILEP_OBJECT
-		|| (*i)->m_nObjectType == PROJECTILED_OBJECT || (*i)->m_nObjectType == PROJECTILEZ_OBJECT || (*i)->m_nObjectType == PROJECTILEK_OBJECT
+    if(HasTrait((*i)->m_nObjectType, PLAYERSHOT_TRAIT | PIERCESHOT_TRAIT)
 		|| (*i)->m_nObjectType == PROJECTILETHIEF_OBJECT) //and is a bullet
       CollisionDetection(*i); //check every object for collision with this bullet
   
   //player object
-	if (!g_bPlayerIsInvulnerable) {//if player is vulnerable
+	if (!m_pWorld->m_bPlayerIsInvulnerable) {//if player is vulnerable
 		CollisionDetection(GetPlayerObjectPtr());
 	}
 } //CollisionDetection
@@ -737,14 +967,46 @@ void CObjectManager::CollisionDetection(){
 /// Given an object pointer, compare that object against every other 
 /// object for collision. If a collision is detected, replace the object hit
 /// with the next in series (if one exists), and kill the object doing the
-/// hitting (bullets don't go through objects in this game).
+/// hitting (bullets don't go through objects in this game). If swept
+/// collision detection is on, projectiles are tested along their move.
 /// \param p Pointer to the object to be compared against.
 
 void CObjectManager::CollisionDetection(CGameObject* p){ 
 	if(p != nullptr){
+		//projectiles other than a reflected thief projectile can be tested along their move
+		const BOOL projectile = HasTrait(p->m_nObjectType, PLAYERSHOT_TRAIT | PIERCESHOT_TRAIT)
+		  || (p->m_nObjectType == PROJECTILETHIEF_OBJECT && p->GetFlag(VULNERABLE_FLAG));
+		if(m_bSwept && projectile){
+			SweptCollisionDetection(p);
+			m_bCollided = FALSE;
+			return;
+		} //if
+
+		//a reflected thief projectile is tested against thief attackers by x coordinate
+		//only, which the grid can't answer, so it always takes the brute force path
+		if(m_bBroadphase && !(p->m_nObjectType == PROJECTILETHIEF_OBJECT && !p->GetFlag(VULNERABLE_FLAG))){
+			const float fWorldWidth = 2.0f * (float)g_nScreenWidth; //world width
+			m_cGrid.query(p->position().x, p->position().y, COLLISION_RADIUS, fWorldWidth, m_nCandidates);
+			for(size_t k = 0; k < m_nCandidates.size(); k++)
+				CollisionDetection(p, m_pGridObjects[m_nCandidates[k]]);
+			m_bCollided = FALSE;
+			return;
+		} //if
+
+		//all targets in one batch, then the ones in range in list order
+		if(m_bNarrowphase && (p->m_nObjectType != PROJECTILETHIEF_OBJECT || p->GetFlag(VULNERABLE_FLAG))){
+			const float fWorldWidth = 2.0f * (float)g_nScreenWidth; //world width
+			if(m_cNarrowphase.test(p->position().x, p->position().y, COLLISION_RADIUS, fWorldWidth, m_nHits) > 0)
+				for(size_t k = 0; k < m_nHits.size(); k++)
+					for(unsigned w = m_nHits[k]; w; w &= w - 1)
+						CollisionResponse(p, m_pGridObjects[32*k + LowestBit(w)]);
+			m_bCollided = FALSE;
+			return;
+		} //if
+
 		for (auto j = m_stlObjectList.begin(); j != m_stlObjectList.end(); j++){
-			if(p->m_nObjectType == PROJECTILETHIEF_OBJECT && !p->m_bVulnerable && (*j)->m_nObjectType == ENEMYTHIEFATTACK_OBJECT){
-				if(p->m_vPos.x - 15.0f > (*j)->m_vPos.x){
+			if(p->m_nObjectType == PROJECTILETHIEF_OBJECT && !p->GetFlag(VULNERABLE_FLAG) && (*j)->m_nObjectType == ENEMYTHIEFATTACK_OBJECT){
+				if(p->position().x - 15.0f > (*j)->position().x){
 					p->kill();
 					(*j)->kill();
 					CreateNextIncarnation(p);
@@ -758,277 +1020,362 @@ void CObjectManager::CollisionDetection(CGameObject* p){
 } //CollisionDetection
 
 /// Given 2 object pointers, see whether the objects collide. 
-/// If a collision is detected, replace the object hit
-/// with the next in series (if one exists), and kill the object doing the
-/// hitting (bullets don't go through objects in this game).
-/// \param i iterator of the object to compare against
+/// The collision matrix says what would happen if they did, so pairs that
+/// can't interact are thrown out before the distance is computed. If they do
+/// collide, the response is dispatched to its handler.
+/// \param p0 Pointer to the object doing the hitting.
+/// \param p1 Pointer to the object being hit.
 
 void CObjectManager::CollisionDetection(CGameObject* p0, CGameObject* p1)
 { 
-  if(p1->m_bVulnerable && distance(p0, p1) < 25.0f){
-	  //If player gets hit, take damage and lose some points
-	  if((p0->m_nObjectType == FREDIDLE_OBJECT || p0->m_nObjectType == FREDATTACK_OBJECT 
-		  || p0->m_nObjectType == SWAZIDLE_OBJECT || p0->m_nObjectType == SWAZATTACK_OBJECT
-		  || p0->m_nObjectType == POLKIDLE_OBJECT || p0->m_nObjectType == POLKATTACK_OBJECT)
-		  && (p1->m_nObjectType == ENEMY1IDLE_OBJECT || p1->m_nObjectType == PROJECTILEENEMY1_OBJECT 
-				|| p1->m_nObjectType == PROJECTILEINVADER_OBJECT || p1->m_nObjectType == ENEMYINVADERIDLE_OBJECT || p1->m_nObjectType == ENEMYINVADERATTACK_OBJECT
-				|| p1->m_nObjectType == ENEMYZOOMERIDLE_OBJECT || p1->m_nObjectType == ENEMYZOOMERIDLEFLIP_OBJECT
-				|| p1->m_nObjectType == ENEMYTHIEFIDLE_OBJECT || p1->m_nObjectType == PROJECTILETHIEF_OBJECT) && !m_bCollided){
-
-			if(p1->m_nObjectType == PROJECTILETHIEF_OBJECT){
-				if(p1->m_vPos.x > p0->m_vPos.x) p1->m_vVelocity = -10*(p1->m_vVelocity);
-				p1->m_bVulnerable = FALSE;
-				BOOL lettersToSteal[3] = {FALSE, FALSE, FALSE};
-				int numToSteal = 0;
-				for(int i = 0; i < 3; i++){
-					if(m_nAmmoCount[i] > 0){
-						lettersToSteal[i] = TRUE;
-						numToSteal += 1;
-					}
-				}
-				//picks a random letter to steal that the player has
-				int randLet;
-				switch(numToSteal){
-				case 1:
-					if(lettersToSteal[0])
-						reduceAmmoCount(0);
-					else if (lettersToSteal[1])
-						reduceAmmoCount(1);
-					else
-						reduceAmmoCount(2);
-					break;
-
-				case 2:
-					randLet = g_cRandom.number(1, 2);
-					if(!lettersToSteal[0])
-						reduceAmmoCount(randLet);
-					else if(!lettersToSteal[1]){
-						if(randLet == 1) reduceAmmoCount(randLet - 1);
-						else reduceAmmoCount(randLet);
-					}
-					else if(!lettersToSteal[2]){
-						if(randLet == 2) reduceAmmoCount(randLet - 2);
-						else reduceAmmoCount(randLet);
-					}
-					break;
-
-				case 3:
-					randLet = g_cRandom.number(0, 2);
-					reduceAmmoCount(randLet);
-					break;
-				}
+  const CollisionResponseType r = m_cCollisionMatrix.GetResponse(p0->m_nObjectType, p1->m_nObjectType);
+  if(r != NO_RESPONSE && p1->GetFlag(VULNERABLE_FLAG) && distance(p0, p1) < COLLISION_RADIUS)
+    (this->*m_pCollisionHandler[r])(p0, p1);
+} //CollisionDetection
+
+/// Continuous collision detection for a projectile. Instead of testing where
+/// the projectile is now, the segment that it moved along since it was last
+/// integrated is tested against the targets, so that it can't skip over one
+/// in a long step. Candidates come from the grid or the narrowphase, queried
+/// with a circle that holds the whole segment, and then the time of impact
+/// with each is worked out. They are responded to in order of time of impact,
+/// ties in object list order, so a shot hits the first target on its way.
+/// The projectile is put where it made contact for each response, so that
+/// whatever it turns into appears there, and put back if it is still a
+/// projectile of the same type afterwards, as a piercing shot is.
+/// \param p Pointer to the projectile.
+
+void CObjectManager::SweptCollisionDetection(CGameObject* p){
+  const float fWorldWidth = 2.0f * (float)g_nScreenWidth; //world width
+  const float x0 = p->lastX(), y0 = p->lastY(); //start of move
+  const Vector3 pos = p->position(); //end of move
+  const float dx = pos.x - x0, dy = pos.y - y0; //move
+  const float cx = x0 + dx/2.0f, cy = y0 + dy/2.0f; //middle of move
+  const float r = COLLISION_RADIUS + sqrtf(dx*dx + dy*dy)/2.0f + SWEPT_MARGIN; //holds the whole move
+
+  m_sSweptHits.clear();
+  SWEPTHIT hit;
+
+  if(m_bBroadphase){
+    m_cGrid.query(cx, cy, r, fWorldWidth, m_nCandidates);
+    for(size_t k = 0; k < m_nCandidates.size(); k++){
+      CGameObject* q = m_pGridObjects[m_nCandidates[k]];
+      if(CNarrowphase::TimeOfImpact(x0, y0, pos.x, pos.y, q->position().x, q->position().y,
+        COLLISION_RADIUS, fWorldWidth, hit.m_fTime))
+      {
+        hit.m_nId = m_nCandidates[k];
+        m_sSweptHits.push_back(hit);
+      } //if
+    } //for
+  } //if
+
+  else if(!m_bNarrowphase){
+    for(int id = 0; id < (int)m_pGridObjects.size(); id++){
+      CGameObject* q = m_pGridObjects[id];
+      if(CNarrowphase::TimeOfImpact(x0, y0, pos.x, pos.y, q->position().x, q->position().y,
+        COLLISION_RADIUS, fWorldWidth, hit.m_fTime))
+      {
+        hit.m_nId = id;
+        m_sSweptHits.push_back(hit);
+      } //if
+    } //for
+  } //else if
+
+  else if(m_cNarrowphase.test(cx, cy, r, fWorldWidth, m_nHits) > 0)
+    for(size_t k = 0; k < m_nHits.size(); k++)
+      for(unsigned w = m_nHits[k]; w; w &= w - 1){
+        const int id = 32*(int)k + LowestBit(w);
+        CGameObject* q = m_pGridObjects[id];
+        if(CNarrowphase::TimeOfImpact(x0, y0, pos.x, pos.y, q->position().x, q->position().y,
+          COLLISION_RADIUS, fWorldWidth, hit.m_fTime))
+        {
+          hit.m_nId = id;
+          m_sSweptHits.push_back(hit);
+        } //if
+      } //for
+
+  sort(m_sSweptHits.begin(), m_sSweptHits.end(), [](const SWEPTHIT& a, const SWEPTHIT& b){
+    return a.m_fTime < b.m_fTime || (a.m_fTime == b.m_fTime && a.m_nId < b.m_nId);
+  }); //sort
+
+  const ObjectType t = p->m_nObjectType;
+  for(size_t k = 0; k < m_sSweptHits.size() && p->m_nObjectType == t; k++){
+    const float f = m_sSweptHits[k].m_fTime;
+    p->position().x = x0 + dx*f;
+    p->position().y = y0 + dy*f;
+    CollisionResponse(p, m_pGridObjects[m_sSweptHits[k].m_nId]);
+  } //for
+
+  if(p->m_nObjectType == t)
+    p->position() = pos;
+} //SweptCollisionDetection
+
+/// Respond to a collision of 2 objects that the narrowphase has found to be
+/// in range. An earlier response this tick may have made the object being
+/// hit invulnerable, or changed its type, so that is checked again here.
+/// Responses don't move objects, so the range doesn't need checking again.
+/// \param p0 Pointer to the object doing the hitting.
+/// \param p1 Pointer to the object being hit.
+
+void CObjectManager::CollisionResponse(CGameObject* p0, CGameObject* p1){
+  const CollisionResponseType r = m_cCollisionMatrix.GetResponse(p0->m_nObjectType, p1->m_nObjectType);
+  if(r != NO_RESPONSE && p1->GetFlag(VULNERABLE_FLAG))
+    (this->*m_pCollisionHandler[r])(p0, p1);
+} //CollisionResponse
+
+/// Collision handlers, indexed by collision response.
+
+const CObjectManager::CollisionHandler CObjectManager::m_pCollisionHandler[NUM_COLLISION_RESPONSES] = {
+  nullptr, //NO_RESPONSE
+  &CObjectManager::PlayerHit, //PLAYERHIT_RESPONSE
+  &CObjectManager::SpikedHit, //SPIKED_RESPONSE
+  &CObjectManager::PierceHit, //PIERCE_RESPONSE
+  &CObjectManager::ShotHit, //SHOT_RESPONSE
+  &CObjectManager::HeartPickup, //HEART_RESPONSE
+  &CObjectManager::LetterPickup, //LETTER_RESPONSE
+}; //m_pCollisionHandler
+
+/// The player runs into something harmful, take damage and lose some points.
+/// \param p0 Pointer to the player.
+/// \param p1 Pointer to the object that hit the player.
+
+void CObjectManager::PlayerHit(CGameObject* p0, CGameObject* p1){
+	if(m_bCollided)return; //already hit by something this tick
+
+	if(p1->m_nObjectType == PROJECTILETHIEF_OBJECT){
+		if(p1->position().x > p0->position().x) p1->velocity() = -10*(p1->velocity());
+		p1->SetFlag(VULNERABLE_FLAG, FALSE);
+		BOOL lettersToSteal[3] = {FALSE, FALSE, FALSE};
+		int numToSteal = 0;
+		for(int i = 0; i < 3; i++){
+			if(m_nAmmoCount[i] > 0){
+				lettersToSteal[i] = TRUE;
+				numToSteal += 1;
 			}
+		}
+		//picks a random letter to steal that the player has
+		int randLet;
+		switch(numToSteal){
+		case 1:
+			if(lettersToSteal[0])
+				reduceAmmoCount(0);
+			else if (lettersToSteal[1])
+				reduceAmmoCount(1);
+			else
+				reduceAmmoCount(2);
+			break;
 
-			if(m_nPlayerHealth > 0 && !g_bShieldActive){
-			  m_nPlayerHealth -= 1;
-			  if(m_nScore > 0)
-					m_nScore -= 50;
-			  else
-		      m_nScore = 0;
-
-			  if(m_nPlayerHealth == 0){
-				  switch(p0->m_nObjectType){
-						case POLKIDLE_OBJECT: m_nPlayerHealth = 4; break;
-						case POLKATTACK_OBJECT: m_nPlayerHealth = 4; break;
-						case FREDIDLE_OBJECT: m_nPlayerHealth = 6; break;
-						case FREDATTACK_OBJECT: m_nPlayerHealth = 6; break;
-						case SWAZIDLE_OBJECT: m_nPlayerHealth = 8; break;
-						case SWAZATTACK_OBJECT: m_nPlayerHealth = 8; break;
-				  }
-				  
-					if(m_nPlayerLives == 0){
-						g_nGameState = GAMEOVER_GAMESTATE;
-						m_bDiedOfDmg = TRUE;
-						if(g_nLevelState == COMICWORLD_STATE) g_pSoundManager->stop(UNLEASH_SOUND);
-						else if(g_nLevelState == FANTASY_STATE) g_pSoundManager->stop(MOOSEHEADHONK_SOUND);
-						else if(g_nLevelState == CITY_STATE) g_pSoundManager->stop(MOOSEHEADHONK_SOUND);
-						g_pSoundManager->play(GAMEOVER_SOUND);
-					} //if
-					else m_nPlayerLives -= 1;
-			  } //if
-		  } //if
-			
-			//create hurt player if no shield is activated
-			if(!g_bShieldActive){
-				m_bPlayerHit = TRUE;
-				g_pSoundManager->play(PLAYERHIT_SOUND);
-				p0->kill();
-				CreateNextIncarnation(p0);
-				m_bPlayerHit = FALSE;
+		case 2:
+			randLet = m_pWorld->m_cRandom.number(1, 2);
+			if(!lettersToSteal[0])
+				reduceAmmoCount(randLet);
+			else if(!lettersToSteal[1]){
+				if(randLet == 1) reduceAmmoCount(randLet - 1);
+				else reduceAmmoCount(randLet);
 			}
-			else g_pSoundManager->play(SHIELDHIT_SOUND);
-
-			//power down
-			if(g_bShieldActive && g_bAssistActive) g_bShieldActive = FALSE;
-			else if(!g_bShieldActive && g_bAssistActive) g_bAssistActive = FALSE;
-			else if(g_bShieldActive && !g_bAssistActive) g_bShieldActive = FALSE;
-			m_bGotHit = TRUE;
-			m_bCollided = TRUE;
-
-			if(p1->m_nObjectType != PROJECTILETHIEF_OBJECT){
-				p1->kill();
-				CreateNextIncarnation(p1);
+			else if(!lettersToSteal[2]){
+				if(randLet == 2) reduceAmmoCount(randLet - 2);
+				else reduceAmmoCount(randLet);
 			}
-		  return;
-	  }
-	  //Spiked enemies are industructable, so only kill the player's bullet when they collide
-	  if((p1->m_nObjectType == ENEMY1IDLE_OBJECT || p1->m_nObjectType == PROJECTILEENEMY1_OBJECT || p1->m_nObjectType == PROJECTILEINVADER_OBJECT || p1->m_nObjectType == PROJECTILETHIEF_OBJECT)
-				&& (p0->m_nObjectType == PROJECTILEF_OBJECT || p0->m_nObjectType == PROJECTILES_OBJECT || p0->m_nObjectType == PROJECTILEP_OBJECT)){
-			p0->kill();
-			if(p1->m_nObjectType == PROJECTILEINVADER_OBJECT || p1->m_nObjectType == PROJECTILETHIEF_OBJECT)
-				p1->kill();
-			g_pSoundManager->play(EXPLOSION_SOUND);
-			CreateNextIncarnation(p0);
-		  return;
-	  }
-	  //If pierce shot hits, the enemy will always die and the shot keeps going
-		if((p1->m_nObjectType == ENEMY1AFTER_OBJECT || p1->m_nObjectType == ENEMY1IDLE_OBJECT 
-			|| p1->m_nObjectType == ENEMYINVADERIDLE_OBJECT || p1->m_nObjectType == ENEMYINVADERATTACK_OBJECT || p1->m_nObjectType == PROJECTILEINVADER_OBJECT
-			|| p1->m_nObjectType == ENEMYZOOMERIDLE_OBJECT || p1->m_nObjectType == ENEMYZOOMERIDLEFLIP_OBJECT || p1->m_nObjectType == ENEMYZOOMERBOUNCEFLIP_OBJECT || p1->m_nObjectType == ENEMYZOOMERBOUNCE_OBJECT
-			|| p1->m_nObjectType == ENEMYTHIEFIDLE_OBJECT || p1->m_nObjectType == ENEMYTHIEFATTACK_OBJECT)
-			&& (p0->m_nObjectType == PROJECTILED_OBJECT || p0->m_nObjectType == PROJECTILEZ_OBJECT || p0->m_nObjectType == PROJECTILEK_OBJECT)){
-			p1->kill();
-			g_pSoundManager->play(EXPLOSION_SOUND);
-			m_nScore += 300;
-			m_nHitShots += 1;
-			p1->m_nHealth -= 3;
-			CreateNextIncarnation(p1);
-			return;
+			break;
+
+		case 3:
+			randLet = m_pWorld->m_cRandom.number(0, 2);
+			reduceAmmoCount(randLet);
+			break;
 		}
+	}
 
-		//if regular shot hits vulnerable enemy,  enemy takes damage depending on the shot
-	  if((p1->m_nObjectType == ENEMY1AFTER_OBJECT || p1->m_nObjectType == ENEMYINVADERIDLE_OBJECT || p1->m_nObjectType == ENEMYINVADERATTACK_OBJECT
-		  || p1->m_nObjectType == ENEMYZOOMERIDLE_OBJECT || p1->m_nObjectType == ENEMYZOOMERIDLEFLIP_OBJECT || p1->m_nObjectType == ENEMYZOOMERBOUNCEFLIP_OBJECT || p1->m_nObjectType == ENEMYZOOMERBOUNCE_OBJECT
-			|| p1->m_nObjectType == ENEMYTHIEFIDLE_OBJECT || p1->m_nObjectType == ENEMYTHIEFATTACK_OBJECT)
-			&& (p0->m_nObjectType == PROJECTILEF_OBJECT || p0->m_nObjectType == PROJECTILES_OBJECT || p0->m_nObjectType == PROJECTILEP_OBJECT)){
-			p1->kill();
-			p0->kill();
-			g_pSoundManager->play(EXPLOSION_SOUND);
-		  m_nScore += 100;
-		  m_nHitShots += 1;
-		  if(p0->m_nObjectType == PROJECTILEP_OBJECT)
-			  p1->m_nHealth -= 3;
-		  else if(p0->m_nObjectType == PROJECTILEF_OBJECT)
-			  p1->m_nHealth -= 2;
-		  else if(p0->m_nObjectType == PROJECTILES_OBJECT)
-			  p1->m_nHealth -= 1;
-
-			CreateNextIncarnation(p0);
-			CreateNextIncarnation(p1);
-		  return;
-	  }
-	  //When player gets health
-	  if((p0->m_nObjectType == FREDIDLE_OBJECT || p0->m_nObjectType == FREDATTACK_OBJECT 
-		  || p0->m_nObjectType == SWAZIDLE_OBJECT || p0->m_nObjectType == SWAZATTACK_OBJECT
-		  || p0->m_nObjectType == POLKIDLE_OBJECT || p0->m_nObjectType == POLKATTACK_OBJECT)
-		  && p1->m_nObjectType == ITEMHEART_OBJECT){
-			p1->kill();
-			g_pSoundManager->play(GETITEM_SOUND);
-
-		  if(m_nPlayerHealth >= 3 && p0->m_nObjectType == POLKIDLE_OBJECT || p0->m_nObjectType == POLKATTACK_OBJECT)
-			  m_nPlayerHealth = 4;
-			else if(m_nPlayerHealth >= 5 && p0->m_nObjectType == FREDIDLE_OBJECT || p0->m_nObjectType == FREDATTACK_OBJECT)
-			  m_nPlayerHealth = 6;
-		  else if(m_nPlayerHealth >= 7 && p0->m_nObjectType == SWAZIDLE_OBJECT || p0->m_nObjectType == SWAZATTACK_OBJECT)
-			  m_nPlayerHealth = 8;
-		  else
-			  m_nPlayerHealth += 2;
-		  m_nScore += 50;
-		  return;
-	  }
-	  //Player gets a letter item for this block and the two that follow
-	  if((p0->m_nObjectType == FREDIDLE_OBJECT || p0->m_nObjectType == FREDATTACK_OBJECT
-		  || p0->m_nObjectType == SWAZIDLE_OBJECT || p0->m_nObjectType == SWAZATTACK_OBJECT
-		  || p0->m_nObjectType == POLKIDLE_OBJECT || p0->m_nObjectType == POLKATTACK_OBJECT)
-		  && (p1->m_nObjectType == ITEMR_OBJECT || p1->m_nObjectType == ITEMW_OBJECT || p1->m_nObjectType == ITEMO_OBJECT)){
-			p1->kill();
-		  if(m_nAmmoCount[0] < 5)
-			  m_nAmmoCount[0]++;
-		  m_nScore += 50;
-			if(m_nAmmoCount[0] > 0 && m_nAmmoCount[1] > 0 && m_nAmmoCount[2] > 0 && m_nAmmoCount[3] > 0)
-				g_pSoundManager->play(SPECIALREADY_SOUND);
-			else
-				g_pSoundManager->play(GETITEM_SOUND);
-		  return;
-	  }
-
-	  if((p0->m_nObjectType == FREDIDLE_OBJECT || p0->m_nObjectType == FREDATTACK_OBJECT
-		  || p0->m_nObjectType == SWAZIDLE_OBJECT || p0->m_nObjectType == SWAZATTACK_OBJECT
-		  || p0->m_nObjectType == POLKIDLE_OBJECT || p0->m_nObjectType == POLKATTACK_OBJECT)
-		  && (p1->m_nObjectType == ITEME_OBJECT || p1->m_nObjectType == ITEMA_OBJECT || p1->m_nObjectType == ITEML_OBJECT)){
-		  p1->kill();
-		  if(m_nAmmoCount[1] < 5)
-			  m_nAmmoCount[1]++;
-		  m_nScore += 50;
-			if(m_nAmmoCount[0] > 0 && m_nAmmoCount[1] > 0 && m_nAmmoCount[2] > 0 && m_nAmmoCount[3] > 0)
-				g_pSoundManager->play(SPECIALREADY_SOUND);
-			else
-				g_pSoundManager->play(GETITEM_SOUND);
-		  return;
-	  }
-
-	  if((p0->m_nObjectType == FREDIDLE_OBJECT || p0->m_nObjectType == FREDATTACK_OBJECT
-		  || p0->m_nObjectType == SWAZIDLE_OBJECT || p0->m_nObjectType == SWAZATTACK_OBJECT
-		  || p0->m_nObjectType == POLKIDLE_OBJECT || p0->m_nObjectType == POLKATTACK_OBJECT)
-		  && (p1->m_nObjectType == ITEMD_OBJECT || p1->m_nObjectType == ITEMZ_OBJECT || p1->m_nObjectType == ITEMK_OBJECT)){
-		  p1->kill();
-		  if(m_nAmmoCount[2] < 5)
-			  m_nAmmoCount[2]++;
-		  m_nScore += 50;
-			if(m_nAmmoCount[0] > 0 && m_nAmmoCount[1] > 0 && m_nAmmoCount[2] > 0 && m_nAmmoCount[3] > 0)
-				g_pSoundManager->play(SPECIALREADY_SOUND);
-			else
-				g_pSoundManager->play(GETITEM_SOUND);
-		  return;
-	  }
+	if(m_nPlayerHealth > 0 && !m_pWorld->m_bShieldActive){
+	  m_nPlayerHealth -= 1;
+	  if(m_nScore > 0)
+			m_nScore -= 50;
+	  else
+      m_nScore = 0;
+
+	  if(m_nPlayerHealth == 0){
+		  switch(p0->m_nObjectType){
+				case POLKIDLE_OBJECT: m_nPlayerHealth = 4; break;
+				case POLKATTACK_OBJECT: m_nPlayerHealth = 4; break;
+				case FREDIDLE_OBJECT: m_nPlayerHealth = 6; break;
+				case FREDATTACK_OBJECT: m_nPlayerHealth = 6; break;
+				case SWAZIDLE_OBJECT: m_nPlayerHealth = 8; break;
+				case SWAZATTACK_OBJECT: m_nPlayerHealth = 8; break;
+		  }
+		  
+			if(m_nPlayerLives == 0){
+				m_pWorld->m_nGameState = GAMEOVER_GAMESTATE;
+				m_bDiedOfDmg = TRUE;
+				if(m_pWorld->m_nLevelState == COMICWORLD_STATE) m_pWorld->m_pSoundManager->stop(UNLEASH_SOUND);
+				else if(m_pWorld->m_nLevelState == FANTASY_STATE) m_pWorld->m_pSoundManager->stop(MOOSEHEADHONK_SOUND);
+				else if(m_pWorld->m_nLevelState == CITY_STATE) m_pWorld->m_pSoundManager->stop(MOOSEHEADHONK_SOUND);
+				m_pWorld->m_pSoundManager->play(GAMEOVER_SOUND);
+			} //if
+			else m_nPlayerLives -= 1;
+	  } //if
   } //if
-} //CollisionDetection
-
-/// Collect garbage, that is, remove dead objects from the object list.
+	
+	//create hurt player if no shield is activated
+	if(!m_pWorld->m_bShieldActive){
+		m_bPlayerHit = TRUE;
+		m_pWorld->m_pSoundManager->play(PLAYERHIT_SOUND);
+		p0->kill();
+		CreateNextIncarnation(p0);
+		m_bPlayerHit = FALSE;
+	}
+	else m_pWorld->m_pSoundManager->play(SHIELDHIT_SOUND);
+
+	//power down
+	if(m_pWorld->m_bShieldActive && m_pWorld->m_bAssistActive) m_pWorld->m_bShieldActive = FALSE;
+	else if(!m_pWorld->m_bShieldActive && m_pWorld->m_bAssistActive) m_pWorld->m_bAssistActive = FALSE;
+	else if(m_pWorld->m_bShieldActive && !m_pWorld->m_bAssistActive) m_pWorld->m_bShieldActive = FALSE;
+	m_bGotHit = TRUE;
+	m_bCollided = TRUE;
+
+	if(p1->m_nObjectType != PROJECTILETHIEF_OBJECT){
+		p1->kill();
+		CreateNextIncarnation(p1);
+	}
+} //PlayerHit
+
+/// Spiked enemies are indestructible, so only kill the player's bullet when
+/// they collide.
+/// \param p0 Pointer to the letter shot.
+/// \param p1 Pointer to the spiked object.
+
+void CObjectManager::SpikedHit(CGameObject* p0, CGameObject* p1){
+	p0->kill();
+	if(p1->m_nObjectType == PROJECTILEINVADER_OBJECT || p1->m_nObjectType == PROJECTILETHIEF_OBJECT)
+		p1->kill();
+	m_pWorld->m_pSoundManager->play(EXPLOSION_SOUND);
+	CreateNextIncarnation(p0);
+} //SpikedHit
+
+/// If pierce shot hits, the enemy will always die and the shot keeps going.
+/// The first parameter, the piercing shot, is not needed.
+/// \param p1 Pointer to the enemy.
+
+void CObjectManager::PierceHit(CGameObject*, CGameObject* p1){
+	p1->kill();
+	m_pWorld->m_pSoundManager->play(EXPLOSION_SOUND);
+	m_nScore += 300;
+	m_nHitShots += 1;
+	p1->health() -= 3;
+	CreateNextIncarnation(p1);
+} //PierceHit
+
+/// If regular shot hits vulnerable enemy, enemy takes damage depending on the
+/// shot.
+/// \param p0 Pointer to the letter shot.
+/// \param p1 Pointer to the enemy.
+
+void CObjectManager::ShotHit(CGameObject* p0, CGameObject* p1){
+	p1->kill();
+	p0->kill();
+	m_pWorld->m_pSoundManager->play(EXPLOSION_SOUND);
+  m_nScore += 100;
+  m_nHitShots += 1;
+  if(p0->m_nObjectType == PROJECTILEP_OBJECT)
+	  p1->health() -= 3;
+  else if(p0->m_nObjectType == PROJECTILEF_OBJECT)
+	  p1->health() -= 2;
+  else if(p0->m_nObjectType == PROJECTILES_OBJECT)
+	  p1->health() -= 1;
+
+	CreateNextIncarnation(p0);
+	CreateNextIncarnation(p1);
+} //ShotHit
+
+/// When player gets health.
+/// \param p0 Pointer to the player.
+/// \param p1 Pointer to the heart.
+
+void CObjectManager::HeartPickup(CGameObject* p0, CGameObject* p1){
+	p1->kill();
+	m_pWorld->m_pSoundManager->play(GETITEM_SOUND);
+
+  if(m_nPlayerHealth >= 3 && p0->m_nObjectType == POLKIDLE_OBJECT || p0->m_nObjectType == POLKATTACK_OBJECT)
+	  m_nPlayerHealth = 4;
+	else if(m_nPlayerHealth >= 5 && p0->m_nObjectType == FREDIDLE_OBJECT || p0->m_nObjectType == FREDATTACK_OBJECT)
+	  m_nPlayerHealth = 6;
+  else if(m_nPlayerHealth >= 7 && p0->m_nObjectType == SWAZIDLE_OBJECT || p0->m_nObjectType == SWAZATTACK_OBJECT)
+	  m_nPlayerHealth = 8;
+  else
+	  m_nPlayerHealth += 2;
+  m_nScore += 50;
+} //HeartPickup
+
+/// Player gets a letter item. The first parameter, the player, is not needed.
+/// \param p1 Pointer to the letter item.
+
+void CObjectManager::LetterPickup(CGameObject*, CGameObject* p1){
+	int k = 0; //ammo count for this letter
+	if(HasTrait(p1->m_nObjectType, ASSISTITEM_TRAIT))k = 1;
+	else if(HasTrait(p1->m_nObjectType, PIERCEITEM_TRAIT))k = 2;
+
+	p1->kill();
+  if(m_nAmmoCount[k] < 5)
+	  m_nAmmoCount[k]++;
+  m_nScore += 50;
+	if(m_nAmmoCount[0] > 0 && m_nAmmoCount[1] > 0 && m_nAmmoCount[2] > 0)
+		m_pWorld->m_pSoundManager->play(SPECIALREADY_SOUND);
+	else
+		m_pWorld->m_pSoundManager->play(GETITEM_SOUND);
+} //LetterPickup
+
+/// Collect garbage, that is, remove dead objects from the object list, then
+/// add the objects created since the last collection. This runs once per tick
+/// at the end of move(), so nothing is added to or removed from the object
+/// list while it is being iterated over. Dead objects go in list order and new
+/// ones in creation order, so the outcome doesn't depend on who asked first.
 
 void CObjectManager::GarbageCollect(){
+	m_cDepthLayers.prune(); //before the dead are deleted
 	for(auto i = m_stlObjectList.begin(); i != m_stlObjectList.end(); ){
 		CGameObject* p = *i;
-		if(p->m_bIsDead){
+		if(p->GetFlag(DEAD_FLAG)){
 			i = m_stlObjectList.erase(i);
-			delete p;
+			m_nLiveCount[p->m_nObjectType]--;
+			m_cRegistry.erase(p->m_pCold->m_hHandle); //no-op unless it is still registered
+			delete p; //goes back to its pool for reuse
 		}
 		else
 			++i;
 	} //for
+
+	FlushSpawnQueue();
 } //GarbageCollect
 
 /// Find every enemy on the screen,  and kill it
 
 void CObjectManager::SpecialAttack(){
 	for(auto i = m_stlObjectList.begin(); i != m_stlObjectList.end(); i++){
-		if((*i)->m_bVulnerable){ //and is an enemy
-			(*i)->m_nHealth = 0;
+		if((*i)->GetFlag(VULNERABLE_FLAG)){ //and is an enemy
+			if((*i)->HasComponent(COLLIDER_COMPONENT))(*i)->health() = 0;
 			(*i)->kill(); //check every object for collision with this bullet
 			m_bDiedOfSpecial = TRUE;
 			CreateNextIncarnation(*i);
 			m_bDiedOfSpecial = FALSE;
 			m_nScore += 200;
-			g_pSoundManager->play(EXPLOSION_SOUND);
+			m_pWorld->m_pSoundManager->play(EXPLOSION_SOUND);
 		} //if
 	} //for
 	reduceAmmoCount(0);
 	reduceAmmoCount(1);
 	reduceAmmoCount(2);
-	g_bSpecialActivate = FALSE;
+	m_pWorld->m_bSpecialActivate = FALSE;
 } //SpecialAttack
 
 /// Possibly drops a random item when enemy is killed
 
 void CObjectManager::dropChance(Vector3 p, Vector3 v){
 	int dropChance;
-	g_cRandom.sowseed();
 
-	dropChance = g_cRandom.number(1, 2);
+	dropChance = m_pWorld->m_cRandom.number(1, 2);
 	if(dropChance == 1){
-		switch(g_cRandom.number(1, 4)){
+		switch(m_pWorld->m_cRandom.number(1, 4)){
 		case 1:
-			switch(player->m_nObjectType){
+			switch(m_pWorld->m_pPlayer->m_nObjectType){
 			case FREDIDLE_OBJECT: createObject(ITEMR_OBJECT, "itemLetterR", p, v); break;
 			case FREDATTACK_OBJECT: createObject(ITEMR_OBJECT, "itemLetterR", p, v); break;
 			case SWAZIDLE_OBJECT: createObject(ITEMW_OBJECT, "itemLetterW", p, v); break;
@@ -1038,7 +1385,7 @@ void CObjectManager::dropChance(Vector3 p, Vector3 v){
 			} break;
 
 		case 2:
-			switch(player->m_nObjectType){
+			switch(m_pWorld->m_pPlayer->m_nObjectType){
 			case FREDIDLE_OBJECT: createObject(ITEME_OBJECT, "itemLetterE", p, v); break;
 			case FREDATTACK_OBJECT: createObject(ITEME_OBJECT, "itemLetterE", p, v); break;
 			case SWAZIDLE_OBJECT: createObject(ITEMA_OBJECT, "itemLetterA", p, v); break;
@@ -1048,7 +1395,7 @@ void CObjectManager::dropChance(Vector3 p, Vector3 v){
 			} break;
 
 		case 3:
-			switch(player->m_nObjectType){
+			switch(m_pWorld->m_pPlayer->m_nObjectType){
 			case FREDIDLE_OBJECT: createObject(ITEMD_OBJECT, "itemLetterD", p, v); break;
 			case FREDATTACK_OBJECT: createObject(ITEMD_OBJECT, "itemLetterD", p, v); break;
 			case SWAZIDLE_OBJECT: createObject(ITEMZ_OBJECT, "itemLetterZ", p, v); break;
@@ -1105,17 +1452,10 @@ float CObjectManager::getPlayerSpeed(){
 	return m_nPlayerSpeed;
 } //getPlayerSpeed
 
-void CObjectManager::DeleteNameToObject(){
-	auto i = GetPlayerObject();
-	if(i != m_stlNameToObject.end()){
-		m_stlNameToObject.erase(i); //erase it
-	}
-} //DeleteNameToObject
-
 /// Reset player stats to initial conditions at beginning of level
 
 void CObjectManager::ResetPlayerStats(){
-	if(g_nLevelState != NONE_STATE && (g_nGameState == GAMEOVER_GAMESTATE || g_nGameState == CHARSELECT_GAMESTATE)){
+	if(m_pWorld->m_nLevelState != NONE_STATE && (m_pWorld->m_nGameState == GAMEOVER_GAMESTATE || m_pWorld->m_nGameState == CHARSELECT_GAMESTATE)){
 		m_nPlayerLives = 2;
 		m_nAmmoCount[0] = 0;
 		m_nAmmoCount[1] = 0;
@@ -1131,5 +1471,364 @@ void CObjectManager::ResetPlayerStats(){
 	m_bDiedOfSpecial = FALSE;
 	m_nFiredShots = 0;
 	m_nHitShots = 0;
-	m_nEnemyCount = 0;
-} //ResetPlayerStats
\ No newline at end of file
+	m_pWorld->m_nEnemyCount = 0;
+} //ResetPlayerStats
+
+/// Grow the object pools so that the level can be played without any more
+/// heap allocation for game objects. Each pool is grown to hold the sum of
+/// the high water marks of the object types that live in it, or a default
+/// if that is smaller, and the cold pool to hold cold data for all of them.
+/// Should be called after clear, when all objects are
+/// back in their pools.
+
+void CObjectManager::PrewarmPools(){
+	int nEnemyOne = 0, nInvader = 0, nThief = 0, nObject = 0;
+
+	for(int i = 0; i < NUM_OBJECT_TYPES; i++){
+		switch(i){
+			case ENEMY1IDLE_OBJECT: nEnemyOne += m_nHighWaterMark[i]; break;
+			case ENEMYINVADERIDLE_OBJECT: nInvader += m_nHighWaterMark[i]; break;
+			case ENEMYTHIEFIDLE_OBJECT: nThief += m_nHighWaterMark[i]; break;
+			default: nObject += m_nHighWaterMark[i]; break;
+		} //switch
+
+		if(m_nHighWaterMark[i] > 0)
+			DEBUGPRINTF("Object type %d high water mark %d\n", i, m_nHighWaterMark[i]);
+	} //for
+
+	CGameObject::ReservePool(this, sizeof(CGameObject), max(nObject, PREWARM_OBJECTS));
+	CGameObject::ReservePool(this, sizeof(CEnemyOneObject), max(nEnemyOne, PREWARM_ENEMIES));
+	CGameObject::ReservePool(this, sizeof(CEnemyInvaderObject), max(nInvader, PREWARM_ENEMIES));
+	CGameObject::ReservePool(this, sizeof(CEnemyThiefObject), max(nThief, PREWARM_ENEMIES));
+	m_cColdPool.reserve(max(nObject, PREWARM_OBJECTS) + max(nEnemyOne, PREWARM_ENEMIES) +
+	  max(nInvader, PREWARM_ENEMIES) + max(nThief, PREWARM_ENEMIES)); //every object has cold data
+} //PrewarmPools
+
+/// Get the high water mark for an object type, that is, the largest number of
+/// objects of that type that have been in the object list at once.
+/// \param t Object type.
+/// \return High water mark.
+
+int CObjectManager::GetHighWaterMark(ObjectType t){
+	return m_nHighWaterMark[t];
+} //GetHighWaterMark
+
+/// Get the number of objects in the object list, not counting objects
+/// created this tick that are still in the spawn queue.
+/// \return Number of objects.
+
+int CObjectManager::GetObjectCount(){
+	return (int)m_stlObjectList.size();
+} //GetObjectCount
+
+/// Add some bytes to an FNV-1a hash.
+/// \param h Hash so far.
+/// \param p Pointer to the bytes.
+/// \param n Number of bytes.
+/// \return New hash.
+
+static unsigned HashBytes(unsigned h, const void* p, size_t n){
+	const unsigned char* b = (const unsigned char*)p;
+	for(size_t i = 0; i < n; i++)
+		h = (h ^ b[i])*FNV_PRIME;
+	return h;
+} //HashBytes
+
+/// Add a value to an FNV-1a hash, byte by byte.
+/// \param h Hash so far.
+/// \param x Value to add.
+/// \return New hash.
+
+template<class T> static unsigned HashValue(unsigned h, const T& x){
+	return HashBytes(h, &x, sizeof(T));
+} //HashValue
+
+/// Hash everything in the world that play depends on: each object in the
+/// list in order, with the components that its type has and its pending
+/// timer events, the player stats, the game flags, the screen scroll, and
+/// the state of the random number generator. Two runs that hash the same
+/// after every tick have played out the same, so this is what an input
+/// recording is checked against.
+/// Floats are hashed bit for bit, so the hash is only comparable between
+/// builds that do their arithmetic the same way.
+/// \return 32 bit hash of the world state.
+
+unsigned CObjectManager::HashState(){
+	unsigned h = FNV_OFFSET_BASIS;
+
+	for(CGameObject* p: m_stlObjectList){
+		h = HashValue(h, p->m_nObjectType);
+		h = HashValue(h, p->position());
+		if(p->HasComponent(VELOCITY_COMPONENT))h = HashValue(h, p->velocity());
+		h = HashValue(h, p->orientation());
+		if(p->HasComponent(COLLIDER_COMPONENT))h = HashValue(h, p->health());
+		h = HashValue(h, p->currentFrame());
+		if(p->HasComponent(VELOCITY_COMPONENT))h = HashValue(h, p->lastMoveTime());
+		h = HashValue(h, p->m_nFlags);
+		for(const TIMERNODE& e: p->m_pCold->m_sTimer)
+			h = HashValue(h, CTimerWheel::pending(e)? e.m_nDueTime: -1);
+	} //for
+
+	h = HashValue(h, m_nScore);
+	h = HashValue(h, m_nPlayerHealth);
+	h = HashValue(h, m_nPlayerLives);
+	h = HashValue(h, m_nAmmoCount);
+	h = HashValue(h, m_nFiredShots);
+	h = HashValue(h, m_nHitShots);
+	h = HashValue(h, m_nLastGunFireTime);
+	h = HashValue(h, m_nStartInvulnerableTime);
+	h = HashValue(h, m_pWorld->m_nEnemyCount);
+
+	h = HashValue(h, m_pWorld->m_nGameState);
+	h = HashValue(h, m_pWorld->m_fScreenScroll);
+	h = HashValue(h, m_pWorld->m_bShieldActive);
+	h = HashValue(h, m_pWorld->m_bAssistActive);
+	h = HashValue(h, m_pWorld->m_bPlayerIsInvulnerable);
+	h = HashValue(h, m_pWorld->m_bSpecialActivate);
+
+	return HashBytes(h, m_pWorld->m_cRandom.GetState(), 4*sizeof(unsigned));
+} //HashState
+
+/// Create an object of the right class for its type from a snapshot, the
+/// way createObject does for a new one.
+/// \param t Object type.
+/// \param s Snapshot.
+/// \return Pointer to the object.
+
+CGameObject* CObjectManager::RestoreObject(ObjectType t, CSnapshot& s){
+	if(t == ENEMY1IDLE_OBJECT)
+		return new(this) CEnemyOneObject(m_pWorld, s);
+	else if(t == ENEMYINVADERIDLE_OBJECT)
+		return new(this) CEnemyInvaderObject(m_pWorld, s);
+	else if(t == ENEMYTHIEFIDLE_OBJECT)
+		return new(this) CEnemyThiefObject(m_pWorld, s);
+	else return new(this) CGameObject(m_pWorld, t, s);
+} //RestoreObject
+
+/// Save the world to a snapshot: the player stats and game flags, the time,
+/// the random number generator, the objects in the object list and the spawn
+/// queue, and their pending timer events in the order that they will fire.
+/// Objects refer to each other only through registry handles, which are
+/// saved as they are, and timer events refer to objects by their index in
+/// the snapshot. The game state and the settings are not saved.
+/// \param s Snapshot, which is cleared first.
+
+void CObjectManager::SaveState(CSnapshot& s){
+	s.clear();
+	s.write(SNAPSHOT_MAGIC);
+
+	s.write(m_nLastGunFireTime);
+	s.write(m_nStartInvulnerableTime);
+	s.write(m_nScore);
+	s.write(m_bPlayerHit);
+	s.write(m_bGotHit);
+	s.write(m_bCollided);
+	s.write(m_bDiedOfAge);
+	s.write(m_bDiedOfDmg);
+	s.write(m_bDiedOfSpecial);
+	s.write(m_nFiredShots);
+	s.write(m_nHitShots);
+	s.write(m_nPlayerHealth);
+	s.write(m_nPlayerSpeed);
+	s.write(m_nAmmoCount);
+	s.write(m_nPlayerLives);
+	s.write(m_hPlayer);
+	s.write(m_pWorld->m_nEnemyCount);
+
+	s.write(m_pWorld->m_nLevelState);
+	s.write(m_pWorld->m_fScreenScroll);
+	s.write(m_pWorld->m_bShieldActive);
+	s.write(m_pWorld->m_bAssistActive);
+	s.write(m_pWorld->m_bPlayerIsInvulnerable);
+	s.write(m_pWorld->m_bSpecialActivate);
+
+	m_pWorld->m_cTimer.save(s);
+	m_pWorld->m_cRandom.save(s);
+	m_cRegistry.save(s);
+	m_cTimerWheel.save(s);
+
+	m_stlSnapshotIndex.clear();
+	s.write((int)m_stlObjectList.size());
+	s.write((int)m_pSpawnQueue.size());
+	for(CGameObject* p: m_stlObjectList){
+		m_stlSnapshotIndex[p] = (int)m_stlSnapshotIndex.size();
+		s.write((int)p->m_nObjectType);
+		p->save(s);
+	} //for
+	for(CGameObject* p: m_pSpawnQueue){
+		m_stlSnapshotIndex[p] = (int)m_stlSnapshotIndex.size();
+		s.write((int)p->m_nObjectType);
+		p->save(s);
+	} //for
+
+	m_pPendingEvents.clear();
+	m_cTimerWheel.GetPending(m_pPendingEvents);
+	s.write((int)m_pPendingEvents.size());
+	for(TIMERNODE* node: m_pPendingEvents){
+		s.write(m_stlSnapshotIndex[node->m_pObject]);
+		s.write((int)node->m_nEvent);
+		s.write(node->m_nDueTime);
+	} //for
+} //SaveState
+
+/// Restore the world from a snapshot taken by SaveState. All objects are
+/// deleted and the ones in the snapshot are created in their place, so
+/// pointers to objects are no longer good, but registry handles are. The
+/// player pointer is set to the restored player. The game goes on from the
+/// moment that the snapshot was taken, with the same random numbers, and
+/// plays out exactly as it did then given the same input.
+/// \param s Snapshot.
+/// \return TRUE if the snapshot was restored, FALSE if it isn't one.
+
+BOOL CObjectManager::RestoreState(CSnapshot& s){
+	s.rewind();
+	unsigned magic = 0;
+	if(!s.read(magic) || magic != SNAPSHOT_MAGIC)return FALSE;
+
+	DeleteObjects();
+
+	s.read(m_nLastGunFireTime);
+	s.read(m_nStartInvulnerableTime);
+	s.read(m_nScore);
+	s.read(m_bPlayerHit);
+	s.read(m_bGotHit);
+	s.read(m_bCollided);
+	s.read(m_bDiedOfAge);
+	s.read(m_bDiedOfDmg);
+	s.read(m_bDiedOfSpecial);
+	s.read(m_nFiredShots);
+	s.read(m_nHitShots);
+	s.read(m_nPlayerHealth);
+	s.read(m_nPlayerSpeed);
+	s.read(m_nAmmoCount);
+	s.read(m_nPlayerLives);
+	s.read(m_hPlayer);
+	s.read(m_pWorld->m_nEnemyCount);
+
+	s.read(m_pWorld->m_nLevelState);
+	s.read(m_pWorld->m_fScreenScroll);
+	s.read(m_pWorld->m_bShieldActive);
+	s.read(m_pWorld->m_bAssistActive);
+	s.read(m_pWorld->m_bPlayerIsInvulnerable);
+	s.read(m_pWorld->m_bSpecialActivate);
+
+	m_pWorld->m_cTimer.restore(s);
+	m_pWorld->m_cRandom.restore(s);
+	m_cRegistry.restore(s);
+	m_cTimerWheel.restore(s);
+
+	int listCount = 0, queueCount = 0;
+	s.read(listCount);
+	s.read(queueCount);
+	m_pSnapshotObject.clear();
+	for(int k = 0; k < listCount + queueCount; k++){
+		int t = 0;
+		s.read(t);
+		CGameObject* p = RestoreObject((ObjectType)t, s);
+		m_pSnapshotObject.push_back(p);
+		m_nLiveCount[t]++;
+		m_cRegistry.place(p->m_pCold->m_hHandle, p);
+		if(k < listCount){
+			m_stlObjectList.push_back(p);
+			p->listOrder() = listCount - k; //front of the list is newest
+		} //if
+		else m_pSpawnQueue.push_back(p);
+	} //for
+	m_nListOrder = listCount;
+
+	for(auto i = m_stlObjectList.rbegin(); i != m_stlObjectList.rend(); i++)
+		m_cDepthLayers.insert(*i); //oldest first, as they went in
+
+	int eventCount = 0;
+	s.read(eventCount);
+	for(int k = 0; k < eventCount; k++){
+		int index = 0, e = 0, due = 0;
+		s.read(index);
+		s.read(e);
+		s.read(due);
+		m_cTimerWheel.schedule(m_pSnapshotObject[index]->m_pCold->m_sTimer[e], due);
+	} //for
+
+	m_pWorld->m_pPlayer = GetPlayerObjectPtr();
+	return TRUE;
+} //RestoreState
+
+/// Set the size of the rewind buffer. Any rewind snapshots are thrown away.
+/// \param n Number of snapshots to keep, 0 for no rewind.
+/// \param interval Time between snapshots in ms.
+
+void CObjectManager::SetRewind(int n, int interval){
+	m_cRewind.SetSize(n, interval);
+} //SetRewind
+
+/// Take a rewind snapshot if it is time for one. Should be called between
+/// ticks, outside of move.
+
+void CObjectManager::UpdateRewind(){
+	const long long t = m_pWorld->m_cTimer.microtime();
+	if(m_cRewind.due(t))
+		SaveState(m_cRewind.push(t));
+} //UpdateRewind
+
+/// Go back to a rewind snapshot. It and the snapshots after it are thrown
+/// away, so going back again goes back further.
+/// \param n 1 for the newest snapshot, 2 for the one before, and so on.
+/// \return TRUE if there was a snapshot that far back.
+
+BOOL CObjectManager::rewind(int n){
+	CSnapshot* s = m_cRewind.get(n - 1);
+	if(s == nullptr || !RestoreState(*s))return FALSE;
+	m_cRewind.pop(n);
+	return TRUE;
+} //rewind
+
+/// Take the snapshot that RestartLevel goes back to. Should be called once
+/// the level has been set up.
+
+void CObjectManager::SaveLevelStart(){
+	SaveState(m_cLevelStart);
+	m_cRewind.clear();
+} //SaveLevelStart
+
+/// Restart the level by restoring the snapshot taken when it began, instead
+/// of creating it all over again.
+/// \return TRUE if the level was restarted, FALSE if there is no snapshot.
+
+BOOL CObjectManager::RestartLevel(){
+	if(m_cLevelStart.empty() || !RestoreState(m_cLevelStart))return FALSE;
+	m_cRewind.clear();
+	return TRUE;
+} //RestartLevel
+
+/// Choose between the broadphase grid and testing every target for
+/// collision detection. Both give the same collisions, the switch is
+/// there so that the results and frame times can be compared.
+/// \param broadphase TRUE to use the grid, FALSE to test every target, in a
+/// batch or by brute force as SetNarrowphase says.
+/// \param cellsize Width of a grid cell, ignored if not positive.
+
+void CObjectManager::SetBroadphase(BOOL broadphase, float cellsize){
+	m_bBroadphase = broadphase;
+	m_cGrid.SetCellSize(cellsize);
+} //SetBroadphase
+
+/// Choose whether projectiles are tested for collision along the whole of
+/// their move each tick, or only where they end up. Testing the move means
+/// that no hits are missed when projectiles move further than the collision
+/// radius in a tick, as they do at low tick rates or when catching up after
+/// a long frame. It finds a few more hits at any rate, so it is off unless
+/// asked for, to keep recordings playing back the same.
+/// \param swept TRUE to test the whole move.
+
+void CObjectManager::SetSwept(BOOL swept){
+	m_bSwept = swept;
+} //SetSwept
+
+/// Choose how every target is tested when the broadphase is off: all at
+/// once in a SIMD batch, or one pair at a time in the brute force loop.
+/// Both give the same collisions, so this is for comparing frame times.
+/// \param narrowphase TRUE for the batch, FALSE for brute force.
+
+void CObjectManager::SetNarrowphase(BOOL narrowphase){
+	m_bNarrowphase = narrowphase;
+} //SetNarrowphase
\ No newline at end of file
@@ -7,20 +7,65 @@
 #include <string>
 #include <unordered_map>
 
-#include "object.h"
+#include "Object.h"
 #include "Defines.h"
+#include "SpatialGrid.h"
+#include "Narrowphase.h"
+#include "ObjectRegistry.h"
+#include "DepthLayers.h"
+#include "CollisionMatrix.h"
+#include "TimerWheel.h"
+#include "Snapshot.h"
+#include "RewindBuffer.h"
+#include "ObjectPool.h"
+#include "EntityStore.h"
+#include "ObjectTraits.h"
+#include "Integrator.h"
+
+class CGameObject;
+class CWorld;
+struct OBJECTCOLD;
+
+const int MAX_OBJECT_POOLS = 8; ///< Most distinct object sizes that get their own pool.
+
+/// \brief A target that a projectile's move passes through.
+
+struct SWEPTHIT{
+  float m_fTime; ///< Time of impact, as a fraction of the move.
+  int m_nId; ///< Grid id of the target.
+}; //SWEPTHIT
+
+/// \brief A vulnerable object gathered from the entity store for the grid.
+
+struct GRIDTARGET{
+  unsigned m_nOrder; ///< Place in the object list, larger is nearer the front.
+  float m_fX; ///< X coordinate.
+  float m_fY; ///< Y coordinate.
+  CGameObject* m_pObject; ///< The object.
+}; //GRIDTARGET
 
 /// \brief The object manager. 
 ///
 /// The object manager is responsible for the care and feeding of
-/// game objects. Objects can be named on creation so that they
-/// can be accessed later - this is needed in particular for the player
-/// object or objects.
+/// game objects. Objects of the types registered in the constructor
+/// can be accessed later by name or handle - this is needed in particular
+/// for the player object or objects. Each world has its own object
+/// manager, and the objects' memory comes from pools that the manager owns,
+/// so worlds on different threads never share a free list. The objects'
+/// components are kept in the manager's entity store, and passes that only
+/// need a few components, such as moving, walk the store instead of the
+/// object list. Their cold data comes from a pool of its own.
 
 class CObjectManager{
   private:
+    CWorld* m_pWorld; ///< World that the objects are in.
     list<CGameObject*> m_stlObjectList; ///< List of game objects.
-    unordered_map<string, CGameObject*> m_stlNameToObject; ///< Map names to objects.
+    vector<CGameObject*> m_pSpawnQueue; ///< Objects created this tick, not yet in the object list.
+    unsigned m_nListOrder; ///< Place in the object list of the object that went in last.
+    vector<CGameObject*> m_pMoveBucket[NUM_MOVE_BUCKETS]; ///< Objects of each move kind, in object list order.
+    CDepthLayers m_cDepthLayers; ///< Objects in the object list, bucketed by Z for drawing.
+    CObjectRegistry m_cRegistry; ///< Named objects.
+    ObjectHandle m_hPlayer; ///< Handle to the current player incarnation.
     unordered_map<string, ObjectType> m_stlNameToObjectType; ///< Map names to object types.
     
     int m_nLastGunFireTime; ///< Time gun was last fired.
@@ -41,34 +86,93 @@ class CObjectManager{
 		int m_nAmmoCount[3]; ///< Ammo count for letters 2,3,4 respectively.
 		int m_nPlayerLives; ///< Player's life count.
 
+    CSpatialGrid m_cGrid; ///< Broadphase grid of vulnerable objects, rebuilt every tick.
+    vector<CGameObject*> m_pGridObjects; ///< Objects in the grid, indexed by grid id.
+    vector<GRIDTARGET> m_sGridTargets; ///< Vulnerable objects gathered from the entity store, while building the grid.
+    vector<int> m_nCandidates; ///< Grid ids returned by the last grid query.
+    CNarrowphase m_cNarrowphase; ///< Positions of the objects in the grid, packed for batched tests.
+    vector<unsigned> m_nHits; ///< Hit mask returned by the last narrowphase test, by grid id.
+    BOOL m_bBroadphase; ///< TRUE to use the grid, FALSE for brute force collision detection.
+    BOOL m_bSwept; ///< TRUE to test the whole move of each projectile, FALSE for just where it ended up.
+    BOOL m_bNarrowphase; ///< TRUE to test every target in one batch when the grid is off, FALSE for brute force.
+    vector<SWEPTHIT> m_sSweptHits; ///< Targets hit by the last swept test, by time of impact.
+    CCollisionMatrix m_cCollisionMatrix; ///< Which pairs of types collide, and how.
+    CTimerWheel m_cTimerWheel; ///< Pending timer events of all objects.
+    vector<TIMERNODE*> m_pFiredEvents; ///< Timer events that are due this tick.
+
+    CRewindBuffer m_cRewind; ///< Snapshots taken every so often, for going back.
+    CSnapshot m_cLevelStart; ///< Snapshot taken when the level began, for restarting it.
+    vector<CGameObject*> m_pSnapshotObject; ///< Objects in snapshot order, while restoring.
+    unordered_map<CGameObject*, int> m_stlSnapshotIndex; ///< Index of each object in snapshot order, while saving.
+    vector<TIMERNODE*> m_pPendingEvents; ///< Pending timer events, while saving.
+
+    typedef void (CObjectManager::*CollisionHandler)(CGameObject* p0, CGameObject* p1); ///< Collision response handler.
+    static const CollisionHandler m_pCollisionHandler[NUM_COLLISION_RESPONSES]; ///< Handler for each collision response.
+
+    int m_nLiveCount[NUM_OBJECT_TYPES]; ///< Number of objects of each type in the object list.
+    int m_nHighWaterMark[NUM_OBJECT_TYPES]; ///< Most objects of each type ever in the object list at once.
+    int m_nFirstTransition[NUM_OBJECT_TYPES]; ///< Index of first transition for each type, -1 if none.
+
+    CEntityStore m_cEntities; ///< Components of the objects, in archetype chunks.
+    CIntegrator m_cIntegrator; ///< Moves the entities along their velocities.
+
+    CObjectPool* m_pPool[MAX_OBJECT_POOLS]; ///< Object pools, one per object size.
+    size_t m_nPoolSize[MAX_OBJECT_POOLS]; ///< Size of objects in each pool.
+    int m_nPoolCount; ///< Number of object pools.
+    CObjectPool m_cColdPool; ///< Pool for the objects' cold data.
+
+    void integrate(); ///< Move every entity along its velocity.
+    void FillMoveBuckets(); ///< Sort the object list into move buckets.
+
     //distance functions
     float distance(CGameObject *g0, CGameObject *g1); ///< Distance between objects.
 
     //collision detection
+    void BuildGrid(); ///< Rebuild the broadphase grid and narrowphase targets.
     void CollisionDetection(); ///< Process all collisions.
     void CollisionDetection(CGameObject* i); ///< Process collisions of all with one object.
     void CollisionDetection(CGameObject* i, CGameObject* j); ///< Process collisions of 2 objects.
+    void SweptCollisionDetection(CGameObject* p); ///< Process collisions along a projectile's move.
+    void CollisionResponse(CGameObject* i, CGameObject* j); ///< Respond to 2 objects in range.
+
+    //collision responses
+    void PlayerHit(CGameObject* p0, CGameObject* p1); ///< Player runs into something harmful.
+    void SpikedHit(CGameObject* p0, CGameObject* p1); ///< Letter shot hits something spiked.
+    void PierceHit(CGameObject* p0, CGameObject* p1); ///< Piercing shot hits an enemy.
+    void ShotHit(CGameObject* p0, CGameObject* p1); ///< Letter shot hits an enemy.
+    void HeartPickup(CGameObject* p0, CGameObject* p1); ///< Player picks up a heart.
+    void LetterPickup(CGameObject* p0, CGameObject* p1); ///< Player picks up a letter item.
 
     //managing dead objects
-    void cull(); ///< Cull dead objects
+    void AddObject(CGameObject* p); ///< Queue a new object for the object list.
+    void CountObject(CGameObject* p); ///< Count an object against its type.
+    void RegisterObject(CGameObject* p); ///< Register an object under its type's name.
+    void FlushSpawnQueue(); ///< Put queued objects into the object list.
+    void FireTimerEvents(); ///< Act on timer events that are due.
+    void GarbageCollect(); ///< Collect dead objects and add queued ones.
+    void DeleteObjects(); ///< Delete all objects.
+    CGameObject* RestoreObject(ObjectType t, CSnapshot& s); ///< Create an object from a snapshot.
     void CreateNextIncarnation(CGameObject* object); ///< Replace object by next in series.
+    BOOL TransitionHolds(TransitionType when, CGameObject* object); ///< Check a transition condition.
 
   public:
-    CObjectManager(); ///< Constructor.
+    CObjectManager(CWorld* world); ///< Constructor.
     ~CObjectManager(); ///< Destructor.
-		void GarbageCollect(); ///< Collect dead objects from object list.
 		CGameObject * createObject(ObjectType obj, const char * name, const Vector3 & s, const Vector3 & v);
 		CGameObject * createObject(ObjectType obj, const char * name, const Vector3 & s, const Vector3 & v, int health);
 		///< Create new object.
+		CGameObject* ChangeIncarnation(CGameObject* object, ObjectType t, const char* name,
+		  const Vector3& s, const Vector3& v, int health=-1); ///< Turn an object into another type.
 		
 		void clear(); ///< Reset to initial conditions.
 		void move(); ///< Move all objects.
     void draw(); ///< Draw all objects.
 
     CGameObject* GetObjectByName(const char* name); ///< Get pointer to object by name.
+    CGameObject* GetObjectByHandle(ObjectHandle h); ///< Get pointer to object by handle.
     void InsertObjectType(const char* objname, ObjectType t); ///< Map name string to object type enumeration.
     ObjectType GetObjectType(const char* name); ///< Get object type corresponding to name string.
-		unordered_map<string, CGameObject*>::iterator GetPlayerObject(); ///< Get iterator to player object.
+		ObjectHandle GetPlayerObject(); ///< Get handle to player object.
 		CGameObject* GetPlayerObjectPtr(); ///< Get pointer to player object.
     
     void FireGun(); ///< Fire a gun from named object.
@@ -77,6 +181,12 @@ class CObjectManager{
 		void CreateAssist(); ///< Create a small version of the player for double shots.
 		void SpecialAttack(); ///< Unleash special attack.
 
+		ObjectType GetPlayerType(); ///< Get the type of the current player incarnation.
+		void MovePlayer(DirectionType d); ///< Start the player moving.
+		void StopPlayer(DirectionType d); ///< Stop the player moving one way.
+		void PlayerAttack(ObjectType t, const char* name); ///< Turn the player into its attack incarnation.
+		void FireAs(ObjectType idle, ObjectType attack, const char* name); ///< Fire a letter shot as one of the players.
+
 		void dropChance(Vector3 p, Vector3 v);
 		int getScore();
 		BOOL gotHit();
@@ -88,6 +198,27 @@ class CObjectManager{
 		int getPlayerLives();
 		void setPlayer(int n, float i);
 		float getPlayerSpeed();
-		void DeleteNameToObject();
 		void ResetPlayerStats();
+		void SetBroadphase(BOOL broadphase, float cellsize); ///< Choose grid or every-target collision detection.
+		void SetSwept(BOOL swept); ///< Choose continuous or discrete collision detection for projectiles.
+		void SetNarrowphase(BOOL narrowphase); ///< Choose batched or brute force collision detection without the grid.
+		void PrewarmPools(); ///< Grow object pools to the largest object counts seen.
+		CObjectPool* GetPool(size_t size); ///< Get the pool for objects of this size.
+		OBJECTCOLD* NewColdData(); ///< Get cold data for a new object.
+		void DeleteColdData(OBJECTCOLD* p); ///< Give back an object's cold data.
+		const ARENABOUNDS& GetArenaBounds(); ///< Edges of the arena this frame.
+		void AddEntity(CGameObject* p, ObjectType t); ///< Give an object its components.
+		void RemoveEntity(CGameObject* p); ///< Take away an object's components.
+		int GetHighWaterMark(ObjectType t); ///< Most objects of a type alive at once.
+		int GetObjectCount(); ///< Number of objects in the object list.
+		void ScheduleEvent(TIMERNODE& node, int due); ///< Put a timer event into the timer wheel.
+		unsigned HashState(); ///< Hash the world state, to check that a replay matches.
+
+		void SaveState(CSnapshot& s); ///< Save the world to a snapshot.
+		BOOL RestoreState(CSnapshot& s); ///< Restore the world from a snapshot.
+		void SetRewind(int n, int interval); ///< Set how many snapshots to keep for rewind and how often.
+		void UpdateRewind(); ///< Take a rewind snapshot if one is due.
+		BOOL rewind(int n); ///< Go back n rewind snapshots.
+		void SaveLevelStart(); ///< Take the snapshot for restarting the level.
+		BOOL RestartLevel(); ///< Go back to the start of the level.
 }; //CObjectManager
\ No newline at end of file
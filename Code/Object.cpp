@@ -1,323 +1,451 @@
 /// \file object.cpp
 /// \brief Code for the game object class CGameObject.
 
-#include "object.h"
+#include "Object.h"
 #include "ObjMan.h"
-#include "defines.h" 
-#include "timer.h"
+#include "Defines.h" 
+#include "Timer.h"
 #include "debug.h" 
-#include "spriteman.h" 
-#include "sound.h"
+#include "SpriteMan.h" 
+#include "Sound.h"
 #include "Random.h"
-#include "GameRenderer.h"
+#include "Snapshot.h"
+#include "World.h"
 
-extern CTimer g_cTimer;
 extern int g_nScreenWidth;
 extern int g_nScreenHeight;
-extern int m_nEnemyCount;
-extern float g_fScreenScroll;
-extern XMLElement* g_xmlSettings;
+extern CObjectSettings g_cObjectSettings;
+extern CAnimationStore g_cAnimationStore;
 extern CSpriteManager g_cSpriteManager;
-extern CSoundManager* g_pSoundManager;
-extern CObjectManager g_cObjectManager;
-extern CRandom g_cRandom; ///< The random number generator.
 extern BOOL g_bEndOfFirstLevel;
-extern BOOL g_bPlayerIsInvulnerable;
-extern BOOL g_bShieldActive;
-extern BOOL g_bAssistActive;
-CGameRenderer* g_cGameRenderer;
 
-/// Initialize a game object. Gets object-dependent settings from g_xmlSettings
-/// from the "object" tag that has the same "name" attribute as parameter name.
+const int FLY_INTERVAL = 17; ///< Time between steps of a hurt enemy flying off, in ms.
+const float SHOT_SPIN = 0.20f*3.14f/180; ///< How far letter shots turn each frame, in radians.
+const size_t POOL_HEADER_SIZE = 16; ///< Bytes in front of each object saying which pool it came from, keeps it aligned.
+
+/// Initialize a game object. Gets object-dependent settings from g_cObjectSettings
+/// for the "object" tag that has the same "name" attribute as parameter name.
 /// Assumes that the sprite manager has loaded the sprites already.
+/// \param world World that the object is in
+/// \param object Object type
+/// \param name Object name in XML settings file object tag
+/// \param s Initial location of object
+/// \param v Initial velocity
+
+CGameObject::CGameObject(CWorld* world, ObjectType object, const char* name, const Vector3& s, const Vector3& v){ 
+  m_pWorld = world;
+  m_pWorld->m_cObjectManager.AddEntity(this, object);
+  m_pCold = m_pWorld->m_cObjectManager.NewColdData();
+  m_nFlags = 0;
+  m_pCold->m_hHandle = NULL_HANDLE;
+  m_pCold->m_nDepthKey = 0;
+  for(int i=0; i<NUM_TIMER_EVENTS; i++)
+    CTimerWheel::init(m_pCold->m_sTimer[i], this, (TimerEventType)i);
+
+  Incarnate(object, name, s, v);
+} //constructor
+
+/// Restore a game object from a snapshot. Nothing happens that would
+/// happen to a new object: no random numbers are drawn, no sound is played
+/// and no timer events are asked for, since the object manager puts those
+/// back in the order they were in.
+/// \param world World that the object is in.
+/// \param object Object type, which the object manager saves.
+/// \param s Snapshot, positioned at what save wrote.
+
+CGameObject::CGameObject(CWorld* world, ObjectType object, CSnapshot& s){
+  m_pWorld = world;
+  m_pWorld->m_cObjectManager.AddEntity(this, object);
+  m_nObjectType = object;
+  sprite() = g_cSpriteManager.GetSprite(object);
+  m_pCold = m_pWorld->m_cObjectManager.NewColdData();
+  m_pCold->m_nDepthKey = 0;
+  for(int i=0; i<NUM_TIMER_EVENTS; i++)
+    CTimerWheel::init(m_pCold->m_sTimer[i], this, (TimerEventType)i);
+
+  s.read(m_nFlags);
+  s.read(position());
+  if(HasComponent(VELOCITY_COMPONENT)){
+    s.read(velocity());
+    s.read(spin());
+    s.read(lastMoveTime());
+  } //if
+  s.read(m_pCold->m_nAttackOrientation);
+  s.read(m_pCold->m_nDelayTime);
+  s.read(orientation());
+  if(HasComponent(COLLIDER_COMPONENT))s.read(health());
+  s.read(currentFrame());
+  s.read(frameCount());
+  s.read(frameInterval());
+  s.read(animation());
+  s.read(m_pCold->m_nWidth);
+  s.read(m_pCold->m_nHeight);
+  if(HasComponent(LIFETIME_COMPONENT)){
+    s.read(lifeTime());
+    s.read(invulnerableTime());
+  } //if
+  s.read(m_pCold->m_nSoundInstance);
+  s.read(m_pCold->m_hHandle);
+} //constructor
+
+/// Save to a snapshot everything that the snapshot constructor reads back,
+/// in the same order. Components that the object's type doesn't have are
+/// left out. Derived classes save this first and then their own.
+/// \param s Snapshot.
+
+void CGameObject::save(CSnapshot& s){
+  s.write(m_nFlags);
+  s.write(position());
+  if(HasComponent(VELOCITY_COMPONENT)){
+    s.write(velocity());
+    s.write(spin());
+    s.write(lastMoveTime());
+  } //if
+  s.write(m_pCold->m_nAttackOrientation);
+  s.write(m_pCold->m_nDelayTime);
+  s.write(orientation());
+  if(HasComponent(COLLIDER_COMPONENT))s.write(health());
+  s.write(currentFrame());
+  s.write(frameCount());
+  s.write(frameInterval());
+  s.write(animation());
+  s.write(m_pCold->m_nWidth);
+  s.write(m_pCold->m_nHeight);
+  if(HasComponent(LIFETIME_COMPONENT)){
+    s.write(lifeTime());
+    s.write(invulnerableTime());
+  } //if
+  s.write(m_pCold->m_nSoundInstance);
+  s.write(m_pCold->m_hHandle);
+} //save
+
+/// Set up this object as a newly created object of the given type. This is
+/// the constructor's work, and it is also used by the object manager to turn
+/// an object into its next incarnation in place, so everything that belongs
+/// to one incarnation must be reset here. By then the object has the
+/// components of its new type, and only those are set. The object keeps its
+/// memory, its class and its place in the object list, and the object
+/// manager gives it a new registry handle afterwards.
 /// \param object Object type
 /// \param name Object name in XML settings file object tag
 /// \param s Initial location of object
 /// \param v Initial velocity
 
-CGameObject::CGameObject(ObjectType object, const char* name, const Vector3& s, const Vector3& v){ 
+void CGameObject::Incarnate(ObjectType object, const char* name, const Vector3& s, const Vector3& v){ 
   //defaults
-  m_nCurrentFrame = 0; 
-  m_nLastFrameTime = g_cTimer.time();
-  m_nFrameInterval = 30; 
+  currentFrame() = 0; 
   
-	m_nDelayTime = 0;
-  m_nLifeTime = -1; //negative means immortal
-	m_nInvulnerableTime = 0;
-  m_bVulnerable = FALSE; 
-  m_bIntelligent = FALSE;
-  m_bIsDead = FALSE;
+	m_pCold->m_nDelayTime = 0;
+  SetFlag(DEAD_FLAG, FALSE);
+  SetFlag(CANFIRE_FLAG, TRUE);
 
-	m_nAttackOrientation = 0.0f;
-	m_nHealth = 3;
-
-  m_pAnimation = nullptr;
-  m_nAnimationFrameCount = 0;
-  m_bCycleSprite = TRUE;
+	m_pCold->m_nAttackOrientation = 0.0f;
+  orientation() = 0.0f;
+	if(HasComponent(COLLIDER_COMPONENT))health() = 3;
 
   //common values
   m_nObjectType = object; //type of object
 
-  m_pSprite = g_cSpriteManager.GetSprite(object); //sprite pointer
-  if(m_pSprite){
-    m_nFrameCount = m_pSprite->m_nFrameCount; //get frame count
-		m_nCurrentFrame = 0;
-    m_nHeight = m_pSprite->m_nHeight; //get object height from sprite
-    m_nWidth = m_pSprite->m_nWidth; //get object width from sprite
+  sprite() = g_cSpriteManager.GetSprite(object); //sprite pointer
+  if(sprite()){
+    frameCount() = sprite()->m_nFrameCount; //get frame count
+		currentFrame() = 0;
+    m_pCold->m_nHeight = sprite()->m_nHeight; //get object height from sprite
+    m_pCold->m_nWidth = sprite()->m_nWidth; //get object width from sprite
   } //if
 
-  m_nLastMoveTime = g_cTimer.time(); //time
-  m_nBirthTime = g_cTimer.time(); //time of creation
-  m_vPos = s; //location
-  m_vVelocity = v;  //velocity
+  position() = s; //location
+  if(HasComponent(VELOCITY_COMPONENT)){
+    lastMoveTime() = m_pWorld->m_cTimer.microtime(); //time
+    velocity() = v;  //velocity
+    spin() = HasTrait(object, PLAYERSHOT_TRAIT)? -SHOT_SPIN: 0.0f; //letter shots turn as they go
+  } //if
   
-  //object-dependent settings loaded from XML
-  LoadSettings(name);
-  m_nFrameInterval += g_cRandom.number(-m_nFrameInterval/10, m_nFrameInterval/10);
+  //object-dependent settings compiled from XML
+  const OBJECTSETTINGS& settings = g_cObjectSettings.GetSettings(object, name);
+  frameInterval() = settings.m_nFrameInterval;
+  if(HasComponent(LIFETIME_COMPONENT)){
+    lifeTime() = settings.m_nLifeTime;
+    invulnerableTime() = settings.m_nInvulnerableTime;
+  } //if
+  SetFlag(VULNERABLE_FLAG, settings.m_bVulnerable);
+  SetFlag(CYCLESPRITE_FLAG, settings.m_bCycleSprite);
+  animation() = settings.m_sAnimation; //shared, not owned
+  frameInterval() += m_pWorld->m_cRandom.number(-frameInterval()/10, frameInterval()/10);
+
+  //timer events of the previous incarnation no longer apply
+  for(int i=0; i<NUM_TIMER_EVENTS; i++)
+    CTimerWheel::cancel(m_pCold->m_sTimer[i]);
+
+  if(animation().m_nCount > 0)schedule(FRAME_EVENT, GetFrameInterval());
+  if(HasTrait(object, HURTENEMY_TRAIT))schedule(FLY_EVENT, FLY_INTERVAL);
+  if(settings.m_nLifeTime > 0)schedule(EXPIRE_EVENT, settings.m_nLifeTime + 1); //dies when older than its life time
 
   //sound played at creation of object
-  m_nSoundInstance = -1;
+  m_pCold->m_nSoundInstance = -1;
 
   switch(object){
     case PROJECTILEF_OBJECT:
-      m_nSoundInstance = g_pSoundManager->play(SHOOT_SOUND);
+      m_pCold->m_nSoundInstance = m_pWorld->m_pSoundManager->play(SHOOT_SOUND);
       break;
 
 		case PROJECTILES_OBJECT:
-			m_nSoundInstance = g_pSoundManager->play(SHOOT_SOUND);
+			m_pCold->m_nSoundInstance = m_pWorld->m_pSoundManager->play(SHOOT_SOUND);
 			break;
 
 		case PROJECTILEP_OBJECT:
-			m_nSoundInstance = g_pSoundManager->play(SHOOT_SOUND);
+			m_pCold->m_nSoundInstance = m_pWorld->m_pSoundManager->play(SHOOT_SOUND);
 			break;
 		case PROJECTILED_OBJECT:
-			m_nSoundInstance = g_pSoundManager->play(SHOOT_SOUND);
+			m_pCold->m_nSoundInstance = m_pWorld->m_pSoundManager->play(SHOOT_SOUND);
 			break;
 
 		case PROJECTILEZ_OBJECT:
-			m_nSoundInstance = g_pSoundManager->play(SHOOT_SOUND);
+			m_pCold->m_nSoundInstance = m_pWorld->m_pSoundManager->play(SHOOT_SOUND);
 			break;
 
 		case PROJECTILEK_OBJECT:
-			m_nSoundInstance = g_pSoundManager->play(SHOOT_SOUND);
+			m_pCold->m_nSoundInstance = m_pWorld->m_pSoundManager->play(SHOOT_SOUND);
 			break;
   } //switch
-} //constructor
+} //Incarnate
+
 
+/// Take any pending timer events out of the timer wheel, and give back the
+/// object's cold data and its row in the entity store.
 
 CGameObject::~CGameObject(){  
-  delete[] m_pAnimation;
+  for(int i=0; i<NUM_TIMER_EVENTS; i++)
+    CTimerWheel::cancel(m_pCold->m_sTimer[i]);
+  m_pWorld->m_cObjectManager.DeleteColdData(m_pCold);
+  m_pWorld->m_cObjectManager.RemoveEntity(this);
 } //destructor
 
-/// Draw the current sprite frame at the current position, then
-/// compute which frame is to be drawn next time.
+/// Allocate memory for a game object from the object manager's pool for its
+/// size. Falls back to the heap if there is no pool. The pool is written in
+/// a header in front of the object, so that operator delete can give the
+/// memory back to the right world without asking the object, which has been
+/// destroyed by then.
+/// \param size Object size in bytes.
+/// \param manager Object manager of the world that the object is in.
+/// \return Pointer to memory for the object.
+
+void* CGameObject::operator new(size_t size, CObjectManager* manager){
+  CObjectPool* pool = manager->GetPool(size + POOL_HEADER_SIZE);
+  char* block = (char*)(pool? pool->allocate(): ::operator new(size + POOL_HEADER_SIZE));
+  *(CObjectPool**)block = pool;
+  return block + POOL_HEADER_SIZE;
+} //operator new
+
+/// Return the memory for a game object whose constructor threw.
+/// \param p Pointer to object memory.
+/// \param manager Object manager that the memory came from.
+
+void CGameObject::operator delete(void* p, CObjectManager* manager){
+  operator delete(p, (size_t)0);
+} //operator delete
+
+/// Return the memory for a game object to the pool it came from.
+/// \param p Pointer to object memory.
+/// \param size Object size in bytes, unused since the header says which pool.
+
+void CGameObject::operator delete(void* p, size_t size){
+  if(p == nullptr)return;
+  char* block = (char*)p - POOL_HEADER_SIZE;
+  CObjectPool* pool = *(CObjectPool**)block;
+  if(pool)pool->release(block);
+  else ::operator delete(block);
+} //operator delete
+
+/// Make sure that n objects of a given size can be created in an object
+/// manager without any heap allocation.
+/// \param manager Object manager.
+/// \param size Object size in bytes.
+/// \param n Number of objects.
+
+void CGameObject::ReservePool(CObjectManager* manager, size_t size, int n){
+  CObjectPool* pool = manager->GetPool(size + POOL_HEADER_SIZE);
+  if(pool)pool->reserve(n);
+} //ReservePool
+
+/// Draw the current sprite frame at the current position.
 
 void CGameObject::draw(){
-  if(m_pSprite == nullptr)return;
-  if(m_bIsDead)return; //bail if already dead
-
-  int t = m_nFrameInterval;
-  if(m_bCycleSprite)
-    t = (int)(t/(1.5f + fabs(m_vVelocity.x)));
-
-   BOOL ghost = ((m_nObjectType == FREDHURT_OBJECT || m_nObjectType == SWAZHURT_OBJECT || m_nObjectType == POLKHURT_OBJECT));
-
-  if(m_pAnimation != nullptr){ //if there's an animation sequence
-    //draw current frame
-    m_pSprite->Draw(m_vPos, m_fOrientation, m_pAnimation[m_nCurrentFrame], FALSE);
-    //advance to next frame
-    if(g_cTimer.elapsed(m_nLastFrameTime, t)) //if enough time passed
-      //increment and loop if necessary
-      if(++m_nCurrentFrame >= m_nAnimationFrameCount && m_bCycleSprite) 
-        m_nCurrentFrame = 0;
-  } //if
+  if(sprite() == nullptr)return;
+  if(GetFlag(DEAD_FLAG))return; //bail if already dead
+
+   BOOL ghost = HasTrait(m_nObjectType, HURTPLAYER_TRAIT);
+
+  if(animation().m_nCount > 0) //if there's an animation sequence
+    sprite()->Draw(position(), orientation(), g_cAnimationStore.frame(animation(), currentFrame()), FALSE);
   else 
-       m_pSprite->Draw(m_vPos, m_fOrientation, 0, ghost); //assume only one frame
+       sprite()->Draw(position(), orientation(), 0, ghost); //assume only one frame
 } //draw
 
-/// Load settings for object from g_xmlSettings.
-/// \param name name of object as found in name tag of XML settings file
-
-void CGameObject::LoadSettings(const char* name){
-  if(g_xmlSettings){ //got "settings" tag
-    //get "objects" tag
-    XMLElement* objSettings =
-      g_xmlSettings->FirstChildElement("objects"); //objects tag
-
-    if(objSettings){ //got "objects" tag
-      //set obj to the first "object" tag with the correct name
-      XMLElement* obj = objSettings->FirstChildElement("object");
-      while(obj && strcmp(name, obj->Attribute("name"))){
-        obj = obj->NextSiblingElement("object");
-      } //while
-
-      if(obj){ //got "object" tag with right name
-        //get object information from tag
-				m_nFrameInterval = obj->IntAttribute("frameinterval");
-        m_bVulnerable = obj->BoolAttribute("vulnerable");
-        m_bCycleSprite = obj->BoolAttribute("cycle");
-        m_nLifeTime = obj->IntAttribute("lifetime");
-				m_nInvulnerableTime = obj->IntAttribute("invulnerabletime");
-
-        //parse animation sequence
-        if(obj->Attribute("animation")){ //sequence present
-
-          //get sequence length
-          size_t length = strlen(obj->Attribute("animation"));
-          m_nAnimationFrameCount = 1; //one more than number of commas
-          for(size_t i = 0; i<length; i++) //for each character
-          if(obj->Attribute("animation")[i] == ',')
-            m_nAnimationFrameCount++; //count commas
-
-          m_pAnimation = new int[m_nAnimationFrameCount]; //memory for animation sequence
-
-          size_t i = 0; //character index
-          int count = 0; //number of frame numbers input
-          int num; //frame number
-          char c = obj->Attribute("animation")[i]; //character in sequence string
-          while(i < length){
-            //get next frame number
-            num = 0;
-            while(i<length && c >= '0' && c <= '9'){
-              num = num * 10 + c - '0';
-              c = obj->Attribute("animation")[++i];
-            }
-            //process frame number
-            c = obj->Attribute("animation")[++i]; //skip over comma
-            m_pAnimation[count++] = num; //record frame number
-          } //while
-        } //if
-      } //if
+/// Ask the object manager for a timer event. If one of the same type is
+/// already pending it is replaced.
+/// \param e Event type.
+/// \param delay Time from now until the event, in ms.
+
+void CGameObject::schedule(TimerEventType e, int delay){
+  m_pWorld->m_cObjectManager.ScheduleEvent(m_pCold->m_sTimer[e], m_pWorld->m_cTimer.time() + delay);
+} //schedule
+
+/// Get the time that the current animation frame is shown for. Sprites
+/// that cycle animate faster when the object moves faster.
+/// \return Time in ms.
+
+int CGameObject::GetFrameInterval(){
+  int t = frameInterval();
+  if(GetFlag(CYCLESPRITE_FLAG) && HasComponent(VELOCITY_COMPONENT))
+    t = (int)(t/(1.5f + fabs(velocity().x)));
+  return t;
+} //GetFrameInterval
+
+/// Go to the next frame of the animation sequence, looping if the sprite
+/// cycles, and ask for a timer event for the frame after that.
+/// \return TRUE if the sprite plays once and has just finished.
+
+BOOL CGameObject::AdvanceFrame(){
+  if(++currentFrame() >= animation().m_nCount){ //past the end
+    if(!GetFlag(CYCLESPRITE_FLAG)){ //played once
+      currentFrame() = animation().m_nCount - 1; //hold the last frame
+      return TRUE;
     } //if
+    currentFrame() = 0;
   } //if
-} //LoadSettings
- 
-/// The distance that an object moves depends on its speed, 
-/// and the amount of time since it last moved.
 
-void CGameObject::move() { //move object 
-	const float SCALE = 32.0f; //to scale back motion
-	const float TOPMARGIN = -200.0f; //margin on top of page
-	const float SIDEMARGIN = 140.0f;
-	const float BOTTOMMARGIN = 40.0f;
-	const float GRAVITY = 9.8f; //gravity
+  schedule(FRAME_EVENT, GetFrameInterval());
+  return FALSE;
+} //AdvanceFrame
 
-	const int time = g_cTimer.time(); //current time
-	const int tdelta = time - m_nLastMoveTime; //time since last move
-	const float tfactor = tdelta / SCALE; //scaled time factor
+/// Hurt enemies tumble backwards off the screen in small steps.
 
-	m_vPos.x += m_vVelocity.x*tfactor; //motion
-	m_vPos.y += m_vVelocity.y*tfactor; //motion
+void CGameObject::fly(){
+  if(m_nObjectType == ENEMYZOOMERHURT_OBJECT)
+    position().x += 16.0f;
+  position().x += 4.0f;
+  orientation() -= 20.0f * 3.14f / 180;
+  schedule(FLY_EVENT, FLY_INTERVAL);
+} //fly
 
+/// React to where the object has got to. The object manager has already
+/// moved it along its velocity, by an amount that depends on its speed and
+/// the time since it last moved, in one pass over the entity store. There is
+/// a version of this for each move kind, and the tests of the kind bits are
+/// constants that the compiler takes out, leaving only the code for that kind.
+/// \tparam kind Move kind of the object, from g_nMoveKind.
+
+template<unsigned kind> void CGameObject::MoveAs(){
 	//Handles wall collisions for each of these. Usually just removes them. Decreases enemy screen count if its an enemy
-	if(m_nObjectType == FREDIDLE_OBJECT || m_nObjectType == FREDATTACK_OBJECT || m_nObjectType == FREDHURT_OBJECT
-		|| m_nObjectType == SWAZIDLE_OBJECT || m_nObjectType == SWAZATTACK_OBJECT || m_nObjectType == SWAZHURT_OBJECT 
-		|| m_nObjectType == POLKIDLE_OBJECT || m_nObjectType == POLKATTACK_OBJECT || m_nObjectType == POLKHURT_OBJECT
-		|| m_nObjectType == PROJECTILEF_OBJECT || m_nObjectType == PROJECTILES_OBJECT || m_nObjectType == PROJECTILEP_OBJECT 
-		|| m_nObjectType == PROJECTILEENEMY1_OBJECT || m_nObjectType == PROJECTILEINVADER_OBJECT || m_nObjectType == ENEMYZOOMERIDLE_OBJECT || m_nObjectType == ENEMYZOOMERIDLEFLIP_OBJECT
-		|| m_nObjectType == ENEMYTHIEFIDLE_OBJECT){
-		if(m_vPos.x <= g_fScreenScroll - (g_nScreenWidth/2.0f) + SIDEMARGIN){ //left collision
-			m_vPos.x = g_fScreenScroll - (g_nScreenWidth / 2.0f) + SIDEMARGIN;
+	if(kind & WALLED_MOVE){
+		const ARENABOUNDS& arena = m_pWorld->m_cObjectManager.GetArenaBounds();
+		const unsigned hit = m_pChunk->m_nHit[m_nRow]; //edges that the integrator found it past
+
+		if(hit & LEFT_HIT){ //left collision
+			position().x = arena.m_fLeft;
 			if(m_nObjectType == ENEMYZOOMERIDLE_OBJECT){
-				kill();
-				g_cObjectManager.createObject(ENEMYZOOMERBOUNCE_OBJECT, "enemyZoomerBounce", Vector3(m_vPos.x + 10.0f, m_vPos.y, m_vPos.z), Vector3(0.0f, 0, 0), m_nHealth);
+				m_pWorld->m_cObjectManager.ChangeIncarnation(this, ENEMYZOOMERBOUNCE_OBJECT, "enemyZoomerBounce", Vector3(position().x + 10.0f, position().y, position().z), Vector3(0.0f, 0, 0), health());
 			}
-			if(m_nObjectType == PROJECTILEF_OBJECT || m_nObjectType == PROJECTILEENEMY1_OBJECT || m_nObjectType == PROJECTILEINVADER_OBJECT || m_nObjectType == PROJECTILETHIEF_OBJECT)
+			if(m_nObjectType == PROJECTILEF_OBJECT || HasTrait(m_nObjectType, ENEMYSHOT_TRAIT))
 				kill();
 		}
-		else if(m_vPos.x > g_fScreenScroll + (g_nScreenWidth/2.0f) - SIDEMARGIN){ //right collision
-			m_vPos.x = g_fScreenScroll + g_nScreenWidth/2.0f - SIDEMARGIN;
+		else if(hit & RIGHT_HIT){ //right collision
+			position().x = arena.m_fRight;
 			if(m_nObjectType == ENEMYZOOMERIDLEFLIP_OBJECT){
-				kill();
-				g_cObjectManager.createObject(ENEMYZOOMERBOUNCEFLIP_OBJECT, "enemyZoomerBounceFlip", Vector3(m_vPos.x - 10.0f, m_vPos.y, m_vPos.z), Vector3(0.0f, 0, 0), m_nHealth);
+				m_pWorld->m_cObjectManager.ChangeIncarnation(this, ENEMYZOOMERBOUNCEFLIP_OBJECT, "enemyZoomerBounceFlip", Vector3(position().x - 10.0f, position().y, position().z), Vector3(0.0f, 0, 0), health());
 			}
-			if(m_nObjectType == PROJECTILEF_OBJECT || m_nObjectType == PROJECTILES_OBJECT || m_nObjectType == PROJECTILEP_OBJECT 
-				|| m_nObjectType == PROJECTILED_OBJECT ||  m_nObjectType == PROJECTILEZ_OBJECT || m_nObjectType == PROJECTILEK_OBJECT
-				|| m_nObjectType == PROJECTILEENEMY1_OBJECT || m_nObjectType == PROJECTILEINVADER_OBJECT || m_nObjectType == PROJECTILEINVADER_OBJECT || m_nObjectType == PROJECTILETHIEF_OBJECT)
+			if(HasTrait(m_nObjectType, PLAYERSHOT_TRAIT | PIERCESHOT_TRAIT | ENEMYSHOT_TRAIT))
 				kill();
 
-			if (m_nObjectType == ENEMYTHIEFIDLE_OBJECT) m_vVelocity.x = -m_vVelocity.x;
+			if (m_nObjectType == ENEMYTHIEFIDLE_OBJECT) velocity().x = -velocity().x;
 		}
-		else if(m_vPos.y <= BOTTOMMARGIN + 50.0f && m_nObjectType == ENEMYTHIEFIDLE_OBJECT){
-			m_vVelocity.y = -m_vVelocity.y;
+		else if(position().y <= arena.m_fBottom + 50.0f && m_nObjectType == ENEMYTHIEFIDLE_OBJECT){
+			velocity().y = -velocity().y;
 		}
-		else if(m_vPos.y <= BOTTOMMARGIN) { //bottom collision
-			m_vPos.y = BOTTOMMARGIN;
-			if(m_nObjectType == PROJECTILEINVADER_OBJECT || m_nObjectType == PROJECTILEENEMY1_OBJECT || m_nObjectType == PROJECTILEINVADER_OBJECT || m_nObjectType == PROJECTILETHIEF_OBJECT)
+		else if(hit & BOTTOM_HIT) { //bottom collision
+			position().y = arena.m_fBottom;
+			if(HasTrait(m_nObjectType, ENEMYSHOT_TRAIT))
 				kill();
 		}
-		else if(m_vPos.y >= g_nScreenHeight + TOPMARGIN){ //top collision
-			m_vPos.y = g_nScreenHeight + TOPMARGIN;
-			if(m_nObjectType == PROJECTILEINVADER_OBJECT || m_nObjectType == PROJECTILEENEMY1_OBJECT || m_nObjectType == PROJECTILEINVADER_OBJECT || m_nObjectType == PROJECTILETHIEF_OBJECT)
+		else if(hit & TOP_HIT){ //top collision
+			position().y = arena.m_fTop;
+			if(HasTrait(m_nObjectType, ENEMYSHOT_TRAIT))
 				kill();
 		}
-		if(m_vPos.y >= g_nScreenHeight + TOPMARGIN - 75.0f && m_nObjectType == ENEMYTHIEFIDLE_OBJECT){ //top collision for thief
-			m_vVelocity.y = -m_vVelocity.y;
+		if(position().y >= arena.m_fTop - 75.0f && m_nObjectType == ENEMYTHIEFIDLE_OBJECT){ //top collision for thief
+			velocity().y = -velocity().y;
 		}
-		if((m_vPos.x <= g_fScreenScroll - (g_nScreenWidth / 2.0f) + SIDEMARGIN) && (m_vPos.y <= BOTTOMMARGIN)){ //bottom left collision
-			m_vPos.x = g_fScreenScroll - (g_nScreenWidth / 2.0f) + SIDEMARGIN;
-			m_vPos.y = BOTTOMMARGIN;
+		if((position().x <= arena.m_fLeft) && (position().y <= arena.m_fBottom)){ //bottom left collision
+			position().x = arena.m_fLeft;
+			position().y = arena.m_fBottom;
 		}
 	}
 
-	if(m_nObjectType == ENEMY1IDLE_OBJECT || m_nObjectType == ENEMYINVADERIDLE_OBJECT || m_nObjectType == ENEMYTHIEFIDLE_OBJECT){
-		if (m_vPos.x <= g_fScreenScroll - (g_nScreenWidth / 2.0f) + 100) {
+	if(kind & CULLED_MOVE){
+		if (position().x <= m_pWorld->m_fScreenScroll - (g_nScreenWidth / 2.0f) + 100) {
 			kill();
-			m_nEnemyCount--;
+			m_pWorld->m_nEnemyCount--;
 		}
 	}
  
-	if(m_nObjectType == PROJECTILEENEMY1_OBJECT){
-		m_fOrientation = atan2f(m_vVelocity.y, m_vVelocity.x); //rotation around Z axis
-	}
-
-	if(g_cTimer.elapsed(m_nLastFlyTime, 17))
-	if(m_nObjectType == ENEMY1HURT_OBJECT || m_nObjectType == ENEMYINVADERHURT_OBJECT || m_nObjectType == ENEMYZOOMERHURT_OBJECT || m_nObjectType == ENEMYTHIEFHURT_OBJECT){
-		if(m_nObjectType == ENEMYZOOMERHURT_OBJECT)
-			m_vPos.x += 16.0f;
-		m_vPos.x += 4.0f;
-		m_fOrientation -= 20.0f * 3.14f / 180;
+	if(kind & AIMED_MOVE){
+		orientation() = atan2f(velocity().y, velocity().x); //rotation around Z axis
 	}
 
-	if(m_nObjectType == SHIELD_OBJECT){
-		CGameObject* player = g_cObjectManager.GetPlayerObjectPtr();
-		m_vPos = player->m_vPos;
-		if(!g_bShieldActive)
+	if(kind & SHIELD_MOVE){
+		CGameObject* player = m_pWorld->m_cObjectManager.GetPlayerObjectPtr();
+		position().x = player->position().x; //Z stays put, so the shield keeps its draw layer
+		position().y = player->position().y;
+		if(!m_pWorld->m_bShieldActive)
 			kill();
 	}
 
-	if(m_nObjectType == ASSISTFRED_OBJECT || m_nObjectType == ASSISTSWAZ_OBJECT || m_nObjectType == ASSISTPOLK_OBJECT){
-		CGameObject* player = g_cObjectManager.GetPlayerObjectPtr();
-		m_vPos.x = player->m_vPos.x + 17;
-		m_vPos.y = player->m_vPos.y - 35;
-		if(!g_bAssistActive)
+	if(kind & ASSIST_MOVE){
+		CGameObject* player = m_pWorld->m_cObjectManager.GetPlayerObjectPtr();
+		position().x = player->position().x + 17;
+		position().y = player->position().y - 35;
+		if(!m_pWorld->m_bAssistActive)
 			kill();
 	}
 
-	if(m_nObjectType == PROJECTILEF_OBJECT || m_nObjectType == PROJECTILES_OBJECT || m_nObjectType == PROJECTILEP_OBJECT){
-		m_fOrientation -= 0.20f * 3.14f / 180;
+	if(kind & FACE_MOVE){
+		CGameObject* player = m_pWorld->m_cObjectManager.GetPlayerObjectPtr();
+		Vector2 v = player->position() - position();
+		orientation() = atan2(v.y, v.x);
 	}
+} //MoveAs
 
-	if(m_nObjectType == ENEMYINVADERIDLE_OBJECT || m_nObjectType == ENEMYINVADERATTACK_OBJECT || m_nObjectType == ENEMYINVADERHURT_OBJECT){
-		CGameObject* player = g_cObjectManager.GetPlayerObjectPtr();
-		Vector2 v = player->m_vPos - m_vPos;
-		m_fOrientation = atan2(v.y, v.x);
-	}
+/// Move every object in a move bucket, in order.
+/// \tparam kind Move kind of the objects in the bucket.
+/// \param bucket Objects of that move kind.
+
+template<unsigned kind> void CGameObject::MoveBucket(vector<CGameObject*>& bucket){
+  for(CGameObject* p: bucket)
+    p->MoveAs<kind>();
+} //MoveBucket
+
+/// Move functions for the move buckets, indexed the same as g_nMoveKind.
+
+void (*const CGameObject::m_pMoveBucket[NUM_MOVE_BUCKETS])(vector<CGameObject*>&) = {
+  &MoveBucket<g_nMoveKind[0]>, &MoveBucket<g_nMoveKind[1]>, &MoveBucket<g_nMoveKind[2]>,
+  &MoveBucket<g_nMoveKind[3]>, &MoveBucket<g_nMoveKind[4]>, &MoveBucket<g_nMoveKind[5]>,
+  &MoveBucket<g_nMoveKind[6]>, &MoveBucket<g_nMoveKind[7]>,
+}; //m_pMoveBucket
 
-	m_nLastMoveTime = time;  //record time of move
-} //move
+static_assert(NUM_MOVE_BUCKETS == 8, "m_pMoveBucket needs an entry for each move kind");
 
 /// Kill an object by flagging it as dead, and stopping any associated sound.
 
 void CGameObject::kill(){
-  m_bIsDead = TRUE;
+  SetFlag(DEAD_FLAG, TRUE);
 } //kill
 
 float CGameObject::GetScreenFrameLeft(){
-	return g_fScreenScroll - (g_nScreenWidth / 2.0f) + 140.0f;
+	return m_pWorld->m_fScreenScroll - (g_nScreenWidth / 2.0f) + 140.0f;
 } //GetScreenFrameLeft
 
 float CGameObject::GetScreenFrameRight(){
-	return g_fScreenScroll + (g_nScreenWidth / 2.0f) - 140.0f;
+	return m_pWorld->m_fScreenScroll + (g_nScreenWidth / 2.0f) - 140.0f;
 } //GetScreenFrameRight
 
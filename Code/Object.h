@@ -3,65 +3,119 @@
 
 #pragma once
 
-#include "sprite.h"
-#include "defines.h"
+#include "Sprite.h"
+#include "Defines.h"
 #include "ObjMan.h"
+#include "ObjectPool.h"
+#include "ObjectRegistry.h"
+#include "ObjectTraits.h"
+#include "ObjectSettings.h"
+#include "TimerWheel.h"
+#include "EntityStore.h"
+
+class CSnapshot;
+class CWorld;
+class CObjectManager;
+
+/// \brief Object flags.
+///
+/// Each flag is one bit of CGameObject::m_nFlags.
+
+const unsigned DEAD_FLAG        = 1 << 0; ///< The object is dead.
+const unsigned INTELLIGENT_FLAG = 1 << 1; ///< An intelligent object.
+const unsigned VULNERABLE_FLAG  = 1 << 2; ///< Vulnerable to bullets.
+const unsigned CYCLESPRITE_FLAG = 1 << 3; ///< Cycle sprite frames, otherwise play once.
+const unsigned CANFIRE_FLAG     = 1 << 4; ///< Can fire, cleared at the end of the level.
+
+/// \brief The cold part of a game object.
+///
+/// What a game object only needs now and then, when a timer event fires,
+/// when it is drawn or when it changes incarnation, kept apart from the
+/// object so that the objects themselves pack densely.
+
+struct OBJECTCOLD{
+  float m_nAttackOrientation; ///< Direction of the next shot.
+  int m_nDelayTime; ///< Delay, unused.
+  int m_nWidth; ///< Width of object.
+  int m_nHeight; ///< Height of object.
+  int m_nSoundInstance; ///< Sound instance played most recently.
+  ObjectHandle m_hHandle; ///< Handle in the object registry, NULL_HANDLE if not registered.
+  int m_nDepthKey; ///< Quantized Z of the draw layer that this object is in.
+  TIMERNODE m_sTimer[NUM_TIMER_EVENTS]; ///< Timer events, one of each type, in the object manager's timer wheel when pending.
+}; //OBJECTCOLD
 
 /// \brief The game object. 
 ///
 /// Game objects are responsible for remembering information about 
 /// themselves - including their image, location, and speed - and
-/// for moving and drawing themselves.
+/// for moving and drawing themselves. The components that every pass
+/// touches live in the object manager's entity store rather than in the
+/// object, and the object gets at them through its row there. What is left
+/// in the object is what the per-tick passes look at, with the flags packed
+/// into one word, so that an object fits in a cache line with its pool
+/// header. Everything else is in an OBJECTCOLD out of line.
 
 class CGameObject{ //class for a game object
   friend class CIntelligentObject;
   friend class CObjectManager;
   friend class CGameRenderer;
   friend class CSoundManager;
-  friend BOOL KeyboardHandler(WPARAM keystroke); //for keyboard control of objects
-	friend BOOL KeyboardHandlerReleased(WPARAM keystroke);
-	friend bool ZCompare(const CGameObject* p0, const CGameObject* p1); //for depth sorting
+  friend class CDepthLayers; //for depth sorting
+  friend class CEntityStore; //for the row
 
   protected:
+    //hot, looked at every tick
+    CWorld* m_pWorld; ///< World that this object is in.
+    ENTITYCHUNK* m_pChunk; ///< Chunk of the entity store that holds this object's components.
+    OBJECTCOLD* m_pCold; ///< Rarely used data, out of line.
+    int m_nRow; ///< Row of the chunk.
     ObjectType m_nObjectType; ///< Object type.
+    unsigned m_nFlags; ///< *_FLAG bits.
+
+    BOOL GetFlag(unsigned f){return (m_nFlags & f) != 0;} ///< Test a flag.
+    void SetFlag(unsigned f, BOOL on){if(on)m_nFlags |= f; else m_nFlags &= ~f;} ///< Set or clear a flag.
+
+    //components, kept in the object manager's entity store
+    BOOL HasComponent(unsigned c){return (m_pChunk->m_pArchetype->GetMask() & c) != 0;} ///< Test for a component.
+    Vector3& position(){return m_pChunk->m_pTransform[m_nRow].m_vPos;} ///< Current location.
+    float& orientation(){return m_pChunk->m_pTransform[m_nRow].m_fOrientation;} ///< Angle to rotate about the Z axis.
+    Vector3& velocity(){return m_pChunk->m_pVelocity[m_nRow].m_vVelocity;} ///< Current velocity.
+    float& spin(){return m_pChunk->m_pVelocity[m_nRow].m_fSpin;} ///< Change in orientation each frame.
+    float& lastX(){return m_pChunk->m_fLastX[m_nRow];} ///< X coordinate before the last move.
+    float& lastY(){return m_pChunk->m_fLastY[m_nRow];} ///< Y coordinate before the last move.
+    unsigned& listOrder(){return m_pChunk->m_nOrder[m_nRow];} ///< Place in the object list, 0 if not in it yet.
+    long long& lastMoveTime(){return m_pChunk->m_pVelocity[m_nRow].m_nLastMoveTime;} ///< Last time moved, in microseconds.
+    int& lifeTime(){return m_pChunk->m_pLifetime[m_nRow].m_nLifeTime;} ///< Time that object lives.
+    int& invulnerableTime(){return m_pChunk->m_pLifetime[m_nRow].m_nInvulnerableTime;} ///< How long the object is invulnerable.
+    C3DSprite*& sprite(){return m_pChunk->m_pAnimation[m_nRow].m_pSprite;} ///< Pointer to sprite.
+    ANIMATIONSPAN& animation(){return m_pChunk->m_pAnimation[m_nRow].m_sAnimation;} ///< Sequence of frame numbers, in g_cAnimationStore.
+    int& currentFrame(){return m_pChunk->m_pAnimation[m_nRow].m_nCurrentFrame;} ///< Frame to be displayed.
+    int& frameCount(){return m_pChunk->m_pAnimation[m_nRow].m_nFrameCount;} ///< Number of frames in animation.
+    int& frameInterval(){return m_pChunk->m_pAnimation[m_nRow].m_nFrameInterval;} ///< Interval between frames.
+    int& health(){return m_pChunk->m_pCollider[m_nRow].m_nHealth;} ///< Hits left.
 
-	BOOL m_bCanFire = TRUE;
-    Vector3 m_vPos; ///< Current location.
-    Vector3 m_vVelocity; ///< Current velocity.
-    int m_nLastMoveTime; ///< Last time moved.
-		float m_nAttackOrientation;
-		int m_nDelayTime;
-    float m_fOrientation; ///< Orientation, angle to rotate about the Z axis.
-		int m_nHealth;
-
-    C3DSprite* m_pSprite; ///< Pointer to sprite.
-    int m_nCurrentFrame; ///< Frame to be displayed.
-    int m_nFrameCount; ///< Number of frames in animation.
-    int m_nLastFrameTime; ///< Last time the frame was changed.
-    int m_nFrameInterval; ///< Interval between frames.
-		int m_nLastFlyTime;
-		int* m_pAnimation; ///< Sequence of frame numbers to be repeated
-    int m_nAnimationFrameCount; ///< Number of entries in m_pAnimation
-    
-    int m_nWidth; ///< Width of object.
-    int m_nHeight; ///< Height of object.
-    int m_nBirthTime; ///< Time of creation.
-    int m_nLifeTime; ///< Time that object lives.
-		int m_nInvulnerableTime; ///< How long the object is invulnerable.
-    BOOL m_bVulnerable; ///< Vulnerable to bullets.
-    BOOL m_bIntelligent; ///< TRUE for an intelligent object.
-    BOOL m_bCycleSprite; ///< TRUE to cycle sprite frames, otherwise play once.
-    BOOL m_bIsDead; ///< TRUE if the object is dead.
-    int m_nSoundInstance; ///< Sound instance played most recently.
-
-    void LoadSettings(const char* name); //< Load object-dependent settings from XML element.
+    void Incarnate(ObjectType object, const char* name, const Vector3& s, const Vector3& v); ///< Become a new object of a type.
+    void schedule(TimerEventType e, int delay); ///< Ask for a timer event.
+    int GetFrameInterval(); ///< Time until the next animation frame.
+    BOOL AdvanceFrame(); ///< Go to the next animation frame.
+    void fly(); ///< Tumble away after being hurt.
+
+    template<unsigned kind> void MoveAs(); ///< React to where an object of a move kind has got to.
+    template<unsigned kind> static void MoveBucket(vector<CGameObject*>& bucket); ///< Move a bucket of objects of a move kind.
+    static void (*const m_pMoveBucket[NUM_MOVE_BUCKETS])(vector<CGameObject*>& bucket); ///< MoveBucket for each move kind.
 
   public:
-		CGameObject(ObjectType object, const char * name, const Vector3 & s, const Vector3 & v);
-		CGameObject(ObjectType object, const char * name, const Vector3 & s, const Vector3 & v, int health); ///< Constructor.
-    ~CGameObject(); //< Destructor.
+		CGameObject(CWorld* world, ObjectType object, const char * name, const Vector3 & s, const Vector3 & v);
+		CGameObject(CWorld* world, ObjectType object, const char * name, const Vector3 & s, const Vector3 & v, int health); ///< Constructor.
+    CGameObject(CWorld* world, ObjectType object, CSnapshot& s); ///< Constructor from a snapshot.
+    virtual ~CGameObject(); //< Destructor.
+
+    static void* operator new(size_t size, CObjectManager* manager); ///< Allocate from an object manager's pool.
+    static void operator delete(void* p, CObjectManager* manager); ///< Return to the pool if the constructor throws.
+    static void operator delete(void* p, size_t size); ///< Return to the pool it came from.
+    static void ReservePool(CObjectManager* manager, size_t size, int n); ///< Prewarm an object manager's pool for objects of this size.
     void draw(); ///< Draw at current location.
-    virtual void move(); ///< Change location depending on time and speed
+    virtual void save(CSnapshot& s); ///< Save to a snapshot.
     void kill(); ///< Kill object.
 		float GetScreenFrameLeft();
 		float GetScreenFrameRight();
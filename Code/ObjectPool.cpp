@@ -0,0 +1,100 @@
+/// \file ObjectPool.cpp
+/// \brief Code for the fixed size block allocator CObjectPool.
+
+#include "ObjectPool.h"
+
+const size_t POOL_ALIGNMENT = 16; ///< Blocks are a multiple of this many bytes.
+const int POOL_MIN_GROWTH = 32; ///< Least number of blocks added when the pool runs dry.
+const size_t POOL_CHUNK_ALIGNMENT = 64; ///< Chunks start on a cache line.
+
+/// Constructor. The block size is rounded up so that every block is aligned
+/// and big enough to hold the free list pointer.
+/// \param blocksize Size of each block in bytes.
+
+CObjectPool::CObjectPool(size_t blocksize){
+  if(blocksize < sizeof(void*))
+    blocksize = sizeof(void*);
+  m_nBlockSize = (blocksize + POOL_ALIGNMENT - 1)/POOL_ALIGNMENT*POOL_ALIGNMENT;
+  m_pFreeList = nullptr;
+  m_nBlockCount = m_nFreeCount = m_nGrowCount = 0;
+} //constructor
+
+/// Destructor. Gives all chunks back to the heap, so any blocks still in use
+/// become invalid.
+
+CObjectPool::~CObjectPool(){
+  for(size_t i=0; i<m_pChunks.size(); i++)
+    delete [] m_pChunks[i];
+} //destructor
+
+/// Allocate a chunk of blocks from the heap and thread them onto the free list.
+/// The chunk starts on a cache line, so a block whose size is a multiple of
+/// the cache line never straddles two.
+/// \param n Number of blocks in the new chunk.
+
+void CObjectPool::grow(int n){
+  char* raw = new char[n*m_nBlockSize + POOL_CHUNK_ALIGNMENT - 1];
+  m_pChunks.push_back(raw); //what delete needs, not the aligned start
+  char* chunk = (char*)(((size_t)raw + POOL_CHUNK_ALIGNMENT - 1) & ~(POOL_CHUNK_ALIGNMENT - 1));
+
+  for(int i=n-1; i>=0; i--){ //backwards so that blocks come out in address order
+    void* block = chunk + i*m_nBlockSize;
+    *(void**)block = m_pFreeList;
+    m_pFreeList = block;
+  } //for
+
+  m_nBlockCount += n;
+  m_nFreeCount += n;
+  m_nGrowCount++;
+} //grow
+
+/// Get a block from the free list, growing the pool if it is empty.
+/// \return Pointer to an uninitialized block.
+
+void* CObjectPool::allocate(){
+  if(m_pFreeList == nullptr){ //ran dry, double the pool
+    int n = m_nBlockCount;
+    if(n < POOL_MIN_GROWTH)n = POOL_MIN_GROWTH;
+    grow(n);
+  } //if
+
+  void* block = m_pFreeList;
+  m_pFreeList = *(void**)block;
+  m_nFreeCount--;
+  return block;
+} //allocate
+
+/// Put a block back on the free list.
+/// \param p Pointer to a block that came from allocate.
+
+void CObjectPool::release(void* p){
+  if(p == nullptr)return;
+  *(void**)p = m_pFreeList;
+  m_pFreeList = p;
+  m_nFreeCount++;
+} //release
+
+/// Grow the pool, if necessary, so that n blocks can be allocated without
+/// going to the heap.
+/// \param n Number of free blocks wanted.
+
+void CObjectPool::reserve(int n){
+  if(m_nFreeCount < n)
+    grow(n - m_nFreeCount);
+} //reserve
+
+size_t CObjectPool::GetBlockSize(){
+  return m_nBlockSize;
+} //GetBlockSize
+
+int CObjectPool::GetBlockCount(){
+  return m_nBlockCount;
+} //GetBlockCount
+
+int CObjectPool::GetFreeCount(){
+  return m_nFreeCount;
+} //GetFreeCount
+
+int CObjectPool::GetGrowCount(){
+  return m_nGrowCount;
+} //GetGrowCount
@@ -0,0 +1,41 @@
+/// \file ObjectPool.h
+/// \brief Interface for the fixed size block allocator CObjectPool.
+
+#pragma once
+
+#include <vector>
+
+using namespace std;
+
+/// \brief The object pool.
+///
+/// A free list of fixed size memory blocks. Blocks are carved out of large
+/// chunks, and a block that is released goes back on the free list to be
+/// handed out again by the next allocate, so once the pool has grown to the
+/// number of objects alive at once it no longer touches the heap.
+
+class CObjectPool{
+  private:
+    size_t m_nBlockSize; ///< Size of each block in bytes.
+    void* m_pFreeList; ///< First free block, each free block points to the next.
+    vector<char*> m_pChunks; ///< Chunks of memory that the blocks are carved from.
+
+    int m_nBlockCount; ///< Number of blocks in all chunks.
+    int m_nFreeCount; ///< Number of blocks on the free list.
+    int m_nGrowCount; ///< Number of times a chunk was allocated from the heap.
+
+    void grow(int n); ///< Add a chunk of n blocks to the free list.
+
+  public:
+    CObjectPool(size_t blocksize); ///< Constructor.
+    ~CObjectPool(); ///< Destructor.
+
+    void* allocate(); ///< Get a block.
+    void release(void* p); ///< Return a block.
+    void reserve(int n); ///< Make sure that there are at least n free blocks.
+
+    size_t GetBlockSize(); ///< Get the block size.
+    int GetBlockCount(); ///< Get the number of blocks owned.
+    int GetFreeCount(); ///< Get the number of free blocks.
+    int GetGrowCount(); ///< Get the number of heap allocations so far.
+}; //CObjectPool
@@ -0,0 +1,151 @@
+/// \file ObjectRegistry.cpp
+/// \brief Code for the named object registry class CObjectRegistry.
+
+#include <string.h>
+
+#include "ObjectRegistry.h"
+#include "Snapshot.h"
+
+CObjectRegistry::CObjectRegistry(){
+  for(int i=0; i<MAX_NAMED_OBJECTS; i++){
+    m_pObject[i] = nullptr;
+    m_nGeneration[i] = 1; //generation 0 is reserved for NULL_HANDLE
+  } //for
+
+  for(int i=0; i<NUM_OBJECT_TYPES; i++)
+    m_nTypeToSlot[i] = -1;
+
+  m_nSlotCount = 0;
+} //constructor
+
+/// Make the handle that refers to whatever is in a slot right now.
+/// \param slot Slot index.
+/// \return Handle.
+
+ObjectHandle CObjectRegistry::MakeHandle(int slot){
+  return (m_nGeneration[slot] << 16) | (unsigned)slot;
+} //MakeHandle
+
+/// Create a slot for a name, or find the existing one. This is the only
+/// place that the name string is copied.
+/// \param name Object name.
+/// \param t Type of the objects created with this name.
+/// \return Slot index, -1 if the registry is full.
+
+int CObjectRegistry::InternName(const char* name, ObjectType t){
+  int slot = FindSlot(name);
+
+  if(slot < 0){ //new name
+    if(m_nSlotCount >= MAX_NAMED_OBJECTS)return -1;
+    slot = m_nSlotCount++;
+    m_strName[slot] = name;
+  } //if
+
+  m_nTypeToSlot[t] = slot;
+  return slot;
+} //InternName
+
+/// Get the slot that objects of a given type are registered in.
+/// \param t Object type.
+/// \return Slot index, -1 if objects of that type are not registered.
+
+int CObjectRegistry::GetSlot(ObjectType t){
+  return m_nTypeToSlot[t];
+} //GetSlot
+
+/// Get the slot for a name. There are only a handful of names, so this is a
+/// linear search that compares against the interned strings in place.
+/// \param name Object name.
+/// \return Slot index, -1 if the name was never interned.
+
+int CObjectRegistry::FindSlot(const char* name){
+  for(int i=0; i<m_nSlotCount; i++)
+    if(strcmp(m_strName[i].c_str(), name) == 0)
+      return i;
+  return -1;
+} //FindSlot
+
+/// Put an object into a slot, replacing whatever was there. Handles to the
+/// old occupant go stale.
+/// \param slot Slot index.
+/// \param p Pointer to object.
+/// \return Handle to the object.
+
+ObjectHandle CObjectRegistry::insert(int slot, CGameObject* p){
+  if(slot < 0 || slot >= m_nSlotCount)return NULL_HANDLE;
+  m_pObject[slot] = p;
+  if(++m_nGeneration[slot] > 0xFFFF)m_nGeneration[slot] = 1;
+  return MakeHandle(slot);
+} //insert
+
+/// Empty the slot that a handle refers to. Does nothing if the handle is
+/// stale, so that an old object can't remove its replacement.
+/// \param h Handle.
+
+void CObjectRegistry::erase(ObjectHandle h){
+  if(resolve(h) == nullptr)return;
+  const int slot = h & 0xFFFF;
+  m_pObject[slot] = nullptr;
+  if(++m_nGeneration[slot] > 0xFFFF)m_nGeneration[slot] = 1;
+} //erase
+
+/// Empty all slots. The names stay interned.
+
+void CObjectRegistry::clear(){
+  for(int i=0; i<m_nSlotCount; i++)
+    if(m_pObject[i] != nullptr)
+      erase(MakeHandle(i));
+} //clear
+
+/// Get a handle to the object in a slot.
+/// \param slot Slot index.
+/// \return Handle, NULL_HANDLE if the slot is empty.
+
+ObjectHandle CObjectRegistry::GetHandle(int slot){
+  if(slot < 0 || slot >= m_nSlotCount || m_pObject[slot] == nullptr)
+    return NULL_HANDLE;
+  return MakeHandle(slot);
+} //GetHandle
+
+/// Get the object that a handle refers to.
+/// \param h Handle.
+/// \return Pointer to object, nullptr if the handle is null or stale.
+
+CGameObject* CObjectRegistry::resolve(ObjectHandle h){
+  const int slot = h & 0xFFFF;
+  if(h == NULL_HANDLE || slot >= m_nSlotCount || (h >> 16) != m_nGeneration[slot])
+    return nullptr;
+  return m_pObject[slot];
+} //resolve
+
+/// Save the generation of each slot to a snapshot. The objects in the slots
+/// are saved by the object manager, along with their handles.
+/// \param s Snapshot.
+
+void CObjectRegistry::save(CSnapshot& s){
+  s.write(m_nGeneration);
+} //save
+
+/// Restore the generation of each slot from a snapshot and empty every slot,
+/// ready for the restored objects to be put back with place.
+/// \param s Snapshot.
+
+void CObjectRegistry::restore(CSnapshot& s){
+  s.read(m_nGeneration);
+  for(int i=0; i<MAX_NAMED_OBJECTS; i++)
+    m_pObject[i] = nullptr;
+} //restore
+
+/// Put a restored object back into the slot that its handle refers to, if
+/// the handle was current when the snapshot was taken. Stale handles are
+/// ignored, since the object had already been replaced. The generation is
+/// not changed, so handles saved with the snapshot stay good.
+/// \param h Handle that the object had.
+/// \param p Pointer to the restored object.
+
+void CObjectRegistry::place(ObjectHandle h, CGameObject* p){
+  const int slot = h & 0xFFFF;
+  if(h == NULL_HANDLE || slot >= m_nSlotCount || (h >> 16) != m_nGeneration[slot])
+    return;
+  m_pObject[slot] = p;
+} //place
@@ -0,0 +1,59 @@
+/// \file ObjectRegistry.h
+/// \brief Interface for the named object registry class CObjectRegistry.
+
+#pragma once
+
+#include <string>
+
+#include "Defines.h"
+
+class CGameObject;
+class CSnapshot;
+
+/// \brief Handle to a registered object.
+///
+/// The low 16 bits are the registry slot and the high 16 bits are the
+/// generation of that slot when the object was registered. A handle
+/// goes stale as soon as its slot is given to another object or emptied.
+
+typedef unsigned int ObjectHandle;
+
+const ObjectHandle NULL_HANDLE = 0; ///< Handle that never refers to anything.
+const int MAX_NAMED_OBJECTS = 32; ///< Most names that can be registered.
+
+/// \brief The object registry.
+///
+/// Names of objects that need to be found later, such as the player, shield
+/// and assist, are interned once into slots. Each slot holds at most one
+/// object at a time. The slot for an object type can be found with an array
+/// lookup, so registering an object on creation costs no hashing and no string
+/// allocation, and objects whose type has no slot are not registered at all.
+
+class CObjectRegistry{
+  private:
+    string m_strName[MAX_NAMED_OBJECTS]; ///< Name of each slot.
+    CGameObject* m_pObject[MAX_NAMED_OBJECTS]; ///< Object in each slot, or nullptr.
+    unsigned m_nGeneration[MAX_NAMED_OBJECTS]; ///< Generation of each slot.
+    int m_nTypeToSlot[NUM_OBJECT_TYPES]; ///< Slot for each object type, -1 if none.
+    int m_nSlotCount; ///< Number of slots in use.
+
+    ObjectHandle MakeHandle(int slot); ///< Current handle for a slot.
+
+  public:
+    CObjectRegistry(); ///< Constructor.
+
+    int InternName(const char* name, ObjectType t); ///< Create a slot for a name.
+    int GetSlot(ObjectType t); ///< Get the slot for an object type.
+    int FindSlot(const char* name); ///< Get the slot for a name.
+
+    ObjectHandle insert(int slot, CGameObject* p); ///< Put an object into a slot.
+    void erase(ObjectHandle h); ///< Empty the slot of a handle, if it is current.
+    void clear(); ///< Empty all slots.
+
+    void save(CSnapshot& s); ///< Save the slot generations to a snapshot.
+    void restore(CSnapshot& s); ///< Restore the slot generations, with all slots empty.
+    void place(ObjectHandle h, CGameObject* p); ///< Put a restored object back under its handle.
+
+    ObjectHandle GetHandle(int slot); ///< Get a handle to the object in a slot.
+    CGameObject* resolve(ObjectHandle h); ///< Get the object a handle refers to.
+}; //CObjectRegistry
@@ -0,0 +1,105 @@
+/// \file ObjectSettings.cpp
+/// \brief Code for the object settings table class CObjectSettings.
+
+#include <string.h>
+#include <algorithm>
+
+#include "ObjectSettings.h"
+
+extern CAnimationStore g_cAnimationStore;
+
+CObjectSettings::CObjectSettings(){
+  m_sDefault.m_nFrameInterval = 30;
+  m_sDefault.m_nLifeTime = -1; //negative means immortal
+  m_sDefault.m_nInvulnerableTime = 0;
+  m_sDefault.m_bVulnerable = FALSE;
+  m_sDefault.m_bCycleSprite = TRUE;
+  m_sDefault.m_sAnimation.m_nStart = 0;
+  m_sDefault.m_sAnimation.m_nCount = 0;
+
+  for(int i=0; i<NUM_OBJECT_TYPES; i++)
+    m_nTypeToIndex[i] = -1;
+} //constructor
+
+/// Compile every "object" tag inside the "objects" tag. After this the XML
+/// is not needed any more.
+/// \param settings Pointer to the "settings" tag.
+
+void CObjectSettings::load(XMLElement* settings){
+  if(settings == nullptr)return;
+  XMLElement* objSettings = settings->FirstChildElement("objects"); //objects tag
+  if(objSettings == nullptr)return;
+
+  vector<int> frames; //frame numbers of one animation sequence
+
+  for(XMLElement* obj = objSettings->FirstChildElement("object"); obj; obj = obj->NextSiblingElement("object")){
+    OBJECTSETTINGS s;
+    s.m_nFrameInterval = obj->IntAttribute("frameinterval");
+    s.m_bVulnerable = obj->BoolAttribute("vulnerable");
+    s.m_bCycleSprite = obj->BoolAttribute("cycle");
+    s.m_nLifeTime = obj->IntAttribute("lifetime");
+    s.m_nInvulnerableTime = obj->IntAttribute("invulnerabletime");
+    frames.clear();
+
+    //parse animation sequence, comma separated frame numbers
+    const char* seq = obj->Attribute("animation");
+    if(seq){ //sequence present
+      const size_t length = strlen(seq);
+      size_t i = 0; //character index
+      while(i < length){
+        int num = 0; //frame number
+        while(i < length && seq[i] >= '0' && seq[i] <= '9')
+          num = num * 10 + seq[i++] - '0';
+        i++; //skip over comma
+        frames.push_back(num); //record frame number
+      } //while
+    } //if
+    s.m_sAnimation = g_cAnimationStore.intern(frames);
+
+    const char* name = obj->Attribute("name");
+    m_strName.push_back(name? name: "");
+    m_sSettings.push_back(s);
+  } //for
+
+  //sort by name, stable so that the first of any duplicate names comes first
+  m_nSorted.resize(m_sSettings.size());
+  for(size_t i=0; i<m_nSorted.size(); i++)
+    m_nSorted[i] = (int)i;
+  stable_sort(m_nSorted.begin(), m_nSorted.end(), [this](int a, int b){
+    return strcmp(m_strName[a].c_str(), m_strName[b].c_str()) < 0;
+  });
+
+  for(int i=0; i<NUM_OBJECT_TYPES; i++)
+    m_nTypeToIndex[i] = -1;
+} //load
+
+/// Find the entry for an object name with a binary search.
+/// \param name Object name.
+/// \return Index into m_sSettings, -1 if there is no object tag with that name.
+
+int CObjectSettings::FindIndex(const char* name){
+  auto i = lower_bound(m_nSorted.begin(), m_nSorted.end(), name, [this](int a, const char* n){
+    return strcmp(m_strName[a].c_str(), n) < 0;
+  });
+  if(i == m_nSorted.end() || strcmp(m_strName[*i].c_str(), name) != 0)
+    return -1;
+  return *i;
+} //FindIndex
+
+/// Get the settings for a new object. The entry that this type used last is
+/// checked first, so usually this costs one string compare.
+/// \param t Object type.
+/// \param name Object name in XML settings file object tag.
+/// \return Settings, defaults if there is no object tag with that name.
+
+const OBJECTSETTINGS& CObjectSettings::GetSettings(ObjectType t, const char* name){
+  int index = m_nTypeToIndex[t];
+
+  if(index < 0 || strcmp(m_strName[index].c_str(), name) != 0){ //not the one used last
+    index = FindIndex(name);
+    if(index < 0)return m_sDefault;
+    m_nTypeToIndex[t] = index;
+  } //if
+
+  return m_sSettings[index];
+} //GetSettings
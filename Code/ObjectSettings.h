@@ -0,0 +1,50 @@
+/// \file ObjectSettings.h
+/// \brief Interface for the object settings table class CObjectSettings.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Defines.h"
+#include "AnimationStore.h"
+
+/// \brief Settings for one kind of object.
+///
+/// What the "object" tag with a given name in gamesettings.xml says about
+/// the objects created with that name.
+
+struct OBJECTSETTINGS{
+  int m_nFrameInterval; ///< Interval between frames.
+  int m_nLifeTime; ///< Time that object lives, negative means immortal.
+  int m_nInvulnerableTime; ///< How long the object is invulnerable.
+  BOOL m_bVulnerable; ///< Vulnerable to bullets.
+  BOOL m_bCycleSprite; ///< TRUE to cycle sprite frames, otherwise play once.
+  ANIMATIONSPAN m_sAnimation; ///< Sequence of frame numbers in g_cAnimationStore.
+}; //OBJECTSETTINGS
+
+/// \brief The object settings table.
+///
+/// Every "object" tag in the settings file is compiled into an entry once at
+/// startup, so that creating an object is a struct copy instead of a walk
+/// over the XML. Animation sequences are interned into g_cAnimationStore.
+/// The same object type can be created under different names, so entries are
+/// looked up by name. Each type remembers the entry it used last, which is
+/// almost always the right one.
+
+class CObjectSettings{
+  private:
+    vector<OBJECTSETTINGS> m_sSettings; ///< Settings of each object tag, in file order.
+    vector<string> m_strName; ///< Name of each object tag.
+    vector<int> m_nSorted; ///< Indices into m_sSettings sorted by name.
+    int m_nTypeToIndex[NUM_OBJECT_TYPES]; ///< Entry last used for each object type, -1 if none.
+    OBJECTSETTINGS m_sDefault; ///< Settings for names that have no object tag.
+
+    int FindIndex(const char* name); ///< Find the entry for a name.
+
+  public:
+    CObjectSettings(); ///< Constructor.
+
+    void load(XMLElement* settings); ///< Compile the object tags.
+    const OBJECTSETTINGS& GetSettings(ObjectType t, const char* name); ///< Get settings by type and name.
+}; //CObjectSettings
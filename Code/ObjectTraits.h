@@ -0,0 +1,225 @@
+/// \file ObjectTraits.h
+/// \brief Compile-time table of object type traits.
+
+#pragma once
+
+#include <utility>
+
+#include "Defines.h"
+#include "EntityStore.h"
+
+/// \brief Object type traits.
+///
+/// Each trait is one bit. An object type can have any number of them.
+
+const unsigned ACTIVEPLAYER_TRAIT  = 1 << 0; ///< Player that can be hit and pick up items.
+const unsigned HURTPLAYER_TRAIT    = 1 << 1; ///< Player recovering from a hit.
+const unsigned PLAYERSHOT_TRAIT    = 1 << 2; ///< Player's letter shot.
+const unsigned PIERCESHOT_TRAIT    = 1 << 3; ///< Player's piercing shot.
+const unsigned ENEMYSHOT_TRAIT     = 1 << 4; ///< Enemy projectile.
+const unsigned SPIKED_TRAIT        = 1 << 5; ///< Stops letter shots without being hurt.
+const unsigned HARMFUL_TRAIT       = 1 << 6; ///< Hurts the player on contact.
+const unsigned SHOOTABLE_TRAIT     = 1 << 7; ///< Hurt by letter shots.
+const unsigned PIERCEABLE_TRAIT    = 1 << 8; ///< Hurt by piercing shots.
+const unsigned HURTENEMY_TRAIT     = 1 << 9; ///< Enemy tumbling away after a hit.
+const unsigned INTELLIGENT_TRAIT   = 1 << 10; ///< Created as an intelligent object.
+const unsigned INVADER_TRAIT       = 1 << 11; ///< Invader, which always faces the player.
+const unsigned ASSIST_TRAIT        = 1 << 12; ///< Small copy of the player.
+const unsigned SHIELDITEM_TRAIT    = 1 << 13; ///< Item that gives shield ammo.
+const unsigned ASSISTITEM_TRAIT    = 1 << 14; ///< Item that gives assist ammo.
+const unsigned PIERCEITEM_TRAIT    = 1 << 15; ///< Item that gives piercing shot ammo.
+const unsigned WALLED_TRAIT        = 1 << 16; ///< Kept inside the edges of the screen.
+
+/// Compute the traits of an object type. This is only evaluated at compile
+/// time to fill in the trait table, so it doesn't matter how slow it is. A new
+/// object type only needs to be added to the traits that it has.
+/// \param t Object type.
+/// \return Trait bits.
+
+constexpr unsigned ComputeObjectTraits(ObjectType t){
+  return
+    (t == FREDIDLE_OBJECT || t == FREDATTACK_OBJECT || t == SWAZIDLE_OBJECT ||
+     t == SWAZATTACK_OBJECT || t == POLKIDLE_OBJECT || t == POLKATTACK_OBJECT?
+       ACTIVEPLAYER_TRAIT | WALLED_TRAIT: 0) |
+
+    (t == FREDHURT_OBJECT || t == SWAZHURT_OBJECT || t == POLKHURT_OBJECT?
+       HURTPLAYER_TRAIT | WALLED_TRAIT: 0) |
+
+    (t == PROJECTILEF_OBJECT || t == PROJECTILES_OBJECT || t == PROJECTILEP_OBJECT?
+       PLAYERSHOT_TRAIT | WALLED_TRAIT: 0) |
+
+    (t == PROJECTILED_OBJECT || t == PROJECTILEZ_OBJECT || t == PROJECTILEK_OBJECT?
+       PIERCESHOT_TRAIT: 0) |
+
+    (t == PROJECTILEENEMY1_OBJECT || t == PROJECTILEINVADER_OBJECT?
+       ENEMYSHOT_TRAIT | SPIKED_TRAIT | HARMFUL_TRAIT | WALLED_TRAIT: 0) |
+
+    (t == PROJECTILETHIEF_OBJECT?
+       ENEMYSHOT_TRAIT | SPIKED_TRAIT | HARMFUL_TRAIT: 0) |
+
+    (t == PROJECTILEINVADER_OBJECT? PIERCEABLE_TRAIT: 0) |
+
+    (t == ENEMY1IDLE_OBJECT?
+       INTELLIGENT_TRAIT | SPIKED_TRAIT | HARMFUL_TRAIT | PIERCEABLE_TRAIT: 0) |
+
+    (t == ENEMY1AFTER_OBJECT? SHOOTABLE_TRAIT | PIERCEABLE_TRAIT: 0) |
+
+    (t == ENEMYINVADERIDLE_OBJECT?
+       INTELLIGENT_TRAIT | INVADER_TRAIT | HARMFUL_TRAIT | SHOOTABLE_TRAIT | PIERCEABLE_TRAIT: 0) |
+
+    (t == ENEMYINVADERATTACK_OBJECT?
+       INVADER_TRAIT | HARMFUL_TRAIT | SHOOTABLE_TRAIT | PIERCEABLE_TRAIT: 0) |
+
+    (t == ENEMYINVADERHURT_OBJECT? INVADER_TRAIT | HURTENEMY_TRAIT: 0) |
+
+    (t == ENEMYZOOMERIDLE_OBJECT || t == ENEMYZOOMERIDLEFLIP_OBJECT?
+       HARMFUL_TRAIT | SHOOTABLE_TRAIT | PIERCEABLE_TRAIT | WALLED_TRAIT: 0) |
+
+    (t == ENEMYZOOMERBOUNCE_OBJECT || t == ENEMYZOOMERBOUNCEFLIP_OBJECT?
+       SHOOTABLE_TRAIT | PIERCEABLE_TRAIT: 0) |
+
+    (t == ENEMYTHIEFIDLE_OBJECT?
+       INTELLIGENT_TRAIT | HARMFUL_TRAIT | SHOOTABLE_TRAIT | PIERCEABLE_TRAIT | WALLED_TRAIT: 0) |
+
+    (t == ENEMYTHIEFATTACK_OBJECT? SHOOTABLE_TRAIT | PIERCEABLE_TRAIT: 0) |
+
+    (t == ENEMY1HURT_OBJECT || t == ENEMYZOOMERHURT_OBJECT || t == ENEMYTHIEFHURT_OBJECT?
+       HURTENEMY_TRAIT: 0) |
+
+    (t == ASSISTFRED_OBJECT || t == ASSISTSWAZ_OBJECT || t == ASSISTPOLK_OBJECT?
+       ASSIST_TRAIT: 0) |
+
+    (t == ITEMR_OBJECT || t == ITEMW_OBJECT || t == ITEMO_OBJECT? SHIELDITEM_TRAIT: 0) |
+    (t == ITEME_OBJECT || t == ITEMA_OBJECT || t == ITEML_OBJECT? ASSISTITEM_TRAIT: 0) |
+    (t == ITEMD_OBJECT || t == ITEMZ_OBJECT || t == ITEMK_OBJECT? PIERCEITEM_TRAIT: 0);
+} //ComputeObjectTraits
+
+/// \brief Move kinds.
+///
+/// What CGameObject's move does to an object, one bit for each thing that
+/// it does. The object manager moves the objects of each kind in a loop of
+/// their own, with code for just that kind.
+
+const unsigned WALLED_MOVE = 1 << 0; ///< Kept inside the edges of the screen.
+const unsigned CULLED_MOVE = 1 << 1; ///< Dies when the screen leaves it behind.
+const unsigned AIMED_MOVE  = 1 << 2; ///< Faces the way that it is going.
+const unsigned FACE_MOVE   = 1 << 3; ///< Faces the player.
+const unsigned SHIELD_MOVE = 1 << 4; ///< Stays on the player while the shield is up.
+const unsigned ASSIST_MOVE = 1 << 5; ///< Stays beside the player while the assist is up.
+
+/// Compute the move kind of an object type. Like the traits, this is only
+/// evaluated at compile time.
+/// \param t Object type.
+/// \return Move kind bits, 0 if move does nothing to it.
+
+constexpr unsigned ComputeMoveKind(ObjectType t){
+  return
+    (ComputeObjectTraits(t) & WALLED_TRAIT? WALLED_MOVE: 0) |
+    (ComputeObjectTraits(t) & INTELLIGENT_TRAIT? CULLED_MOVE: 0) |
+    (t == PROJECTILEENEMY1_OBJECT? AIMED_MOVE: 0) |
+    (ComputeObjectTraits(t) & INVADER_TRAIT? FACE_MOVE: 0) |
+    (t == SHIELD_OBJECT? SHIELD_MOVE: 0) |
+    (ComputeObjectTraits(t) & ASSIST_TRAIT? ASSIST_MOVE: 0);
+} //ComputeMoveKind
+
+/// The move kinds that object types have, one move bucket each, in the order
+/// that the object manager moves the buckets. Walled objects go first because
+/// the player is one of them, so that objects that follow or face the player
+/// see where it ends up this tick.
+
+constexpr unsigned g_nMoveKind[] = {
+  WALLED_MOVE, WALLED_MOVE | AIMED_MOVE, WALLED_MOVE | CULLED_MOVE,
+  CULLED_MOVE, CULLED_MOVE | FACE_MOVE, FACE_MOVE, SHIELD_MOVE, ASSIST_MOVE,
+}; //g_nMoveKind
+
+const int NUM_MOVE_BUCKETS = sizeof(g_nMoveKind)/sizeof(unsigned); ///< Number of move buckets.
+
+/// Compute the move bucket of an object type.
+/// \param t Object type.
+/// \return Index into g_nMoveKind, -1 if move does nothing to it, NUM_MOVE_BUCKETS if its kind is missing.
+
+constexpr int ComputeMoveBucket(ObjectType t){
+  if(ComputeMoveKind(t) == 0)return -1;
+  int i = 0;
+  while(i < NUM_MOVE_BUCKETS && g_nMoveKind[i] != ComputeMoveKind(t))i++;
+  return i;
+} //ComputeMoveBucket
+
+/// Compute the components of an object type, which pick its archetype in the
+/// entity store. Every object has a transform and an animation. Objects that
+/// stay put, on the player or where they were made, have no velocity and no
+/// life span. Only objects that can be in a collision have health, and so do
+/// hurt enemies, which keep theirs for the type that they turn back into.
+/// \param t Object type.
+/// \return Component bits.
+
+constexpr unsigned ComputeComponents(ObjectType t){
+  return TRANSFORM_COMPONENT | ANIMATION_COMPONENT |
+    (t == EXPLOSION_OBJECT || (ComputeMoveKind(t) & (SHIELD_MOVE | ASSIST_MOVE))?
+      0: VELOCITY_COMPONENT | LIFETIME_COMPONENT) |
+    (t == ITEMHEART_OBJECT || (ComputeObjectTraits(t) & (ACTIVEPLAYER_TRAIT |
+      PLAYERSHOT_TRAIT | PIERCESHOT_TRAIT | HARMFUL_TRAIT | SHOOTABLE_TRAIT |
+      PIERCEABLE_TRAIT | SPIKED_TRAIT | SHIELDITEM_TRAIT | ASSISTITEM_TRAIT |
+      PIERCEITEM_TRAIT | HURTENEMY_TRAIT))? COLLIDER_COMPONENT: 0) |
+    (ComputeObjectTraits(t) & INTELLIGENT_TRAIT? AI_COMPONENT: 0);
+} //ComputeComponents
+
+/// \brief The trait table.
+///
+/// Holds the traits of every object type, indexed by type. The template
+/// parameters are the indices 0 to NUM_OBJECT_TYPES - 1, which lets the
+/// compiler fill in the whole table from ComputeObjectTraits, the move
+/// buckets from ComputeMoveBucket, and the components from ComputeComponents.
+
+template<size_t... index> struct CObjectTraitTable{
+  static constexpr unsigned m_nTraits[sizeof...(index)] = {ComputeObjectTraits((ObjectType)index)...}; ///< Traits of each type.
+  static constexpr int m_nMoveBucket[sizeof...(index)] = {ComputeMoveBucket((ObjectType)index)...}; ///< Move bucket of each type.
+  static constexpr unsigned m_nComponents[sizeof...(index)] = {ComputeComponents((ObjectType)index)...}; ///< Components of each type.
+
+  /// Check at compile time that every move kind has a bucket.
+  /// \return true if no type's kind is missing from g_nMoveKind.
+
+  static constexpr bool AllMoveKindsListed(){
+    for(int b: m_nMoveBucket)
+      if(b == NUM_MOVE_BUCKETS)return false;
+    return true;
+  } //AllMoveKindsListed
+}; //CObjectTraitTable
+
+template<size_t... index> constexpr unsigned CObjectTraitTable<index...>::m_nTraits[sizeof...(index)];
+template<size_t... index> constexpr int CObjectTraitTable<index...>::m_nMoveBucket[sizeof...(index)];
+template<size_t... index> constexpr unsigned CObjectTraitTable<index...>::m_nComponents[sizeof...(index)];
+
+template<size_t... index> CObjectTraitTable<index...> MakeObjectTraitTable(std::index_sequence<index...>);
+
+/// The trait table for all object types.
+
+typedef decltype(MakeObjectTraitTable(std::make_index_sequence<NUM_OBJECT_TYPES>())) ObjectTraitTable;
+
+static_assert(ObjectTraitTable::AllMoveKindsListed(), "an object type has a move kind that is not in g_nMoveKind");
+
+/// Check whether an object type has any of a set of traits. This is a table
+/// load and an AND.
+/// \param t Object type.
+/// \param traits One or more trait bits.
+/// \return true if type t has at least one of the traits.
+
+inline bool HasTrait(ObjectType t, unsigned traits){
+  return (ObjectTraitTable::m_nTraits[t] & traits) != 0;
+} //HasTrait
+
+/// Get the move bucket of an object type.
+/// \param t Object type.
+/// \return Index into g_nMoveKind, -1 if move does nothing to objects of this type.
+
+inline int GetMoveBucket(ObjectType t){
+  return ObjectTraitTable::m_nMoveBucket[t];
+} //GetMoveBucket
+
+/// Get the components of an object type.
+/// \param t Object type.
+/// \return Component bits.
+
+inline unsigned GetComponents(ObjectType t){
+  return ObjectTraitTable::m_nComponents[t];
+} //GetComponents
@@ -1,26 +1,166 @@
 // \file random.cpp
 // \brief Code for the random number generator CRandom.
 
-#include <windows.h>
+#include <chrono>
 
-#include "random.h"
+#include "Random.h"
+#include "Snapshot.h"
 #include "debug.h"
 
+/// Rotate left.
+/// \param x Bits to rotate.
+/// \param k Number of places, 1 to 31.
+/// \return x rotated left by k.
+
+static inline unsigned rotl(unsigned x, int k){
+  return (x << k) | (x >> (32 - k));
+} //rotl
+
+/// One step of the splitmix64 generator, used to spread a seed over the
+/// whole state so that similar seeds give unrelated sequences.
+/// \param x Splitmix state, updated.
+/// \return 64 well mixed bits.
+
+static unsigned long long splitmix64(unsigned long long& x){
+  unsigned long long z = (x += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+} //splitmix64
+
 CRandom::CRandom(){ 
   sowseed(); //seed random number generator
 } //constructor
 
-/// Seed the random number generator from the clock.
+/// \param s Seed.
+
+CRandom::CRandom(unsigned long long s){ 
+  seed(s);
+} //constructor
+
+/// Seed the random number generator. The same seed always gives the same
+/// sequence of numbers.
+/// \param s Seed.
+
+void CRandom::seed(unsigned long long s){
+  const unsigned long long a = splitmix64(s);
+  const unsigned long long b = splitmix64(s);
+  m_nState[0] = (unsigned)a; m_nState[1] = (unsigned)(a >> 32);
+  m_nState[2] = (unsigned)b; m_nState[3] = (unsigned)(b >> 32);
+  if((m_nState[0] | m_nState[1] | m_nState[2] | m_nState[3]) == 0)
+    m_nState[0] = 1; //all zero state would stay zero
+} //seed
+
+/// Seed the random number generator from the clock, for a game that is
+/// different every time. Don't call this during play if the game is to
+/// be reproducible.
 
 void CRandom::sowseed(){ 
-  srand(timeGetTime()); 
+  using namespace std::chrono;
+  seed((unsigned long long)high_resolution_clock::now().time_since_epoch().count());
 } //sowseed
 
-/// Return a random integer within a given range.
+/// Get the next 32 random bits.
+/// \return Random unsigned integer.
+
+unsigned CRandom::next(){
+  unsigned* s = m_nState;
+  const unsigned result = rotl(s[1]*5, 7)*9;
+  const unsigned t = s[1] << 9;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 11);
+
+  return result;
+} //next
+
+/// Skip ahead 2^64 numbers. Generators seeded the same and then jumped
+/// different numbers of times give streams that never overlap in practice.
+
+void CRandom::jump(){
+  static const unsigned JUMP[] = {0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b};
+  unsigned s[4] = {0, 0, 0, 0};
+
+  for(int i=0; i<4; i++)
+    for(int b=0; b<32; b++){
+      if(JUMP[i] & (1u << b))
+        for(int k=0; k<4; k++)
+          s[k] ^= m_nState[k];
+      next();
+    } //for
+
+  for(int k=0; k<4; k++)
+    m_nState[k] = s[k];
+} //jump
+
+/// Return a random integer within a given range. The 32 random bits are
+/// multiplied by the size of the range and the top half is the answer,
+/// with the few values that would make some answers more likely than
+/// others thrown away and drawn again.
 /// \param i Bottom of range.
 /// \param j Top of range.
-/// \return A random positive integer r such that i<=r<=j.
+/// \return A random integer r such that i<=r<=j.
 
 int CRandom::number(int i, int j){  
-  return rand()%(j - i + 1) + i;
+  const unsigned range = (unsigned)j - (unsigned)i + 1; //0 means all 2^32 values
+  if(range == 0)return (int)next();
+
+  unsigned long long m = (unsigned long long)next()*range;
+  unsigned low = (unsigned)m;
+
+  if(low < range){ //might be in the biased part
+    const unsigned threshold = (0u - range)%range; //2^32 mod range
+    while(low < threshold){
+      m = (unsigned long long)next()*range;
+      low = (unsigned)m;
+    } //while
+  } //if
+
+  return (int)((unsigned)i + (unsigned)(m >> 32));
 } //number
+
+/// Fill an array with random bits.
+/// \param p Array.
+/// \param n Number of entries.
+
+void CRandom::fill(unsigned* p, int n){
+  for(int k=0; k<n; k++)
+    p[k] = next();
+} //fill
+
+/// Fill an array with random integers in a range.
+/// \param p Array.
+/// \param n Number of entries.
+/// \param i Bottom of range.
+/// \param j Top of range.
+
+void CRandom::fill(int* p, int n, int i, int j){
+  for(int k=0; k<n; k++)
+    p[k] = number(i, j);
+} //fill
+
+/// Get the generator state, so that it can be hashed or saved.
+/// \return Pointer to the 4 words of state.
+
+const unsigned* CRandom::GetState(){
+  return m_nState;
+} //GetState
+
+/// Save the generator state to a snapshot.
+/// \param s Snapshot.
+
+void CRandom::save(CSnapshot& s){
+  s.write(m_nState);
+} //save
+
+/// Restore the generator state from a snapshot, so that it gives the same
+/// numbers that it gave after the snapshot was taken.
+/// \param s Snapshot.
+
+void CRandom::restore(CSnapshot& s){
+  s.read(m_nState);
+} //restore
@@ -3,11 +3,33 @@
 
 #pragma once
 
+class CSnapshot;
+
 /// \brief The random number generator.
+///
+/// A xoshiro128** generator with 128 bits of state. Each instance has its
+/// own state, so separate worlds or threads can have their own generators,
+/// and the same seed always gives the same numbers. Ranges are reduced by
+/// multiplying and rejecting, which has no modulo bias.
 
 class CRandom{
+  private:
+    unsigned m_nState[4]; ///< Generator state, never all zero.
+
   public:
-    CRandom(); ///< Constructor
+    CRandom(); ///< Constructor, seeds from the clock.
+    CRandom(unsigned long long s); ///< Constructor with a seed.
+
+    void seed(unsigned long long s); ///< Seed the random number generator.
+    void sowseed(); ///< Seed the random number generator from the clock.
+    void jump(); ///< Skip ahead 2^64 numbers, for a stream that won't overlap.
+
+    unsigned next(); ///< Get 32 random bits.
     int number(int i, int j); ///< Get random number in i..j.
-    void sowseed(); ///< Seed the random number generator.
+    void fill(unsigned* p, int n); ///< Fill an array with random bits.
+    void fill(int* p, int n, int i, int j); ///< Fill an array with random numbers in i..j.
+
+    const unsigned* GetState(); ///< Get the 4 words of generator state.
+    void save(CSnapshot& s); ///< Save the generator state to a snapshot.
+    void restore(CSnapshot& s); ///< Restore the generator state from a snapshot.
 }; //CRandom
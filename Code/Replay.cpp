@@ -0,0 +1,176 @@
+/// \file Replay.cpp
+/// \brief Code for the input recording class CReplay.
+
+#include <fstream>
+#include <iterator>
+#include <string.h>
+
+#include "Replay.h"
+
+static const char REPLAY_MAGIC[4] = {'C', 'S', 'F', 'R'}; ///< First bytes of a recording.
+const unsigned char REPLAY_VERSION = 2; ///< Version of the file format.
+const size_t REPLAY_HEADER_SIZE = 21; ///< Bytes in the file header.
+
+CReplay::CReplay():
+  m_nReadPos(0), m_nSeed(0), m_nStartTime(0), m_nLastTime(0), m_nTickCount(0){
+} //constructor
+
+/// Append a varint, 7 bits to a byte, low bits first, with the top bit
+/// set on all bytes but the last.
+/// \param n Number to append.
+
+void CReplay::PutVarint(unsigned long long n){
+  while(n >= 0x80){
+    m_nData.push_back((unsigned char)(n | 0x80));
+    n >>= 7;
+  } //while
+  m_nData.push_back((unsigned char)n);
+} //PutVarint
+
+/// Read a varint at the read position and move past it.
+/// \param n [out] Number read.
+/// \return TRUE if there was a whole varint to read.
+
+BOOL CReplay::GetVarint(unsigned long long& n){
+  n = 0;
+  for(int shift=0; shift<64; shift+=7){
+    if(m_nReadPos >= m_nData.size())return FALSE;
+    const unsigned char b = m_nData[m_nReadPos++];
+    n |= (unsigned long long)(b & 0x7F) << shift;
+    if((b & 0x80) == 0)return TRUE;
+  } //for
+  return FALSE;
+} //GetVarint
+
+/// Throw away anything recorded so far and start again.
+/// \param seed Random number seed that the game was started with.
+/// \param time Time before the first tick, in microseconds.
+
+void CReplay::StartRecording(unsigned long long seed, long long time){
+  m_nData.clear();
+  m_nReadPos = 0;
+  m_nSeed = seed;
+  m_nStartTime = m_nLastTime = time;
+  m_nTickCount = 0;
+} //StartRecording
+
+/// Record a tick.
+/// \param time Time of the tick in microseconds.
+/// \param input Keys pressed and released during the tick, in order.
+/// \param hash Hash of the world state at the end of the tick.
+
+void CReplay::RecordTick(long long time, const vector<INPUTEVENT>& input, unsigned hash){
+  const long long delta = time - m_nLastTime;
+  PutVarint((unsigned long long)delta << 1 ^ (unsigned long long)(delta >> 63)); //zigzag
+  m_nLastTime = time;
+
+  PutVarint(input.size());
+  for(const INPUTEVENT& e: input)
+    PutVarint((unsigned)e.m_nKey << 1 | (e.m_bDown? 1: 0));
+
+  for(int i=0; i<4; i++)
+    m_nData.push_back((unsigned char)(hash >> 8*i));
+
+  m_nTickCount++;
+} //RecordTick
+
+/// Write the recording to a file.
+/// \param fileName File name.
+/// \return TRUE if the file was written.
+
+BOOL CReplay::save(const char* fileName){
+  std::ofstream file(fileName, std::ios::binary);
+  if(!file)return FALSE;
+
+  unsigned char header[REPLAY_HEADER_SIZE];
+  memcpy(header, REPLAY_MAGIC, 4);
+  header[4] = REPLAY_VERSION;
+  for(int i=0; i<8; i++){
+    header[5 + i] = (unsigned char)(m_nSeed >> 8*i);
+    header[13 + i] = (unsigned char)((unsigned long long)m_nStartTime >> 8*i);
+  } //for
+
+  file.write((const char*)header, REPLAY_HEADER_SIZE);
+  file.write((const char*)m_nData.data(), m_nData.size());
+  return file.good()? TRUE: FALSE;
+} //save
+
+/// Read a recording from a file and get ready to play it from the start.
+/// The ticks are checked on the way in, so that a truncated file is
+/// reported here rather than part way through playing it.
+/// \param fileName File name.
+/// \return TRUE if the file holds a whole recording of this version.
+
+BOOL CReplay::load(const char* fileName){
+  std::ifstream file(fileName, std::ios::binary);
+  if(!file)return FALSE;
+
+  vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if(bytes.size() < REPLAY_HEADER_SIZE || memcmp(bytes.data(), REPLAY_MAGIC, 4) != 0 ||
+    bytes[4] != REPLAY_VERSION)
+    return FALSE;
+
+  unsigned long long seed = 0, start = 0;
+  for(int i=0; i<8; i++){
+    seed |= (unsigned long long)bytes[5 + i] << 8*i;
+    start |= (unsigned long long)bytes[13 + i] << 8*i;
+  } //for
+
+  StartRecording(seed, (long long)start);
+  m_nData.assign(bytes.begin() + REPLAY_HEADER_SIZE, bytes.end());
+
+  long long time;
+  vector<INPUTEVENT> input;
+  unsigned hash;
+  int count = 0;
+  while(m_nReadPos < m_nData.size()){
+    if(!NextTick(time, input, hash))return FALSE;
+    count++;
+  } //while
+
+  m_nReadPos = 0;
+  m_nLastTime = m_nStartTime;
+  m_nTickCount = count;
+  return TRUE;
+} //load
+
+/// Play the next tick of a loaded recording.
+/// \param time [out] Time of the tick in microseconds.
+/// \param input [out] Keys pressed and released during the tick, in order.
+/// \param hash [out] Hash of the world state at the end of the tick.
+/// \return TRUE if there was a whole tick to play.
+
+BOOL CReplay::NextTick(long long& time, vector<INPUTEVENT>& input, unsigned& hash){
+  unsigned long long delta, count, key;
+  if(!GetVarint(delta) || !GetVarint(count))return FALSE;
+
+  input.clear();
+  for(unsigned long long i=0; i<count; i++){
+    if(!GetVarint(key))return FALSE;
+    INPUTEVENT e;
+    e.m_nKey = (unsigned char)(key >> 1);
+    e.m_bDown = (key & 1)? TRUE: FALSE;
+    input.push_back(e);
+  } //for
+
+  if(m_nReadPos + 4 > m_nData.size())return FALSE;
+  hash = 0;
+  for(int i=0; i<4; i++)
+    hash |= (unsigned)m_nData[m_nReadPos++] << 8*i;
+
+  m_nLastTime += (long long)(delta >> 1) ^ -(long long)(delta & 1); //zigzag
+  time = m_nLastTime;
+  return TRUE;
+} //NextTick
+
+unsigned long long CReplay::GetSeed(){
+  return m_nSeed;
+} //GetSeed
+
+long long CReplay::GetStartTime(){
+  return m_nStartTime;
+} //GetStartTime
+
+int CReplay::GetNumTicks(){
+  return m_nTickCount;
+} //GetNumTicks
@@ -0,0 +1,57 @@
+/// \file Replay.h
+/// \brief Interface for the input recording class CReplay.
+
+#pragma once
+
+#include <vector>
+
+#include "Defines.h"
+
+/// \brief A key pressed or released during a tick.
+
+struct INPUTEVENT{
+  unsigned char m_nKey; ///< Virtual key code.
+  BOOL m_bDown; ///< TRUE if pressed, FALSE if released.
+}; //INPUTEVENT
+
+/// \brief Input recording.
+///
+/// Records everything that a game needs to be played again exactly: the
+/// random number seed, and for each tick the time, the keys pressed and
+/// released, and a hash of the world state at the end of the tick. When it
+/// is played back the hashes show the first tick that came out differently.
+///
+/// The file is a header followed by the ticks. The header is the letters
+/// CSFR, a version byte, the seed and the start time in microseconds, both
+/// 8 bytes little endian. Each tick is the microseconds since the last tick,
+/// zigzag encoded since restarting a level sets the clock back, and the
+/// number of events, both as varints, then one varint per event
+/// holding the key code shifted left with the down flag in bit 0, then the
+/// 4 byte hash. A tick with no input takes about 7 bytes.
+
+class CReplay{
+  private:
+    vector<unsigned char> m_nData; ///< Encoded ticks.
+    size_t m_nReadPos; ///< Position in m_nData of the next tick to play.
+    unsigned long long m_nSeed; ///< Random number seed.
+    long long m_nStartTime; ///< Time before the first tick, in microseconds.
+    long long m_nLastTime; ///< Time of the last tick recorded or played.
+    int m_nTickCount; ///< Number of ticks recorded.
+
+    void PutVarint(unsigned long long n); ///< Append a varint.
+    BOOL GetVarint(unsigned long long& n); ///< Read a varint.
+
+  public:
+    CReplay(); ///< Constructor.
+
+    void StartRecording(unsigned long long seed, long long time); ///< Start a new recording.
+    void RecordTick(long long time, const vector<INPUTEVENT>& input, unsigned hash); ///< Record a tick.
+    BOOL save(const char* fileName); ///< Write the recording to a file.
+
+    BOOL load(const char* fileName); ///< Read a recording from a file.
+    BOOL NextTick(long long& time, vector<INPUTEVENT>& input, unsigned& hash); ///< Play the next tick.
+
+    unsigned long long GetSeed(); ///< Get the random number seed.
+    long long GetStartTime(); ///< Get the time before the first tick.
+    int GetNumTicks(); ///< Get the number of ticks.
+}; //CReplay
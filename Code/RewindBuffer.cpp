@@ -0,0 +1,85 @@
+/// \file RewindBuffer.cpp
+/// \brief Code for the rewind ring buffer class CRewindBuffer.
+
+#include "RewindBuffer.h"
+
+CRewindBuffer::CRewindBuffer():
+  m_nNewest(-1), m_nCount(0), m_nInterval(0), m_nLastTime(-1){
+} //constructor
+
+/// Set the size of the ring and how often snapshots are taken. Any
+/// snapshots already taken are thrown away.
+/// \param n Number of snapshots, 0 for none.
+/// \param interval Time between snapshots in ms.
+
+void CRewindBuffer::SetSize(int n, int interval){
+  m_cSnapshot.resize(n > 0? n: 0);
+  m_nTime.resize(m_cSnapshot.size());
+  m_nInterval = 1000LL*interval;
+  clear();
+} //SetSize
+
+/// Find out whether it is time to take a snapshot, that is, whether the
+/// interval has gone by since the last one was taken or gone back to.
+/// \param time Current time in microseconds.
+/// \return TRUE if a snapshot should be taken.
+
+BOOL CRewindBuffer::due(long long time){
+  if(m_cSnapshot.empty())return FALSE;
+  return m_nLastTime < 0 || time >= m_nLastTime + m_nInterval;
+} //due
+
+/// Make room for a new snapshot, writing over the oldest if the ring is
+/// full. The caller saves the world into the snapshot returned. Must not
+/// be called if the ring has size 0.
+/// \param time Time of the snapshot in microseconds.
+/// \return The snapshot to save into, now the newest.
+
+CSnapshot& CRewindBuffer::push(long long time){
+  const int n = (int)m_cSnapshot.size();
+  m_nNewest = (m_nNewest + 1)%n;
+  if(m_nCount < n)m_nCount++;
+  m_nTime[m_nNewest] = m_nLastTime = time;
+  m_cSnapshot[m_nNewest].clear();
+  return m_cSnapshot[m_nNewest];
+} //push
+
+/// Get a snapshot, counting back from the newest.
+/// \param n 0 for the newest, 1 for the one before, and so on.
+/// \return Pointer to the snapshot, nullptr if there aren't that many.
+
+CSnapshot* CRewindBuffer::get(int n){
+  if(n < 0 || n >= m_nCount)return nullptr;
+  const int size = (int)m_cSnapshot.size();
+  return &m_cSnapshot[(m_nNewest - n + size)%size];
+} //get
+
+/// Throw away the newest snapshots, for instance after going back to one,
+/// since it and the ones after it are then in the future. The next snapshot
+/// is due an interval after the oldest one thrown away, so going back again
+/// before then goes back further.
+/// \param n Number of snapshots to throw away.
+
+void CRewindBuffer::pop(int n){
+  if(n > m_nCount)n = m_nCount;
+  if(n <= 0)return;
+  const int size = (int)m_cSnapshot.size();
+  m_nLastTime = m_nTime[(m_nNewest - n + 1 + size)%size];
+  m_nNewest = (m_nNewest - n + size)%size;
+  m_nCount -= n;
+} //pop
+
+/// Throw away all snapshots, keeping their memory.
+
+void CRewindBuffer::clear(){
+  m_nNewest = -1;
+  m_nCount = 0;
+  m_nLastTime = -1;
+} //clear
+
+/// Get the number of snapshots in the ring.
+/// \return Number of snapshots.
+
+int CRewindBuffer::size(){
+  return m_nCount;
+} //size
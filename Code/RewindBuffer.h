@@ -0,0 +1,37 @@
+/// \file RewindBuffer.h
+/// \brief Interface for the rewind ring buffer class CRewindBuffer.
+
+#pragma once
+
+#include <vector>
+
+#include "Defines.h"
+#include "Snapshot.h"
+
+/// \brief The rewind buffer.
+///
+/// A ring of world snapshots taken every so often during play, newest
+/// last. When the ring is full the oldest snapshot is written over, so the
+/// buffer always covers the last few seconds of play and its memory stops
+/// growing once every snapshot has been used once.
+
+class CRewindBuffer{
+  private:
+    vector<CSnapshot> m_cSnapshot; ///< Ring of snapshots.
+    vector<long long> m_nTime; ///< Time each snapshot was taken, in microseconds.
+    int m_nNewest; ///< Index of the newest snapshot.
+    int m_nCount; ///< Number of snapshots in the ring.
+    long long m_nInterval; ///< Time between snapshots in microseconds.
+    long long m_nLastTime; ///< Time of the last snapshot taken or gone back to, -1 if none.
+
+  public:
+    CRewindBuffer(); ///< Constructor.
+
+    void SetSize(int n, int interval); ///< Set the number of snapshots and the time between them.
+    BOOL due(long long time); ///< Is it time for another snapshot?
+    CSnapshot& push(long long time); ///< Get the snapshot to take next.
+    CSnapshot* get(int n); ///< Get a snapshot counting back from the newest.
+    void pop(int n); ///< Throw away the newest snapshots.
+    void clear(); ///< Throw away all snapshots.
+    int size(); ///< Number of snapshots in the ring.
+}; //CRewindBuffer
@@ -0,0 +1,58 @@
+/// \file Snapshot.cpp
+/// \brief Code for the world snapshot class CSnapshot.
+
+#include <string.h>
+
+#include "Snapshot.h"
+
+CSnapshot::CSnapshot(): m_nReadPos(0){
+} //constructor
+
+/// Throw away what was written, keeping the memory.
+
+void CSnapshot::clear(){
+  m_nData.clear();
+  m_nReadPos = 0;
+} //clear
+
+/// Go back to the start of the snapshot to read it again.
+
+void CSnapshot::rewind(){
+  m_nReadPos = 0;
+} //rewind
+
+/// Find out whether anything has been written.
+/// \return TRUE if the snapshot is empty.
+
+BOOL CSnapshot::empty(){
+  return m_nData.empty();
+} //empty
+
+/// Get the size of the snapshot.
+/// \return Number of bytes written.
+
+size_t CSnapshot::size(){
+  return m_nData.size();
+} //size
+
+/// Append bytes to the snapshot.
+/// \param p Pointer to the bytes.
+/// \param n Number of bytes.
+
+void CSnapshot::write(const void* p, size_t n){
+  const unsigned char* b = (const unsigned char*)p;
+  m_nData.insert(m_nData.end(), b, b + n);
+} //write
+
+/// Read bytes from the snapshot and move past them.
+/// \param p [out] Where to put the bytes.
+/// \param n Number of bytes.
+/// \return TRUE if there were n bytes left to read.
+
+BOOL CSnapshot::read(void* p, size_t n){
+  if(m_nReadPos + n > m_nData.size())return FALSE;
+  if(n == 0)return TRUE;
+  memcpy(p, &m_nData[m_nReadPos], n);
+  m_nReadPos += n;
+  return TRUE;
+} //read
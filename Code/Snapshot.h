@@ -0,0 +1,50 @@
+/// \file Snapshot.h
+/// \brief Interface for the world snapshot class CSnapshot.
+
+#pragma once
+
+#include <vector>
+
+#include "Defines.h"
+
+/// \brief A world snapshot.
+///
+/// A buffer that the parts of the world write their state into, field by
+/// field, and read it back from in the same order. Only what can't be worked
+/// out again is written, and pointers are written as indices, so a snapshot
+/// of a level in play is a few kilobytes. The buffer keeps its memory when it
+/// is cleared, so a snapshot that is taken over and over stops allocating.
+/// Fields are written in the machine's own byte order, so a snapshot is for
+/// restoring in the same build, not for keeping.
+
+class CSnapshot{
+  private:
+    vector<unsigned char> m_nData; ///< Saved state.
+    size_t m_nReadPos; ///< Position in m_nData of the next field to read.
+
+  public:
+    CSnapshot(); ///< Constructor.
+
+    void clear(); ///< Empty, ready to write.
+    void rewind(); ///< Go back to the start, ready to read.
+    BOOL empty(); ///< Has nothing been written?
+    size_t size(); ///< Number of bytes written.
+
+    void write(const void* p, size_t n); ///< Append bytes.
+    BOOL read(void* p, size_t n); ///< Read bytes.
+
+    /// Append a field.
+    /// \param x Field to append.
+
+    template<class T> void write(const T& x){
+      write(&x, sizeof(T));
+    } //write
+
+    /// Read a field.
+    /// \param x [out] Field read.
+    /// \return TRUE if there was a field to read.
+
+    template<class T> BOOL read(T& x){
+      return read(&x, sizeof(T));
+    } //read
+}; //CSnapshot
@@ -9,7 +9,7 @@
 #include "Defines.h"
 
 extern XMLElement* g_xmlSettings;
-extern CObjectManager g_cObjectManager;
+extern CObjectManager& g_cObjectManager;
 
 /// Set member variables to sensible values and initialize the XAudio Engine using DirectXTK.
 
@@ -184,7 +184,7 @@ void CSoundManager::move(Vector3 ePos, int instance, int index){
   if(instance == -1)
     instance = m_nLastPlayedInstance;
 
-  Vector3 vFred = g_cObjectManager.GetPlayerObjectPtr()->m_vPos;
+  Vector3 vFred = g_cObjectManager.GetPlayerObjectPtr()->position();
   vFred.z = 100.0f; ePos.z = 0.0f; //fake depth
 
   AudioListener listener;
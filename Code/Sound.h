@@ -3,11 +3,13 @@
 
 #pragma once
 
-#include <Audio.h>
+#ifndef HEADLESS
+  #include <Audio.h>
+#endif //HEADLESS
 
 #include "Defines.h"
 #include "Abort.h"
-#include "sndlist.h" //list of sound names
+#include "Sndlist.h" //list of sound names
 
 /// \brief The sound manager. 
 ///
@@ -18,6 +20,7 @@
 
 class CSoundManager{
   private:
+  #ifndef HEADLESS //the headless build plays no sounds
     AudioEngine* m_pAudioEngine; ///< XAudio 2.8 Engine wrapped up in DirectXTK.
     vector<SoundEffect*> m_pSoundEffects; ///< A list of sound effect.
     SoundEffectInstance*** m_pInstance; ///< A list of arrays of sound effect instances.
@@ -32,6 +35,7 @@ class CSoundManager{
     void createInstances(int index, int n, SOUND_EFFECT_INSTANCE_FLAGS flags); ///< Create sound instances.
     int Load(wchar_t *filename); ///< Load sound from file.
     int getNextInstance(int index); ///< Get the next instance that is not playing.
+  #endif //HEADLESS
 
   public:
     CSoundManager(); ///< Constructor.
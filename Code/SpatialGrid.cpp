@@ -0,0 +1,132 @@
+/// \file SpatialGrid.cpp
+/// \brief Code for the uniform grid broadphase class CSpatialGrid.
+
+#include <algorithm>
+#include <math.h>
+
+#include "SpatialGrid.h"
+
+/// Constructor. The number of buckets is rounded up to a power of 2 so that
+/// the hash can be reduced with a mask.
+/// \param cellsize Width and height of a grid cell.
+/// \param buckets Minimum number of hash buckets.
+
+CSpatialGrid::CSpatialGrid(float cellsize, int buckets){
+  m_fCellSize = cellsize;
+  unsigned n = 1;
+  while((int)n < buckets)n <<= 1;
+  m_nBucketMask = n - 1;
+  m_nBucketStart.resize(n + 1, 0);
+} //constructor
+
+/// Change the cell size. Takes effect on the next build.
+/// \param cellsize Width and height of a grid cell.
+
+void CSpatialGrid::SetCellSize(float cellsize){
+  if(cellsize > 0.0f)
+    m_fCellSize = cellsize;
+} //SetCellSize
+
+/// Get the cell coordinate that a world coordinate falls in.
+/// \param f World coordinate.
+/// \return Cell coordinate.
+
+int CSpatialGrid::CellCoord(float f){
+  return (int)floorf(f/m_fCellSize);
+} //CellCoord
+
+/// Hash a cell into a bucket. Different cells can share a bucket, which
+/// only costs a few extra candidates in the query.
+/// \param cx Cell X coordinate.
+/// \param cy Cell Y coordinate.
+/// \return Bucket index.
+
+unsigned CSpatialGrid::Hash(int cx, int cy){
+  return ((unsigned)cx*73856093u ^ (unsigned)cy*19349663u) & m_nBucketMask;
+} //Hash
+
+/// Remove all points. Keeps the memory so that the grid can be refilled every
+/// tick without going back to the heap.
+
+void CSpatialGrid::clear(){
+  m_fX.clear();
+  m_fY.clear();
+  m_nBucket.clear();
+  m_nEntries.clear();
+} //clear
+
+/// Insert a point. Ids are handed out in insertion order, starting at zero.
+/// \param x X coordinate.
+/// \param y Y coordinate.
+/// \return Id of the point.
+
+int CSpatialGrid::insert(float x, float y){
+  m_fX.push_back(x);
+  m_fY.push_back(y);
+  m_nBucket.push_back(Hash(CellCoord(x), CellCoord(y)));
+  return (int)m_fX.size() - 1;
+} //insert
+
+/// Sort the inserted points into buckets using a counting sort. Must be
+/// called after the last insert and before the first query.
+
+void CSpatialGrid::build(){
+  const int n = (int)m_nBucket.size();
+  fill(m_nBucketStart.begin(), m_nBucketStart.end(), 0);
+
+  for(int i=0; i<n; i++) //count points per bucket
+    m_nBucketStart[m_nBucket[i] + 1]++;
+
+  for(unsigned b=0; b<=m_nBucketMask; b++) //prefix sum gives bucket starts
+    m_nBucketStart[b + 1] += m_nBucketStart[b];
+
+  m_nCursor.assign(m_nBucketStart.begin(), m_nBucketStart.end() - 1);
+  m_nEntries.resize(n);
+  for(int i=0; i<n; i++) //scatter, buckets keep insertion order
+    m_nEntries[m_nCursor[m_nBucket[i]]++] = i;
+} //build
+
+/// Append to result the ids of all points within a box of half-width r
+/// around a point, without wrap-around.
+/// \param x X coordinate.
+/// \param y Y coordinate.
+/// \param r Half-width of box.
+/// \param result Vector that ids are appended to.
+
+void CSpatialGrid::QueryCells(float x, float y, float r, vector<int>& result){
+  const int x0 = CellCoord(x - r), x1 = CellCoord(x + r);
+  const int y0 = CellCoord(y - r), y1 = CellCoord(y + r);
+
+  for(int cx=x0; cx<=x1; cx++)
+    for(int cy=y0; cy<=y1; cy++){
+      const unsigned b = Hash(cx, cy);
+      for(int k=m_nBucketStart[b]; k<m_nBucketStart[b + 1]; k++){
+        const int id = m_nEntries[k];
+        if(fabs(m_fX[id] - x) <= r && fabs(m_fY[id] - y) <= r)
+          result.push_back(id);
+      } //for
+    } //for
+} //QueryCells
+
+/// Get the ids of all points that might be within distance r of a point.
+/// The world wraps horizontally, so points a world width away are found too.
+/// The result is sorted by id with no duplicates, so that the caller can
+/// process candidates in the order that they were inserted.
+/// \param x X coordinate.
+/// \param y Y coordinate.
+/// \param r Query radius.
+/// \param wrap World width, or zero for no wrap-around.
+/// \param result Vector that is cleared and filled with ids.
+
+void CSpatialGrid::query(float x, float y, float r, float wrap, vector<int>& result){
+  result.clear();
+  QueryCells(x, y, r, result);
+
+  if(wrap > 0.0f){
+    QueryCells(x + wrap, y, r, result);
+    QueryCells(x - wrap, y, r, result);
+  } //if
+
+  sort(result.begin(), result.end());
+  result.erase(unique(result.begin(), result.end()), result.end());
+} //query
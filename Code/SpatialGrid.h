@@ -0,0 +1,41 @@
+/// \file SpatialGrid.h
+/// \brief Interface for the uniform grid broadphase class CSpatialGrid.
+
+#pragma once
+
+#include <vector>
+
+using namespace std;
+
+/// \brief The spatial grid.
+///
+/// A uniform grid that is hashed into a fixed number of buckets, used as a
+/// collision broadphase. Points are inserted once per tick with an integer id,
+/// the grid is built with a counting sort, and then queries return the ids
+/// of everything in the cells surrounding a point. The grid knows nothing about
+/// game objects, the caller maps ids back to whatever it inserted.
+
+class CSpatialGrid{
+  private:
+    float m_fCellSize; ///< Width and height of a grid cell.
+    unsigned m_nBucketMask; ///< Number of hash buckets minus one.
+
+    vector<float> m_fX; ///< X coordinate of each inserted point.
+    vector<float> m_fY; ///< Y coordinate of each inserted point.
+    vector<unsigned> m_nBucket; ///< Hash bucket of each inserted point.
+    vector<int> m_nBucketStart; ///< Start of each bucket in m_nEntries, with sentinel at end.
+    vector<int> m_nEntries; ///< Point ids sorted by bucket.
+    vector<int> m_nCursor; ///< Next free slot in each bucket during build.
+
+    int CellCoord(float f); ///< Cell coordinate of a world coordinate.
+    unsigned Hash(int cx, int cy); ///< Hash bucket of a cell.
+    void QueryCells(float x, float y, float r, vector<int>& result); ///< Collect ids near one point.
+
+  public:
+    CSpatialGrid(float cellsize=32.0f, int buckets=1024); ///< Constructor.
+    void SetCellSize(float cellsize); ///< Change the cell size.
+    void clear(); ///< Remove all points.
+    int insert(float x, float y); ///< Insert a point, returns its id.
+    void build(); ///< Sort inserted points into buckets.
+    void query(float x, float y, float r, float wrap, vector<int>& result); ///< Get ids of points near a point.
+}; //CSpatialGrid
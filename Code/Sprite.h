@@ -3,11 +3,16 @@
 
 #pragma once
 
-#include <windows.h>
-#include <windowsx.h>
+#ifndef HEADLESS
+  #include <windows.h>
+  #include <windowsx.h>
+#endif //HEADLESS
 
-#include "defines.h"
-#include "Shader.h"
+#include "Defines.h"
+
+#ifndef HEADLESS
+  #include "Shader.h"
+#endif //HEADLESS
 
 using namespace DirectX;
 
@@ -23,12 +28,13 @@ class C3DSprite{
   friend void CreateObjects();
 
   protected:
-    ID3D11ShaderResourceView** m_pTexture; ///< Pointer to texture containing the sprite image.
     int m_nFrameCount; ///< Number of sprite frames.
     int m_nWidth; ///< Sprite width in pixels.
     int m_nHeight; ///< Sprite height in pixels.
     BOOL m_bBottomOrigin; ///< Is origin at bottom of sprite, as opposed to center?
 
+  #ifndef HEADLESS //the headless build has no textures or buffers
+    ID3D11ShaderResourceView** m_pTexture; ///< Pointer to texture containing the sprite image.
     ID3D11Buffer* m_pVertexBuffer; ///< Vertex buffer.
     BILLBOARDVERTEX* m_pVertexBufferData; ///< Vertex buffer data.
     D3D11_BUFFER_DESC m_VertexBufferDesc; ///< Vertex buffer descriptor.
@@ -36,10 +42,11 @@ class C3DSprite{
     ID3D11BlendState1* m_pBlendState; ///< Blend state.
     ID3D11RasterizerState1* m_pRasterizerState; ///< Rasterizer state.
     CShader* m_pShader; ///< Pointer to an instance of the shader class.
+  #endif //HEADLESS
 
   public:
     C3DSprite(int framecount); ///< Constructor.
-    C3DSprite::~C3DSprite(); ///< Destructor.
+    ~C3DSprite(); ///< Destructor.
     BOOL Load(char* filename, int frame); ///< Load texture image from file.
     void Draw(Vector3 p, float angle, int frame=0, BOOL ghost=FALSE); ///< Draw sprite at point p in 3D space.
     void Release(); ///< Release sprite.
@@ -3,8 +3,8 @@
 
 #pragma once
 
-#include "defines.h"
-#include "sprite.h"
+#include "Defines.h"
+#include "Sprite.h"
 
 /// \brief The sprite manager. 
 ///
@@ -1,98 +1,241 @@
 /// \file timer.cpp
 /// \brief Code for timer class CTimer.
 
-#include "timer.h"
+#include <chrono>
+
+#include "Timer.h"
+#include "Snapshot.h"
 #include "debug.h"
 
+const long long MAX_FRAME_TIME = 1000000; ///< Longest frame counted in the stats, in microseconds.
+
 CTimer::CTimer() :
 	m_nStartTime(0),
-	m_nLastFrameStartTime(0),
+	m_nCurrentTime(0),
+	m_bInFrame(FALSE),
+	m_nTimeSource(REAL_TIMESOURCE),
+	m_nVirtualTime(0),
+	m_nLastFrameStartTime(-1),
 	m_nFrameTime(0),
 	m_nLevelStartTime(0),
 	m_nLevelFinishTime(0),
 	m_bLevelTimerOn(FALSE)
-{}; //constructor
+{
+	ResetFrameStats();
+}; //constructor
+
+/// Read the time source. This is the only place that the timer asks
+/// the system for the time. The real clock is the standard library's
+/// steady clock, which never goes backwards.
+/// \return Microseconds on the real or virtual clock.
+
+long long CTimer::ReadClock(){
+  if(m_nTimeSource == VIRTUAL_TIMESOURCE)
+    return m_nVirtualTime;
+
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+} //ReadClock
+
+/// Choose where the time comes from. The virtual clock takes over from
+/// the time on the real one, so that times already handed out stay valid.
+/// \param source Real or virtual clock.
+
+void CTimer::SetTimeSource(TimeSourceType source){
+  if(source == VIRTUAL_TIMESOURCE && m_nTimeSource != VIRTUAL_TIMESOURCE)
+    m_nVirtualTime = ReadClock();
+  m_nTimeSource = source;
+} //SetTimeSource
+
+/// Move the virtual clock forward. Does nothing to the real clock.
+/// \param delta Milliseconds to move forward.
+
+void CTimer::advance(int delta){
+  m_nVirtualTime += 1000LL*delta;
+} //advance
+
+/// Move the virtual clock forward. Does nothing to the real clock.
+/// \param delta Microseconds to move forward.
+
+void CTimer::microadvance(long long delta){
+  m_nVirtualTime += delta;
+} //microadvance
 
 /// Start the timer from zero.
 
 void CTimer::start(){
-  m_nStartTime = timeGetTime();
+  m_nStartTime = ReadClock();
 } //start
 
-/// Get the time.
+/// Get the time. During a frame this is the time that the frame began,
+/// otherwise the clock is read.
+/// \return The time in microseconds.
+
+long long CTimer::microtime(){
+  return m_bInFrame? m_nCurrentTime: ReadClock() - m_nStartTime;
+} //microtime
+
+/// Get the time. During a frame this is the time that the frame began,
+/// otherwise the clock is read.
 /// \return The time in milliseconds.
 
-int CTimer::time(){ 
-  return timeGetTime() - m_nStartTime;
+int CTimer::time(){
+  return (int)(microtime()/1000);
 } //time
 
 /// Get last frame time for last frame in milliseconds.
 
 int CTimer::frametime() {
-	return m_nFrameTime;
+	return (int)(m_nFrameTime/1000);
 } //frametime
 
-/// The elapsed function is a useful function for measuring repeating time 
-/// intervals. Given the start and duration times, this function returns TRUE 
+/// Get last frame time for last frame in microseconds.
+
+long long CTimer::microframetime() {
+	return m_nFrameTime;
+} //microframetime
+
+/// Get the frame time statistics since they were last reset.
+/// \return Frame time statistics.
+
+const FRAMESTATS& CTimer::GetFrameStats() {
+	return m_sFrameStats;
+} //GetFrameStats
+
+/// Start the frame time statistics over.
+
+void CTimer::ResetFrameStats() {
+	m_sFrameStats.m_nFrames = 0;
+	m_sFrameStats.m_nLast = 0;
+	m_sFrameStats.m_nMin = 0;
+	m_sFrameStats.m_nMax = 0;
+	m_sFrameStats.m_nTotal = 0;
+} //ResetFrameStats
+
+/// The elapsed function is a useful function for measuring repeating time
+/// intervals. Given the start and duration times, this function returns TRUE
 /// if the interval is over, and has the side-effect of resetting the start
 /// time when that happens, thus setting things up for the next interval.
+/// If the clock has been set back past the start, by restoring a snapshot,
+/// the interval starts again from now.
 /// \param start Start of time interval
 /// \param interval Duration of time interval
 /// \return TRUE if time interval is over
 
 bool CTimer::elapsed(int &start, int interval){
   int curtime = time(); //current time
+  if(curtime < start)start = curtime; //clock was set back
 
   if(curtime >= start + interval){ //if interval is over
-    start = curtime; //reset the start 
+    start = curtime; //reset the start
     return true; //succeed
   } //if
 
   else return false; //otherwise, fail
 } //elapsed
 
+/// The microsecond version of elapsed.
+/// \param start Start of time interval in microseconds
+/// \param interval Duration of time interval in microseconds
+/// \return TRUE if time interval is over
+
+bool CTimer::microelapsed(long long &start, long long interval){
+  const long long curtime = microtime(); //current time
+  if(curtime < start)start = curtime; //clock was set back
+
+  if(curtime >= start + interval){ //if interval is over
+    start = curtime; //reset the start
+    return true; //succeed
+  } //if
+
+  else return false; //otherwise, fail
+} //microelapsed
+
 	/// This is the signal that a new animation frame has begun,
 	/// so that the timer can return the same time value for the
-	/// duration of this frame.
+	/// duration of this frame. The time since the last frame began
+	/// is recorded in the frame time statistics, unless it is so long
+	/// that the game must have been paused or in a menu.
 
 void CTimer::beginframe() {
-	const int t = timeGetTime();
+	const long long t = ReadClock();
 	m_nCurrentTime = t - m_nStartTime;
-	if (fabs(m_nFrameTime) > 1000)
-		m_nFrameTime = 0; //safety
+	m_bInFrame = TRUE;
+
+	m_nFrameTime = m_nLastFrameStartTime < 0? 0: t - m_nLastFrameStartTime;
 	m_nLastFrameStartTime = t;
+
+	if(m_nFrameTime > 0 && m_nFrameTime <= MAX_FRAME_TIME){
+		FRAMESTATS& s = m_sFrameStats;
+		if(s.m_nFrames == 0 || m_nFrameTime < s.m_nMin)s.m_nMin = m_nFrameTime;
+		if(m_nFrameTime > s.m_nMax)s.m_nMax = m_nFrameTime;
+		s.m_nLast = m_nFrameTime;
+		s.m_nTotal += m_nFrameTime;
+		s.m_nFrames++;
+	} //if
 } //beginframe
 
 /// This is the signal that an animation frame has ended.
 
 void CTimer::endframe() {
-	m_nFrameTime = 0;
+	m_bInFrame = FALSE;
 } //endframe
 
 /// Get the time that the current level started.
-/// \return Level start time.
+/// \return Level start time in milliseconds since the timer started.
 
 int CTimer::GetLevelStartTime() {
-	return m_nLevelStartTime;
+	return (int)((m_nLevelStartTime - m_nStartTime)/1000);
 } //GetLevelStartTime
 
 /// Get amount of time spent in the current level.
-/// \return Level elapsed time.
+/// \return Level elapsed time in milliseconds.
 
 int CTimer::GetLevelElapsedTime() {
-	return m_bLevelTimerOn ?
-		timeGetTime() - m_nLevelStartTime :
-		m_nLevelFinishTime - m_nLevelStartTime;
+	return (int)((m_bLevelTimerOn ?
+		ReadClock() - m_nLevelStartTime :
+		m_nLevelFinishTime - m_nLevelStartTime)/1000);
 } //GetLevelElapsedTime
 
 void CTimer::StartLevelTimer() {
 	m_bLevelTimerOn = TRUE;
-	m_nLevelStartTime = timeGetTime();
+	m_nLevelStartTime = ReadClock();
 } //StartLevelTimer
 
 /// Stop the level timer. Should be called at the end of a level.
 
 void CTimer::StopLevelTimer() {
 	m_bLevelTimerOn = FALSE;
-	m_nLevelFinishTime = timeGetTime();
-} //StopLevelTimer
\ No newline at end of file
+	m_nLevelFinishTime = ReadClock();
+} //StopLevelTimer
+
+/// Save the time and the level timer to a snapshot. The level times are
+/// saved relative to the start of the timer, like the time itself.
+/// \param s Snapshot.
+
+void CTimer::save(CSnapshot& s){
+	s.write(microtime());
+	s.write(m_nLevelStartTime - m_nStartTime);
+	s.write(m_nLevelFinishTime - m_nStartTime);
+	s.write(m_bLevelTimerOn);
+} //save
+
+/// Set the time back (or forward) to what it was when a snapshot was taken.
+/// The clock itself is not touched, the timer is started again at the time
+/// that makes it read the time in the snapshot. The next frame is left out
+/// of the frame time statistics.
+/// \param s Snapshot.
+
+void CTimer::restore(CSnapshot& s){
+	long long t = 0, levelStart = 0, levelFinish = 0;
+	s.read(t);
+	s.read(levelStart);
+	s.read(levelFinish);
+	s.read(m_bLevelTimerOn);
+
+	m_nStartTime = ReadClock() - t;
+	m_nCurrentTime = t;
+	m_nLevelStartTime = m_nStartTime + levelStart;
+	m_nLevelFinishTime = m_nStartTime + levelFinish;
+	m_nLastFrameStartTime = -1;
+} //restore
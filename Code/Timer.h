@@ -3,35 +3,75 @@
 
 #pragma once
 
-#include <windows.h> //needed for BOOL
+#ifndef HEADLESS
+  #include <windows.h> //needed for BOOL
+#endif //HEADLESS
+
 #include "Defines.h"
 
+class CSnapshot;
+
+/// \brief Frame time statistics.
+///
+/// Times are in microseconds. Frames that take longer than a second, such
+/// as the first one after a pause or a menu, are left out.
+
+struct FRAMESTATS{
+  int m_nFrames; ///< Number of frames measured.
+  long long m_nLast; ///< Time of the last frame.
+  long long m_nMin; ///< Shortest frame.
+  long long m_nMax; ///< Longest frame.
+  long long m_nTotal; ///< Sum of frame times, for the mean.
+}; //FRAMESTATS
+
 /// The \brief The timer. 
 ///
 /// The timer allows you to manage game events by duration, rather than
-/// on a frame-by-frame basis. This simple version of the timer is based on
-/// the Windows API function timeGetTime, which is notoriously inaccurate
-/// but perfectly adequate for a simple game demo.
+/// on a frame-by-frame basis. It keeps time in 64-bit microseconds from a
+/// steady clock, so that frame times and motion are accurate to well under
+/// a millisecond. The millisecond functions time and elapsed are rounded
+/// down from that. It can be switched to a virtual clock that only moves
+/// when advanced, for simulations that run faster than real time. Between
+/// beginframe and endframe the time is read once and cached, so that every
+/// object sees the same time during a frame. Restoring a snapshot sets
+/// the time back to when it was taken, so times remembered by the game
+/// stay in step with the clock.
 
 class CTimer{
   private:
-		int m_nStartTime; ///< Time that timer was started.
-		int m_nCurrentTime; ///< Current time.
+		long long m_nStartTime; ///< Time that timer was started.
+		long long m_nCurrentTime; ///< Time at the start of the current frame.
+		BOOL m_bInFrame; ///< TRUE between beginframe and endframe.
 
-		int m_nLastFrameStartTime; ///< Start time for previous frame.
-		int m_nFrameTime; ///< Elapsed time for previous frame.
+		TimeSourceType m_nTimeSource; ///< Where the time comes from.
+		long long m_nVirtualTime; ///< Time on the virtual clock.
 
-		int m_nLevelStartTime; ///< Time the current level started.
-		int m_nLevelFinishTime; ///< Time the current level finished.
+		long long m_nLastFrameStartTime; ///< Start time for previous frame, -1 if none.
+		long long m_nFrameTime; ///< Elapsed time for previous frame.
+		FRAMESTATS m_sFrameStats; ///< Frame time statistics.
+
+		long long m_nLevelStartTime; ///< Time the current level started.
+		long long m_nLevelFinishTime; ///< Time the current level finished.
 		BOOL m_bLevelTimerOn; ///< Whether the current level is being timed.
 
+		long long ReadClock(); ///< Read the time source in microseconds.
+
   public:
 		CTimer(); ///< Constructor.
 		void start(); ///< Start the timer.
 		int time(); ///< Return the time in ms.
+		long long microtime(); ///< Return the time in microseconds.
 		bool elapsed(int &start, int interval); ///< Has interval ms elapsed since start?
+		bool microelapsed(long long &start, long long interval); ///< Has interval microseconds elapsed since start?
+
+		void SetTimeSource(TimeSourceType source); ///< Choose real or virtual clock.
+		void advance(int delta); ///< Move the virtual clock forward in ms.
+		void microadvance(long long delta); ///< Move the virtual clock forward in microseconds.
 
 		int frametime(); ///< Return the time for last frame in ms.
+		long long microframetime(); ///< Return the time for last frame in microseconds.
+		const FRAMESTATS& GetFrameStats(); ///< Get frame time statistics.
+		void ResetFrameStats(); ///< Start frame time statistics over.
 
 										 //begin and end of frame functions
 		void beginframe(); ///< Beginning of animation frame.
@@ -41,5 +81,7 @@ class CTimer{
 		int GetLevelElapsedTime(); ///< Get elapsed time since the level started.
 		void StartLevelTimer(); ///< Start the level timer.
 		void StopLevelTimer(); ///< Stop the level timer.
-}; //CTimer
 
+		void save(CSnapshot& s); ///< Save the time to a snapshot.
+		void restore(CSnapshot& s); ///< Set the time back to a snapshot.
+}; //CTimer
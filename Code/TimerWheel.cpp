@@ -0,0 +1,140 @@
+/// \file TimerWheel.cpp
+/// \brief Code for the hashed timer wheel class CTimerWheel.
+
+#include "TimerWheel.h"
+#include "Snapshot.h"
+
+const int NUM_SLOTS = TIMER_WHEEL_SLOTS; ///< Number of slots.
+const int SLOT_MASK = NUM_SLOTS - 1; ///< Mask for slot numbers.
+const int TICK_TIME = 16; ///< Length of a tick in ms, about one frame.
+
+CTimerWheel::CTimerWheel(): m_nCurrentTick(0){
+  for(int i=0; i<NUM_SLOTS; i++)
+    m_sSlot[i].m_pPrev = m_sSlot[i].m_pNext = &m_sSlot[i];
+} //constructor
+
+/// Get the sentinel for the slot that a tick hashes to.
+/// \param tick Tick number.
+/// \return Pointer to the sentinel.
+
+TIMERNODE* CTimerWheel::GetSlot(int tick){
+  return &m_sSlot[tick & SLOT_MASK];
+} //GetSlot
+
+/// Set up a node that is not pending. Must be done once before the node
+/// is used.
+/// \param node The node.
+/// \param p Object that owns the node.
+/// \param e Event type.
+
+void CTimerWheel::init(TIMERNODE& node, CGameObject* p, TimerEventType e){
+  node.m_pPrev = node.m_pNext = nullptr;
+  node.m_pObject = p;
+  node.m_nDueTime = 0;
+  node.m_nEvent = e;
+} //init
+
+/// Take a node out of the wheel, if it is pending.
+/// \param node The node.
+
+void CTimerWheel::cancel(TIMERNODE& node){
+  if(!pending(node))return;
+  node.m_pPrev->m_pNext = node.m_pNext;
+  node.m_pNext->m_pPrev = node.m_pPrev;
+  node.m_pPrev = node.m_pNext = nullptr;
+} //cancel
+
+/// Find out whether a node is in the wheel.
+/// \param node The node.
+/// \return true if the node is pending.
+
+bool CTimerWheel::pending(const TIMERNODE& node){
+  return node.m_pNext != nullptr;
+} //pending
+
+/// Put a node into the wheel, taking it out of wherever it was first.
+/// Events that are already due go into the current slot so that they come
+/// out next time the wheel is advanced.
+/// \param node The node.
+/// \param due Time that the event is due, in ms.
+
+void CTimerWheel::schedule(TIMERNODE& node, int due){
+  cancel(node);
+  node.m_nDueTime = due;
+
+  int tick = due/TICK_TIME;
+  if(tick < m_nCurrentTick)tick = m_nCurrentTick;
+
+  TIMERNODE* slot = GetSlot(tick);
+  node.m_pPrev = slot->m_pPrev;
+  node.m_pNext = slot;
+  slot->m_pPrev->m_pNext = &node;
+  slot->m_pPrev = &node;
+} //schedule
+
+/// Advance the wheel to the current time and take out every event that is
+/// due. The slot of the current tick is looked at again next time, since
+/// it may still hold events due later in the tick. If more than a turn has
+/// gone by, every slot is looked at once.
+/// \param now Current time in ms.
+/// \param fired Events that are due are appended to this, in no set order.
+
+void CTimerWheel::advance(int now, vector<TIMERNODE*>& fired){
+  const int tick = now/TICK_TIME;
+  int first = m_nCurrentTick;
+  if(tick - first >= NUM_SLOTS)first = tick - SLOT_MASK;
+
+  for(int t=first; t<=tick; t++){
+    TIMERNODE* slot = GetSlot(t);
+    for(TIMERNODE* node = slot->m_pNext; node != slot;){
+      TIMERNODE* next = node->m_pNext;
+      if(node->m_nDueTime <= now){
+        cancel(*node);
+        fired.push_back(node);
+      } //if
+      node = next;
+    } //for
+  } //for
+
+  m_nCurrentTick = tick;
+} //advance
+
+/// Take every node out of the wheel.
+
+void CTimerWheel::clear(){
+  for(int i=0; i<NUM_SLOTS; i++){
+    TIMERNODE* slot = &m_sSlot[i];
+    while(slot->m_pNext != slot)
+      cancel(*slot->m_pNext);
+  } //for
+} //clear
+
+/// Get every pending event, slot by slot and in order within each slot.
+/// Scheduling them again in this order, at the same current tick, puts
+/// them back in the same order, so they fire in the same order too.
+/// \param pending Pending events are appended to this.
+
+void CTimerWheel::GetPending(vector<TIMERNODE*>& pending){
+  for(int i=0; i<NUM_SLOTS; i++){
+    TIMERNODE* slot = &m_sSlot[i];
+    for(TIMERNODE* node = slot->m_pNext; node != slot; node = node->m_pNext)
+      pending.push_back(node);
+  } //for
+} //GetPending
+
+/// Save the current tick to a snapshot. The pending events belong to the
+/// objects, so the object manager saves those.
+/// \param s Snapshot.
+
+void CTimerWheel::save(CSnapshot& s){
+  s.write(m_nCurrentTick);
+} //save
+
+/// Take every node out of the wheel and restore the current tick from a
+/// snapshot, ready for the pending events to be scheduled again.
+/// \param s Snapshot.
+
+void CTimerWheel::restore(CSnapshot& s){
+  clear();
+  s.read(m_nCurrentTick);
+} //restore
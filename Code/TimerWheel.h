@@ -0,0 +1,63 @@
+/// \file TimerWheel.h
+/// \brief Interface for the hashed timer wheel class CTimerWheel.
+
+#pragma once
+
+#include <vector>
+
+#include "Defines.h"
+
+using namespace std;
+
+class CGameObject;
+class CSnapshot;
+
+const int TIMER_WHEEL_SLOTS = 256; ///< Number of slots in the timer wheel, a power of 2.
+
+/// \brief A pending timer event.
+///
+/// Nodes live inside the objects that own them, one for each kind of event,
+/// and are linked into a slot of the timer wheel while they are pending. So
+/// scheduling and cancelling an event never allocates, and an object that is
+/// deleted takes its pending events with it.
+
+struct TIMERNODE{
+  TIMERNODE* m_pPrev; ///< Previous node in the slot, nullptr if not pending.
+  TIMERNODE* m_pNext; ///< Next node in the slot, nullptr if not pending.
+  CGameObject* m_pObject; ///< Object that the event happens to.
+  int m_nDueTime; ///< Time that the event is due, in ms.
+  TimerEventType m_nEvent; ///< What happens.
+}; //TIMERNODE
+
+/// \brief The timer wheel.
+///
+/// A hashed timer wheel. Time is cut into ticks of a fixed length and each
+/// pending event goes into the slot for the tick that it is due in, modulo
+/// the number of slots. Advancing the wheel looks only at the slots of the
+/// ticks that have gone by, and takes out the events in them that are due.
+/// Events more than one turn of the wheel away stay put until their turn
+/// comes around. The cost of a tick depends on how many events are near,
+/// not on how many objects there are.
+
+class CTimerWheel{
+  private:
+    TIMERNODE m_sSlot[TIMER_WHEEL_SLOTS]; ///< Sentinel of the circular list in each slot.
+    int m_nCurrentTick; ///< Tick that the wheel was last advanced to.
+
+    TIMERNODE* GetSlot(int tick); ///< Sentinel for a tick's slot.
+
+  public:
+    CTimerWheel(); ///< Constructor.
+
+    static void init(TIMERNODE& node, CGameObject* p, TimerEventType e); ///< Set up a node.
+    static void cancel(TIMERNODE& node); ///< Take a node out of the wheel.
+    static bool pending(const TIMERNODE& node); ///< Is a node in the wheel?
+
+    void schedule(TIMERNODE& node, int due); ///< Put a node into the wheel.
+    void advance(int now, vector<TIMERNODE*>& fired); ///< Take out events that are due.
+    void clear(); ///< Take out all events.
+
+    void GetPending(vector<TIMERNODE*>& pending); ///< Get all pending events in wheel order.
+    void save(CSnapshot& s); ///< Save the current tick to a snapshot.
+    void restore(CSnapshot& s); ///< Empty the wheel and restore the current tick.
+}; //CTimerWheel
@@ -0,0 +1,15 @@
+/// \file World.cpp
+/// \brief Code for the game world class CWorld.
+
+#include "World.h"
+
+/// Constructor. The world starts out empty, with no sound manager, on the
+/// title screen with no level chosen.
+
+CWorld::CWorld():
+  m_cObjectManager(this), m_pSoundManager(nullptr), m_pPlayer(nullptr),
+  m_nGameState(TITLE_GAMESTATE), m_nLevelState(NONE_STATE),
+  m_fScreenScroll(0.0f), m_nEnemyCount(0),
+  m_bShieldActive(FALSE), m_bAssistActive(FALSE),
+  m_bSpecialActivate(FALSE), m_bPlayerIsInvulnerable(FALSE){
+} //constructor
@@ -0,0 +1,44 @@
+/// \file World.h
+/// \brief Interface for the game world class CWorld.
+
+#pragma once
+
+#include "Defines.h"
+#include "Timer.h"
+#include "Random.h"
+#include "ObjMan.h"
+
+class CGameObject;
+class CSoundManager;
+
+/// \brief The game world.
+///
+/// Everything that changes during play: the objects, the clock, the random
+/// numbers, the player and the state of the level. The object manager, the
+/// game objects and the AI get at all of it through the world that they
+/// belong to instead of through globals, so a process can have any number
+/// of worlds and step each of them on a thread of its own. What is only
+/// read during play, such as the object settings, the animations, the
+/// sprites and the screen size, is shared by all worlds. So is the sound
+/// manager, so worlds stepped on other threads should be given one that
+/// plays nothing.
+
+class CWorld{
+  public:
+    CTimer m_cTimer; ///< Game clock.
+    CRandom m_cRandom; ///< Random number generator.
+    CObjectManager m_cObjectManager; ///< Objects in this world.
+    CSoundManager* m_pSoundManager; ///< Sound manager, not owned.
+    CGameObject* m_pPlayer; ///< Current player incarnation.
+
+    GameStateType m_nGameState; ///< Game state.
+    LevelStateType m_nLevelState; ///< Level being played.
+    float m_fScreenScroll; ///< Current screen scroll value.
+    int m_nEnemyCount; ///< Number of enemies spawned and not yet gone.
+    BOOL m_bShieldActive; ///< TRUE when the shield is activated.
+    BOOL m_bAssistActive; ///< TRUE when the assist is activated.
+    BOOL m_bSpecialActivate; ///< TRUE if the player is able to activate the special attack.
+    BOOL m_bPlayerIsInvulnerable; ///< TRUE if the player is invulnerable to collisions.
+
+    CWorld(); ///< Constructor.
+}; //CWorld